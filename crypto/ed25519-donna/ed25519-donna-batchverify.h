@@ -201,8 +201,18 @@ ge25519_is_neutral_vartime(const ge25519 *p) {
 	return (memcmp(point_buffer[0], zero, 32) == 0) && (memcmp(point_buffer[1], point_buffer[2], 32) == 0);
 }
 
+static int
+ed25519_sign_open_single(const unsigned char *m, size_t mlen, const unsigned char *pk, const ed25519_prepared_key *prepared, const unsigned char *RS) {
+	return prepared ? ED25519_FN(ed25519_sign_open_prepared) (m, mlen, prepared, RS) : ED25519_FN(ed25519_sign_open) (m, mlen, pk, RS);
+}
+
 int
 ED25519_FN(ed25519_sign_open_batch) (const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid) {
+	return ED25519_FN(ed25519_sign_open_batch_prepared) (m, mlen, pk, NULL, RS, num, valid);
+}
+
+int
+ED25519_FN(ed25519_sign_open_batch_prepared) (const unsigned char **m, size_t *mlen, const unsigned char **pk, const ed25519_prepared_key **prepared, const unsigned char **RS, size_t num, int *valid) {
 	batch_heap ALIGN(16) batch;
 	ge25519 ALIGN(16) p;
 	bignum256modm *r_scalars;
@@ -239,9 +249,12 @@ ED25519_FN(ed25519_sign_open_batch) (const unsigned char **m, size_t *mlen, cons
 
 		/* compute points */
 		batch.points[0] = ge25519_basepoint;
-		for (i = 0; i < batchsize; i++)
-			if (!ge25519_unpack_negative_vartime(&batch.points[i+1], pk[i]))
+		for (i = 0; i < batchsize; i++) {
+			if (prepared && prepared[i])
+				batch.points[i+1] = prepared[i]->A;
+			else if (!ge25519_unpack_negative_vartime(&batch.points[i+1], pk[i]))
 				goto fallback;
+		}
 		for (i = 0; i < batchsize; i++)
 			if (!ge25519_unpack_negative_vartime(&batch.points[batchsize+i+1], RS[i]))
 				goto fallback;
@@ -252,7 +265,7 @@ ED25519_FN(ed25519_sign_open_batch) (const unsigned char **m, size_t *mlen, cons
 
 			fallback:
 			for (i = 0; i < batchsize; i++) {
-				valid[i] = ED25519_FN(ed25519_sign_open) (m[i], mlen[i], pk[i], RS[i]) ? 0 : 1;
+				valid[i] = ed25519_sign_open_single(m[i], mlen[i], pk[i], prepared ? prepared[i] : NULL, RS[i]) ? 0 : 1;
 				ret |= (valid[i] ^ 1);
 			}
 		}
@@ -260,13 +273,15 @@ ED25519_FN(ed25519_sign_open_batch) (const unsigned char **m, size_t *mlen, cons
 		m += batchsize;
 		mlen += batchsize;
 		pk += batchsize;
+		if (prepared)
+			prepared += batchsize;
 		RS += batchsize;
 		num -= batchsize;
 		valid += batchsize;
 	}
 
 	for (i = 0; i < num; i++) {
-		valid[i] = ED25519_FN(ed25519_sign_open) (m[i], mlen[i], pk[i], RS[i]) ? 0 : 1;
+		valid[i] = ed25519_sign_open_single(m[i], mlen[i], pk[i], prepared ? prepared[i] : NULL, RS[i]) ? 0 : 1;
 		ret |= (valid[i] ^ 1);
 	}
 
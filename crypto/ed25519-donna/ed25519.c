@@ -126,6 +126,106 @@ ED25519_FN(ed25519_sign_open) (const unsigned char *m, size_t mlen, const ed2551
 	return ed25519_verify(RS, checkR, 32) ? 0 : -1;
 }
 
+/*
+	Prepared public keys: the point is decompressed once and the odd multiples
+	[1]A..[63]A are precomputed, allowing a wider sliding window than
+	ge25519_double_scalarmult_vartime builds per verification
+*/
+
+#define PREPARED_SWINDOWSIZE 7
+#define PREPARED_TABLE_SIZE (1<<(PREPARED_SWINDOWSIZE-2))
+
+struct ed25519_prepared_key_t {
+	ge25519 ALIGN(16) A;
+	ge25519_pniels ALIGN(16) pre[PREPARED_TABLE_SIZE];
+	ed25519_public_key pk;
+};
+
+/* fails to compile if the storage callers reserve is too small for this field implementation */
+typedef char ed25519_prepared_key_fits[(sizeof(ed25519_prepared_key) <= ED25519_PREPARED_KEY_MAX_SIZE) ? 1 : -1];
+
+size_t
+ED25519_FN(ed25519_prepared_key_size) (void) {
+	return sizeof(ed25519_prepared_key);
+}
+
+int
+ED25519_FN(ed25519_prepare_key) (const ed25519_public_key pk, ed25519_prepared_key *prepared) {
+	ge25519 ALIGN(16) d;
+	int32_t i;
+
+	if (!ge25519_unpack_negative_vartime(&prepared->A, pk))
+		return -1;
+
+	ge25519_double(&d, &prepared->A);
+	ge25519_full_to_pniels(prepared->pre, &prepared->A);
+	for (i = 0; i < PREPARED_TABLE_SIZE - 1; i++)
+		ge25519_pnielsadd(&prepared->pre[i+1], &d, &prepared->pre[i]);
+	memcpy(prepared->pk, pk, 32);
+	return 0;
+}
+
+/* computes [s1]A + [s2]basepoint using the precomputed multiples of A */
+static void
+ge25519_double_scalarmult_vartime_prepared(ge25519 *r, const ed25519_prepared_key *prepared, const bignum256modm s1, const bignum256modm s2) {
+	signed char slide1[256], slide2[256];
+	ge25519_p1p1 ALIGN(16) t;
+	int32_t i;
+
+	contract256_slidingwindow_modm(slide1, s1, PREPARED_SWINDOWSIZE);
+	contract256_slidingwindow_modm(slide2, s2, S2_SWINDOWSIZE);
+
+	/* set neutral */
+	memset(r, 0, sizeof(ge25519));
+	r->y[0] = 1;
+	r->z[0] = 1;
+
+	i = 255;
+	while ((i >= 0) && !(slide1[i] | slide2[i]))
+		i--;
+
+	for (; i >= 0; i--) {
+		ge25519_double_p1p1(&t, r);
+
+		if (slide1[i]) {
+			ge25519_p1p1_to_full(r, &t);
+			ge25519_pnielsadd_p1p1(&t, r, &prepared->pre[abs(slide1[i]) / 2], (unsigned char)slide1[i] >> 7);
+		}
+
+		if (slide2[i]) {
+			ge25519_p1p1_to_full(r, &t);
+			ge25519_nielsadd2_p1p1(&t, r, &ge25519_niels_sliding_multiples[abs(slide2[i]) / 2], (unsigned char)slide2[i] >> 7);
+		}
+
+		ge25519_p1p1_to_partial(r, &t);
+	}
+}
+
+int
+ED25519_FN(ed25519_sign_open_prepared) (const unsigned char *m, size_t mlen, const ed25519_prepared_key *prepared, const ed25519_signature RS) {
+	ge25519 ALIGN(16) R;
+	hash_512bits hash;
+	bignum256modm hram, S;
+	unsigned char checkR[32];
+
+	if (RS[63] & 224)
+		return -1;
+
+	/* hram = H(R,A,m) */
+	ed25519_hram(hash, RS, prepared->pk, m, mlen);
+	expand256_modm(hram, hash, 64);
+
+	/* S */
+	expand256_modm(S, RS + 32, 32);
+
+	/* SB - H(R,A,m)A */
+	ge25519_double_scalarmult_vartime_prepared(&R, prepared, hram, S);
+	ge25519_pack(checkR, &R);
+
+	/* check that R = SB - H(R,A,m)A */
+	return ed25519_verify(RS, checkR, 32) ? 0 : -1;
+}
+
 #include "ed25519-donna-batchverify.h"
 
 /*
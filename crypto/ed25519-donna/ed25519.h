@@ -19,6 +19,19 @@ void ed25519_sign(const unsigned char *m, size_t mlen, const ed25519_secret_key
 
 int ed25519_sign_open_batch(const unsigned char **m, size_t *mlen, const unsigned char **pk, const unsigned char **RS, size_t num, int *valid);
 
+/* public key decompressed once with precomputed multiples, for keys which are verified repeatedly */
+typedef struct ed25519_prepared_key_t ed25519_prepared_key;
+
+/* upper bound of ed25519_prepared_key_size() across the field implementations, for callers providing fixed 16 byte aligned storage */
+#define ED25519_PREPARED_KEY_MAX_SIZE 6368
+
+size_t ed25519_prepared_key_size(void);
+int ed25519_prepare_key(const ed25519_public_key pk, ed25519_prepared_key *prepared);
+int ed25519_sign_open_prepared(const unsigned char *m, size_t mlen, const ed25519_prepared_key *prepared, const ed25519_signature RS);
+
+/* prepared may be NULL, as may be any of its entries, to use pk[i] as is */
+int ed25519_sign_open_batch_prepared(const unsigned char **m, size_t *mlen, const unsigned char **pk, const ed25519_prepared_key **prepared, const unsigned char **RS, size_t num, int *valid);
+
 void ed25519_randombytes_unsafe(void *out, size_t count);
 
 void curved25519_scalarmult_basepoint(curved25519_key pk, const curved25519_key e);
@@ -683,3 +683,129 @@ TEST (active_transactions, vote_replays)
 	ASSERT_EQ (nano::vote_code::indeterminate, node.active.vote (vote1_send2));
 	ASSERT_EQ (nano::vote_code::indeterminate, node.active.vote (vote2_send2));
 }
+
+TEST (active_transactions, incremental_tally)
+{
+	nano::system system;
+	nano::node_config config (nano::get_available_port (), system.logging);
+	// Prevent confirmation so the tally keeps changing
+	config.online_weight_minimum = std::numeric_limits<nano::uint128_t>::max ();
+	auto & node (*system.add_node (config));
+	nano::genesis genesis;
+	nano::keypair key;
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 2, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto election (node.active.insert (send1).first);
+	ASSERT_NE (nullptr, election);
+	nano::lock_guard<std::mutex> guard (node.active.mutex);
+	ASSERT_FALSE (election->publish (send2));
+	auto weight (node.ledger.weight (nano::test_genesis_key.pub));
+	ASSERT_TRUE (election->vote (nano::test_genesis_key.pub, 1, send1->hash ()).processed);
+	ASSERT_EQ (weight, election->last_tally.find (send1->hash ())->second.weight);
+	// Only voted blocks are tallied
+	ASSERT_EQ (election->last_tally.end (), election->last_tally.find (send2->hash ()));
+	auto tally1 (election->tally ());
+	ASSERT_EQ (1, tally1.size ());
+	ASSERT_EQ (send1, tally1.begin ()->second);
+	ASSERT_EQ (weight, tally1.begin ()->first);
+	// Changing the vote moves the weight to the other block
+	election->last_votes[nano::test_genesis_key.pub].time = std::chrono::steady_clock::now () - std::chrono::seconds (20);
+	ASSERT_TRUE (election->vote (nano::test_genesis_key.pub, 2, send2->hash ()).processed);
+	// The placeholder vote from the election itself keeps send1 tallied at zero
+	ASSERT_EQ (0, election->last_tally.find (send1->hash ())->second.weight);
+	ASSERT_EQ (1, election->last_tally.find (send1->hash ())->second.voters);
+	ASSERT_EQ (weight, election->last_tally.find (send2->hash ())->second.weight);
+	ASSERT_EQ (1, election->last_tally.find (send2->hash ())->second.voters);
+	auto tally2 (election->tally ());
+	ASSERT_EQ (send2, tally2.begin ()->second);
+	ASSERT_EQ (weight, tally2.begin ()->first);
+	// A full recalculation gives the same result
+	election->refresh_tally ();
+	ASSERT_EQ (0, election->last_tally.find (send1->hash ())->second.weight);
+	ASSERT_EQ (weight, election->last_tally.find (send2->hash ())->second.weight);
+	ASSERT_EQ (2, election->last_tally.size ());
+	ASSERT_FALSE (election->confirmed ());
+}
+
+TEST (active_transactions, inactive_votes_cache_concurrent_insert)
+{
+	nano::system system;
+	nano::node_config config (nano::get_available_port (), system.logging);
+	// Prevent confirmation so every election keeps its votes
+	config.online_weight_minimum = std::numeric_limits<nano::uint128_t>::max ();
+	auto & node (*system.add_node (config));
+	nano::genesis genesis;
+	nano::keypair key;
+	std::vector<std::shared_ptr<nano::block>> blocks;
+	auto previous (genesis.hash ());
+	for (auto i (0); i < 100; ++i)
+	{
+		blocks.push_back (std::make_shared<nano::send_block> (previous, key.pub, nano::genesis_amount - 1 - i, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (previous)));
+		previous = blocks.back ()->hash ();
+	}
+	// Votes arriving while their elections start are either applied to the election or taken from the cache when it starts
+	std::thread voter ([&node, &blocks]() {
+		for (auto const & block : blocks)
+		{
+			node.active.vote (std::make_shared<nano::vote> (nano::test_genesis_key.pub, nano::test_genesis_key.prv, 0, std::vector<nano::block_hash> (1, block->hash ())));
+		}
+	});
+	for (auto const & block : blocks)
+	{
+		ASSERT_NE (nullptr, node.active.insert (block).first);
+	}
+	voter.join ();
+	nano::lock_guard<std::mutex> guard (node.active.mutex);
+	for (auto const & block : blocks)
+	{
+		auto election (node.active.blocks.find (block->hash ()));
+		ASSERT_NE (node.active.blocks.end (), election);
+		ASSERT_EQ (1, election->second->last_votes.count (nano::test_genesis_key.pub));
+	}
+}
+
+TEST (active_transactions, scheduled_requests)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto send (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto election (node.active.insert (send).first);
+	ASSERT_NE (nullptr, election);
+	// The request loop only visits the election when it is due, which is immediately on the test network
+	system.deadline_set (5s);
+	while (node.stats.count (nano::stat::type::election, nano::stat::detail::election_due) == 0)
+	{
+		ASSERT_NO_ERROR (system.poll ());
+	}
+	ASSERT_GT (node.stats.count (nano::stat::type::election, nano::stat::detail::election_tick), 0);
+	nano::lock_guard<std::mutex> guard (node.active.mutex);
+	ASSERT_GT (election->next_action, election->election_start);
+}
+
+TEST (active_transactions, election_allocations)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto send1 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 1, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto send2 (std::make_shared<nano::send_block> (genesis.hash (), key.pub, nano::genesis_amount - 2, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *system.work.generate (genesis.hash ())));
+	auto constructed (nano::election::constructed.load ());
+	auto destroyed (nano::election::destroyed.load ());
+	{
+		nano::lock_guard<std::mutex> guard (node.active.mutex);
+		auto election (std::make_shared<nano::election> (node, send1, false, nullptr));
+		ASSERT_EQ (constructed + 1, nano::election::constructed);
+		ASSERT_FALSE (election->publish (send2));
+		// Both blocks of a fork fit in the inline storage
+		ASSERT_EQ (2, election->blocks.size ());
+		ASSERT_EQ (2, election->blocks.capacity ());
+		ASSERT_EQ (send1, election->blocks[send1->hash ()]);
+		ASSERT_EQ (send2, election->blocks[send2->hash ()]);
+	}
+	ASSERT_EQ (destroyed + 1, nano::election::destroyed);
+	auto info (nano::collect_container_info (node.active, "active"));
+	ASSERT_TRUE (info->is_composite ());
+}
@@ -32,7 +32,8 @@ void modify_genesis_account_info_to_v5 (nano::mdb_store & store, nano::transacti
 void modify_confirmation_height_to_v15 (nano::mdb_store & store, nano::transaction const & transaction, nano::account const & account, uint64_t confirmation_height);
 void write_sideband_v12 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block & block_a, nano::block_hash const & successor_a, MDB_dbi db_a);
 void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a, MDB_dbi db_a);
-void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a);
+void write_sideband_v15 (nano::mdb_store & store_a, nano::write_transaction const & transaction_a, nano::block const & block_a);
+void write_block_v18 (nano::mdb_store & store_a, nano::write_transaction const & transaction_a, nano::block const & block_a);
 }
 
 TEST (block_store, construction)
@@ -135,6 +136,44 @@ TEST (block_store, add_item)
 	ASSERT_EQ (nullptr, latest3);
 }
 
+TEST (block_store, get_many)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::keypair key1;
+	nano::keypair key2;
+	nano::open_block block1 (0, 1, key1.pub, key1.prv, key1.pub, 0);
+	nano::open_block block2 (0, 1, key2.pub, key2.prv, key2.pub, 0);
+	nano::account_info info1 (block1.hash (), key1.pub, block1.hash (), 100, 0, 1, nano::epoch::epoch_0);
+	auto transaction (store->tx_begin_write ());
+	nano::block_sideband sideband1 (nano::block_type::open, key1.pub, 0, 100, 1, 0, nano::epoch::epoch_0, false, false, false);
+	store->block_put (transaction, block1.hash (), block1, sideband1);
+	nano::block_sideband sideband2 (nano::block_type::open, key2.pub, 0, 200, 1, 0, nano::epoch::epoch_0, false, false, false);
+	store->block_put (transaction, block2.hash (), block2, sideband2);
+	store->account_put (transaction, key1.pub, info1);
+
+	// Results follow the order of the request, including missing and repeated keys
+	std::vector<nano::block_sideband> sidebands;
+	auto blocks (store->block_get_many (transaction, { block2.hash (), 0, block1.hash (), block2.hash () }, &sidebands));
+	ASSERT_EQ (4, blocks.size ());
+	ASSERT_EQ (4, sidebands.size ());
+	ASSERT_EQ (block2, *blocks[0]);
+	ASSERT_EQ (nullptr, blocks[1]);
+	ASSERT_EQ (block1, *blocks[2]);
+	ASSERT_EQ (block2, *blocks[3]);
+	ASSERT_EQ (200, sidebands[0].balance.number ());
+	ASSERT_EQ (100, sidebands[2].balance.number ());
+	ASSERT_EQ (key2.pub, sidebands[3].account);
+
+	auto infos (store->account_get_many (transaction, { key2.pub, key1.pub }));
+	ASSERT_EQ (2, infos.size ());
+	ASSERT_FALSE (infos[0]);
+	ASSERT_TRUE (infos[1]);
+	ASSERT_EQ (info1, *infos[1]);
+	ASSERT_TRUE (store->account_get_many (transaction, {}).empty ());
+}
+
 TEST (block_store, clear_successor)
 {
 	nano::logger_mt logger;
@@ -266,6 +305,33 @@ TEST (block_store, pending_iterator)
 	ASSERT_EQ (nano::epoch::epoch_1, pending.epoch);
 }
 
+TEST (block_store, pending_account_iterator)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::account last (std::numeric_limits<nano::uint256_t>::max ());
+	auto transaction (store->tx_begin_write ());
+	store->pending_put (transaction, nano::pending_key (1, 2), { 2, 3, nano::epoch::epoch_0 });
+	store->pending_put (transaction, nano::pending_key (2, 4), { 2, 5, nano::epoch::epoch_0 });
+	store->pending_put (transaction, nano::pending_key (2, 6), { 2, 7, nano::epoch::epoch_0 });
+	store->pending_put (transaction, nano::pending_key (3, 8), { 2, 9, nano::epoch::epoch_0 });
+	store->pending_put (transaction, nano::pending_key (last, 10), { 2, 11, nano::epoch::epoch_0 });
+	auto entries = [&store, &transaction](nano::account const & account_a) {
+		std::vector<nano::block_hash> result;
+		for (auto i (store->pending_account_begin (transaction, account_a)), n (store->pending_end ()); i != n && nano::pending_key (i->first).account == account_a; ++i)
+		{
+			result.push_back (nano::pending_key (i->first).hash);
+		}
+		return result;
+	};
+	ASSERT_EQ ((std::vector<nano::block_hash>{ 4, 6 }), entries (2));
+	ASSERT_EQ ((std::vector<nano::block_hash>{ 10 }), entries (last));
+	ASSERT_TRUE (entries (4).empty ());
+	ASSERT_TRUE (store->pending_exists (transaction, nano::pending_key (2, 6)));
+	ASSERT_FALSE (store->pending_exists (transaction, nano::pending_key (2, 5)));
+}
+
 /**
  * Regression test for Issue 1164
  * This reconstructs the situation where a key is larger in pending than the account being iterated in pending_v1, leaving
@@ -380,6 +446,28 @@ TEST (unchecked, multiple)
 	ASSERT_FALSE (block4.empty ());
 }
 
+TEST (unchecked, shared_body)
+{
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store.init_error ());
+	auto block1 (std::make_shared<nano::send_block> (4, 1, 2, nano::keypair ().prv, 4, 5));
+	auto transaction (store.tx_begin_write ());
+	store.unchecked_put (transaction, block1->previous (), block1);
+	store.unchecked_put (transaction, block1->source (), block1);
+	ASSERT_EQ (2, store.unchecked_count (transaction));
+	ASSERT_EQ (1, store.count (transaction, store.unchecked_bodies));
+	ASSERT_FALSE (store.unchecked_del (transaction, nano::unchecked_key (block1->previous (), block1->hash ())));
+	// The body is still referenced by the remaining entry
+	ASSERT_EQ (1, store.count (transaction, store.unchecked_bodies));
+	auto blocks (store.unchecked_get (transaction, block1->source ()));
+	ASSERT_EQ (1, blocks.size ());
+	ASSERT_EQ (*block1, *blocks[0].block);
+	ASSERT_FALSE (store.unchecked_del (transaction, nano::unchecked_key (block1->source (), block1->hash ())));
+	ASSERT_EQ (0, store.unchecked_count (transaction));
+	ASSERT_EQ (0, store.count (transaction, store.unchecked_bodies));
+}
+
 TEST (unchecked, double_put)
 {
 	nano::logger_mt logger;
@@ -651,6 +739,30 @@ TEST (mdb_block_store, bad_path)
 	ASSERT_TRUE (store.init_error ());
 }
 
+TEST (mdb_block_store, read_txn_pool)
+{
+	nano::logger_mt logger;
+	nano::stat stats;
+	nano::mdb_store store (logger, nano::unique_path (), nano::txn_tracking_config{}, std::chrono::milliseconds (5000), 128, 512, false, &stats);
+	ASSERT_FALSE (store.init_error ());
+	nano::keypair key1;
+	{
+		auto transaction (store.tx_begin_read ());
+		ASSERT_FALSE (store.account_exists (transaction, key1.pub));
+	}
+	ASSERT_EQ (1, stats.count (nano::stat::type::read_txn_pool, nano::stat::detail::cache_miss));
+	ASSERT_EQ (1, store.read_txn_pool.size ());
+	store.account_put (store.tx_begin_write (), key1.pub, nano::account_info{});
+	{
+		// A reused transaction sees the latest snapshot
+		auto transaction (store.tx_begin_read ());
+		ASSERT_EQ (0, store.read_txn_pool.size ());
+		ASSERT_TRUE (store.account_exists (transaction, key1.pub));
+	}
+	ASSERT_EQ (1, stats.count (nano::stat::type::read_txn_pool, nano::stat::detail::cache_hit));
+	ASSERT_EQ (1, store.read_txn_pool.size ());
+}
+
 TEST (block_store, DISABLED_already_open) // File can be shared
 {
 	auto path (nano::unique_path ());
@@ -1225,7 +1337,7 @@ TEST (mdb_block_store, upgrade_sideband_genesis)
 	nano::mdb_store store (logger, path);
 	ASSERT_FALSE (store.init_error ());
 	auto transaction (store.tx_begin_read ());
-	ASSERT_TRUE (store.full_sideband (transaction));
+	ASSERT_TRUE (store.full_sideband ());
 	nano::block_sideband sideband;
 	auto genesis_block (store.block_get (transaction, genesis.hash (), &sideband));
 	ASSERT_NE (nullptr, genesis_block);
@@ -1264,7 +1376,7 @@ TEST (mdb_block_store, upgrade_sideband_two_blocks)
 	nano::mdb_store store (logger, path);
 	ASSERT_FALSE (store.init_error ());
 	auto transaction (store.tx_begin_read ());
-	ASSERT_TRUE (store.full_sideband (transaction));
+	ASSERT_TRUE (store.full_sideband ());
 	nano::block_sideband sideband;
 	auto genesis_block (store.block_get (transaction, genesis.hash (), &sideband));
 	ASSERT_NE (nullptr, genesis_block);
@@ -1313,7 +1425,7 @@ TEST (mdb_block_store, upgrade_sideband_two_accounts)
 	nano::mdb_store store (logger, path);
 	ASSERT_FALSE (store.init_error ());
 	auto transaction (store.tx_begin_read ());
-	ASSERT_TRUE (store.full_sideband (transaction));
+	ASSERT_TRUE (store.full_sideband ());
 	nano::block_sideband sideband;
 	auto genesis_block (store.block_get (transaction, genesis.hash (), &sideband));
 	ASSERT_NE (nullptr, genesis_block);
@@ -1404,7 +1516,7 @@ TEST (mdb_block_store, upgrade_sideband_epoch)
 	nano::ledger ledger (store, stat);
 	ASSERT_FALSE (error);
 	auto transaction (store.tx_begin_write ());
-	ASSERT_TRUE (store.full_sideband (transaction));
+	ASSERT_TRUE (store.full_sideband ());
 	ASSERT_EQ (nano::epoch::epoch_1, store.block_version (transaction, hash2));
 	nano::block_sideband sideband;
 	auto block1 (store.block_get (transaction, hash2, &sideband));
@@ -1929,10 +2041,10 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_FALSE (error);
 	auto transaction (store.tx_begin_read ());
 
-	// Size of state block should equal that set in db (no change)
+	// Size of state block should equal that set in db, behind the block type
 	nano::mdb_val value;
-	ASSERT_FALSE (mdb_get (store.env.tx (transaction), store.state_blocks, nano::mdb_val (state_send.hash ()), value));
-	ASSERT_EQ (value.size (), nano::state_block::size + nano::block_sideband::size (nano::block_type::state));
+	ASSERT_FALSE (mdb_get (store.env.tx (transaction), store.blocks, nano::mdb_val (state_send.hash ()), value));
+	ASSERT_EQ (value.size (), 1 + nano::state_block::size + nano::block_sideband::size (nano::block_type::state));
 
 	// Check that sidebands are correctly populated
 	{
@@ -2060,6 +2172,161 @@ TEST (mdb_block_store, upgrade_v17_v18)
 	ASSERT_LT (17, store.version_get (transaction));
 }
 
+TEST (mdb_block_store, upgrade_v18_v19)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::send_block send (genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::receive_block receive (send.hash (), send.hash (), nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send.hash ()));
+	nano::change_block change (receive.hash (), key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (receive.hash ()));
+	nano::state_block state_send (nano::test_genesis_key.pub, change.hash (), key1.pub, nano::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (change.hash ()));
+	nano::open_block open (state_send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	{
+		nano::logger_mt logger;
+		nano::mdb_store store (logger, path);
+		nano::stat stats;
+		nano::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, receive).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, change).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state_send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+
+		// Downgrade the store, the upgrade can resume after merging some blocks so leave the state block in the merged table
+		store.version_put (transaction, 18);
+		write_block_v18 (store, transaction, *genesis.open);
+		write_block_v18 (store, transaction, send);
+		write_block_v18 (store, transaction, receive);
+		write_block_v18 (store, transaction, change);
+		write_block_v18 (store, transaction, open);
+		ASSERT_EQ (1, store.count (transaction, store.blocks));
+
+		// Blocks in the per type tables are still found before the upgrade
+		ASSERT_TRUE (store.block_exists (transaction, nano::block_type::send, send.hash ()));
+		ASSERT_FALSE (store.block_exists (transaction, nano::block_type::receive, send.hash ()));
+		auto counts (store.block_count (transaction));
+		ASSERT_EQ (6, counts.sum ());
+	}
+
+	// Now do the upgrade
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (18, store.version_get (transaction));
+
+	// The per type tables have been emptied into the blocks table
+	ASSERT_EQ (0, store.count (transaction, store.send_blocks));
+	ASSERT_EQ (0, store.count (transaction, store.receive_blocks));
+	ASSERT_EQ (0, store.count (transaction, store.open_blocks));
+	ASSERT_EQ (0, store.count (transaction, store.change_blocks));
+	ASSERT_EQ (0, store.count (transaction, store.state_blocks));
+	ASSERT_EQ (6, store.count (transaction, store.blocks));
+
+	// Every block is found with its type and sideband
+	for (auto const & block : std::vector<std::reference_wrapper<nano::block const>>{ *genesis.open, send, receive, change, state_send, open })
+	{
+		nano::block_sideband sideband;
+		auto block_l (store.block_get (transaction, block.get ().hash (), &sideband));
+		ASSERT_NE (nullptr, block_l);
+		ASSERT_EQ (block.get (), *block_l);
+		ASSERT_EQ (block.get ().type (), sideband.type);
+		ASSERT_TRUE (store.block_exists (transaction, block.get ().type (), block.get ().hash ()));
+	}
+	ASSERT_EQ (send.hash (), store.block_successor (transaction, genesis.hash ()));
+	ASSERT_TRUE (store.source_exists (transaction, send.hash ()));
+	ASSERT_FALSE (store.source_exists (transaction, receive.hash ()));
+
+	auto counts (store.block_count (transaction));
+	ASSERT_EQ (1, counts.send);
+	ASSERT_EQ (1, counts.receive);
+	ASSERT_EQ (2, counts.open);
+	ASSERT_EQ (1, counts.change);
+	ASSERT_EQ (1, counts.state);
+}
+
+TEST (mdb_block_store, upgrade_v18_v19_resume)
+{
+	auto path (nano::unique_path ());
+	nano::genesis genesis;
+	nano::keypair key1;
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::state_block state_send (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, key1.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	nano::open_block open (state_send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	// Key of the progress entry in the meta table
+	nano::uint256_union progress_key (0x300);
+	auto merged (std::min (genesis.hash (), open.hash ()));
+	auto pending (std::max (genesis.hash (), open.hash ()));
+	uint64_t merged_timestamp (0);
+	{
+		nano::logger_mt logger;
+		nano::mdb_store store (logger, path);
+		nano::stat stats;
+		nano::ledger ledger (store, stats);
+		auto transaction (store.tx_begin_write ());
+		store.initialize (transaction, genesis, ledger.cache);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state_send).code);
+		ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+
+		// Downgrade the store as if an upgrade was interrupted after merging the first of the open blocks
+		store.version_put (transaction, 18);
+		write_block_v18 (store, transaction, merged == open.hash () ? static_cast<nano::block const &> (*genesis.open) : open);
+		write_block_v18 (store, transaction, state_send);
+		// The merged block is still in open_blocks too, as the interrupted pass only drops the legacy table once it completes.
+		// Its legacy copy has a different timestamp, so rewriting it from there would show in the merged table
+		{
+			nano::block_sideband sideband;
+			auto block (store.block_get (transaction, merged, &sideband));
+			ASSERT_NE (nullptr, block);
+			merged_timestamp = sideband.timestamp;
+			sideband.timestamp = merged_timestamp + 1;
+			std::vector<uint8_t> data;
+			{
+				nano::vectorstream stream (data);
+				block->serialize (stream);
+				sideband.serialize (stream);
+			}
+			ASSERT_FALSE (mdb_put (store.env.tx (transaction), store.open_blocks, nano::mdb_val (merged), nano::mdb_val (data.size (), data.data ()), 0));
+		}
+		std::vector<uint8_t> progress;
+		{
+			nano::vectorstream stream (progress);
+			nano::write (stream, static_cast<uint64_t> ((19 << 8) | static_cast<uint8_t> (nano::block_type::open)));
+			nano::write (stream, merged);
+		}
+		ASSERT_FALSE (mdb_put (store.env.tx (transaction), store.meta, nano::mdb_val (progress_key), nano::mdb_val (progress.size (), progress.data ()), 0));
+		ASSERT_EQ (2, store.count (transaction, store.open_blocks));
+		ASSERT_EQ (1, store.count (transaction, store.blocks));
+	}
+
+	nano::logger_mt logger;
+	nano::mdb_store store (logger, path);
+	ASSERT_FALSE (store.init_error ());
+	auto transaction (store.tx_begin_read ());
+	ASSERT_LT (18, store.version_get (transaction));
+	ASSERT_EQ (0, store.count (transaction, store.open_blocks));
+	ASSERT_EQ (0, store.count (transaction, store.state_blocks));
+	ASSERT_EQ (3, store.count (transaction, store.blocks));
+	ASSERT_TRUE (store.block_exists (transaction, nano::block_type::open, merged));
+	ASSERT_TRUE (store.block_exists (transaction, nano::block_type::open, pending));
+	ASSERT_TRUE (store.block_exists (transaction, nano::block_type::state, state_send.hash ()));
+	// The merged block is skipped when resuming rather than rewritten, and only counted once
+	nano::block_sideband sideband;
+	ASSERT_NE (nullptr, store.block_get (transaction, merged, &sideband));
+	ASSERT_EQ (merged_timestamp, sideband.timestamp);
+	auto counts (store.block_count (transaction));
+	ASSERT_EQ (2, counts.open);
+	ASSERT_EQ (1, counts.state);
+
+	// The progress entry is removed once the upgrade finishes
+	nano::mdb_val value;
+	ASSERT_EQ (MDB_NOTFOUND, mdb_get (store.env.tx (transaction), store.meta, nano::mdb_val (progress_key), value));
+}
+
 TEST (mdb_block_store, upgrade_backup)
 {
 	auto dir (nano::unique_path ());
@@ -2313,11 +2580,13 @@ void write_sideband_v14 (nano::mdb_store & store_a, nano::transaction & transact
 	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), sideband.details.epoch == nano::epoch::epoch_0 ? store_a.state_blocks_v0 : store_a.state_blocks_v1, nano::mdb_val (block_a.hash ()), &val, 0));
 }
 
-void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transaction_a, nano::block const & block_a)
+void write_sideband_v15 (nano::mdb_store & store_a, nano::write_transaction const & transaction_a, nano::block const & block_a)
 {
 	nano::block_sideband sideband;
 	auto block = store_a.block_get (transaction_a, block_a.hash (), &sideband);
 	ASSERT_NE (block, nullptr);
+	// Move the block back to the table it was stored in before version 19
+	store_a.block_del (transaction_a, block_a.hash (), block_a.type ());
 
 	ASSERT_LE (sideband.details.epoch, nano::epoch::max);
 	// Simulated by writing 0 on every of the most significant bits, leaving out epoch only, as if pre-upgrade
@@ -2333,6 +2602,43 @@ void write_sideband_v15 (nano::mdb_store & store_a, nano::transaction & transact
 	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), store_a.state_blocks, nano::mdb_val (block_a.hash ()), &val, 0));
 }
 
+void write_block_v18 (nano::mdb_store & store_a, nano::write_transaction const & transaction_a, nano::block const & block_a)
+{
+	nano::block_sideband sideband;
+	auto block = store_a.block_get (transaction_a, block_a.hash (), &sideband);
+	ASSERT_NE (block, nullptr);
+	store_a.block_del (transaction_a, block_a.hash (), block_a.type ());
+
+	std::vector<uint8_t> data;
+	{
+		nano::vectorstream stream (data);
+		block_a.serialize (stream);
+		sideband.serialize (stream);
+	}
+
+	MDB_dbi database{ 0 };
+	switch (block_a.type ())
+	{
+		case nano::block_type::send:
+			database = store_a.send_blocks;
+			break;
+		case nano::block_type::receive:
+			database = store_a.receive_blocks;
+			break;
+		case nano::block_type::open:
+			database = store_a.open_blocks;
+			break;
+		case nano::block_type::change:
+			database = store_a.change_blocks;
+			break;
+		default:
+			database = store_a.state_blocks;
+			break;
+	}
+	MDB_val val{ data.size (), data.data () };
+	ASSERT_FALSE (mdb_put (store_a.env.tx (transaction_a), database, nano::mdb_val (block_a.hash ()), &val, 0));
+}
+
 // These functions take the latest account_info and create a legacy one so that upgrade tests can be emulated more easily.
 void modify_account_info_to_v13 (nano::mdb_store & store, nano::transaction const & transaction, nano::account const & account, nano::block_hash const & rep_block)
 {
@@ -320,6 +320,116 @@ TEST (ledger, rollback_representation)
 	ASSERT_EQ (0, ledger.weight (key3.pub));
 }
 
+TEST (ledger, delegators_index)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	auto delegators = [&store, &transaction](nano::account const & representative_a) {
+		std::vector<nano::account> result;
+		for (auto i (store->delegators_begin (transaction, representative_a)), n (store->delegators_end ()); i != n && i->first.representative == representative_a; ++i)
+		{
+			result.push_back (i->first.account);
+		}
+		return result;
+	};
+	// Genesis is written directly by initialize, building the index picks it up
+	ASSERT_TRUE (delegators (nano::test_genesis_key.pub).empty ());
+	ledger.delegators_index_build (transaction);
+	ledger.delegators_index = true;
+	ASSERT_EQ (std::vector<nano::account>{ nano::test_genesis_key.pub }, delegators (nano::test_genesis_key.pub));
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair rep;
+	nano::change_block change (genesis.hash (), rep.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, change).code);
+	ASSERT_TRUE (delegators (nano::test_genesis_key.pub).empty ());
+	ASSERT_EQ (std::vector<nano::account>{ nano::test_genesis_key.pub }, delegators (rep.pub));
+	nano::keypair key1;
+	nano::send_block send (change.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (change.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+	nano::open_block open (send.hash (), rep.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+	ASSERT_EQ (2, delegators (rep.pub).size ());
+	ASSERT_TRUE (store->delegator_exists (transaction, rep.pub, key1.pub));
+	nano::state_block state_change (key1.pub, open.hash (), nano::test_genesis_key.pub, 100, 0, key1.prv, key1.pub, *pool.generate (open.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, state_change).code);
+	ASSERT_EQ (std::vector<nano::account>{ key1.pub }, delegators (nano::test_genesis_key.pub));
+	ASSERT_FALSE (ledger.rollback (transaction, state_change.hash ()));
+	ASSERT_TRUE (delegators (nano::test_genesis_key.pub).empty ());
+	ASSERT_TRUE (store->delegator_exists (transaction, rep.pub, key1.pub));
+	// Rolling back the open block removes the account from the index
+	ASSERT_FALSE (ledger.rollback (transaction, open.hash ()));
+	ASSERT_FALSE (store->delegator_exists (transaction, rep.pub, key1.pub));
+	ASSERT_FALSE (ledger.rollback (transaction, change.hash ()));
+	ASSERT_EQ (std::vector<nano::account>{ nano::test_genesis_key.pub }, delegators (nano::test_genesis_key.pub));
+	ASSERT_TRUE (delegators (rep.pub).empty ());
+	// Rebuilding gives the same index
+	ledger.delegators_index_build (transaction);
+	ASSERT_EQ (std::vector<nano::account>{ nano::test_genesis_key.pub }, delegators (nano::test_genesis_key.pub));
+	store->delegators_clear (transaction);
+	ASSERT_TRUE (store->delegators_begin (transaction) == store->delegators_end ());
+}
+
+TEST (ledger, account_heights_index)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	nano::genesis genesis;
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	ASSERT_TRUE (store->account_heights_begin (transaction) == store->account_heights_end ());
+	ledger.account_heights_index_build (transaction);
+	ledger.account_heights_index = true;
+	ASSERT_EQ (genesis.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 1));
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send1).code);
+	nano::send_block send2 (send1.hash (), key1.pub, nano::genesis_amount - 200, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send1.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send2).code);
+	nano::open_block open (send1.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+	nano::state_block receive (key1.pub, open.hash (), key1.pub, 200, send2.hash (), key1.prv, key1.pub, *pool.generate (open.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, receive).code);
+	ASSERT_EQ (send1.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 2));
+	ASSERT_EQ (send2.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 3));
+	ASSERT_EQ (open.hash (), store->account_height_get (transaction, key1.pub, 1));
+	ASSERT_EQ (receive.hash (), store->account_height_get (transaction, key1.pub, 2));
+	ASSERT_TRUE (store->account_height_get (transaction, key1.pub, 3).is_zero ());
+	// Entries are ordered by account then height
+	std::vector<nano::account_height_key> keys;
+	for (auto i (store->account_heights_begin (transaction)), n (store->account_heights_end ()); i != n; ++i)
+	{
+		keys.push_back (i->first);
+	}
+	ASSERT_EQ (5, keys.size ());
+	auto sorted (std::is_sorted (keys.begin (), keys.end (), [](nano::account_height_key const & a, nano::account_height_key const & b) {
+		return a.account < b.account || (a.account == b.account && a.height < b.height);
+	}));
+	ASSERT_TRUE (sorted);
+	// Rolling back send2 rolls back the receive of key1 first
+	ASSERT_FALSE (ledger.rollback (transaction, send2.hash ()));
+	ASSERT_TRUE (store->account_height_get (transaction, nano::test_genesis_key.pub, 3).is_zero ());
+	ASSERT_TRUE (store->account_height_get (transaction, key1.pub, 2).is_zero ());
+	ASSERT_EQ (open.hash (), store->account_height_get (transaction, key1.pub, 1));
+	ASSERT_FALSE (ledger.rollback (transaction, open.hash ()));
+	ASSERT_TRUE (store->account_height_get (transaction, key1.pub, 1).is_zero ());
+	ASSERT_EQ (send1.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 2));
+	// Rebuilding gives the same index
+	ledger.account_heights_index_build (transaction);
+	ASSERT_EQ (genesis.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 1));
+	ASSERT_EQ (send1.hash (), store->account_height_get (transaction, nano::test_genesis_key.pub, 2));
+	ASSERT_TRUE (store->account_height_get (transaction, nano::test_genesis_key.pub, 3).is_zero ());
+}
+
 TEST (ledger, receive_rollback)
 {
 	nano::logger_mt logger;
@@ -609,6 +719,27 @@ TEST (ledger, representation_changes)
 	ASSERT_EQ (2, rep_weights.representation_get (key1.pub));
 }
 
+TEST (ledger, representation_many)
+{
+	nano::rep_weights rep_weights;
+	std::vector<nano::keypair> keys (5000);
+	for (auto i (0); i < keys.size (); ++i)
+	{
+		rep_weights.representation_add (keys[i].pub, i);
+	}
+	// Lookups still find every representative after the table grew
+	for (auto i (0); i < keys.size (); ++i)
+	{
+		rep_weights.representation_add (keys[i].pub, i);
+		ASSERT_EQ (2 * i, rep_weights.representation_get (keys[i].pub));
+	}
+	ASSERT_EQ (keys.size (), rep_weights.size ());
+	ASSERT_EQ (keys.size (), rep_weights.get_rep_amounts ().size ());
+	rep_weights.representation_put (keys[0].pub, std::numeric_limits<nano::uint128_t>::max ());
+	ASSERT_EQ (std::numeric_limits<nano::uint128_t>::max (), rep_weights.representation_get (keys[0].pub));
+	ASSERT_EQ (0, rep_weights.representation_get (nano::keypair ().pub));
+}
+
 TEST (ledger, representation)
 {
 	nano::logger_mt logger;
@@ -2737,10 +2868,10 @@ TEST (ledger, unchecked_epoch)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid_epoch);
 	}
@@ -2750,7 +2881,7 @@ TEST (ledger, unchecked_epoch)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		nano::account_info info;
@@ -2782,10 +2913,10 @@ TEST (ledger, unchecked_epoch_invalid)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 2);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, epoch1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, epoch1->previous ()));
 		ASSERT_EQ (blocks.size (), 2);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 		ASSERT_EQ (blocks[1].verified, nano::signature_verification::valid);
@@ -2798,7 +2929,7 @@ TEST (ledger, unchecked_epoch_invalid)
 		ASSERT_FALSE (node1.store.block_exists (transaction, epoch1->hash ()));
 		ASSERT_TRUE (node1.store.block_exists (transaction, epoch2->hash ()));
 		ASSERT_TRUE (node1.active.empty ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 		nano::account_info info;
@@ -2832,10 +2963,10 @@ TEST (ledger, unchecked_open)
 	node1.block_processor.flush ();
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, open1->source ()));
+		auto blocks (node1.unchecked.get (transaction, open1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2844,7 +2975,7 @@ TEST (ledger, unchecked_open)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, open1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -2870,10 +3001,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is unknown, signature cannot be validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->previous ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->previous ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::unknown);
 	}
@@ -2882,10 +3013,10 @@ TEST (ledger, unchecked_receive)
 	// Previous block for receive1 is known, signature was validated
 	{
 		auto transaction (node1.store.tx_begin_read ());
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
-		auto blocks (node1.store.unchecked_get (transaction, receive1->source ()));
+		auto blocks (node1.unchecked.get (transaction, receive1->source ()));
 		ASSERT_EQ (blocks.size (), 1);
 		ASSERT_EQ (blocks[0].verified, nano::signature_verification::valid);
 	}
@@ -2894,7 +3025,7 @@ TEST (ledger, unchecked_receive)
 	{
 		auto transaction (node1.store.tx_begin_read ());
 		ASSERT_TRUE (node1.store.block_exists (transaction, receive1->hash ()));
-		auto unchecked_count (node1.store.unchecked_count (transaction));
+		auto unchecked_count (node1.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node1.ledger.cache.unchecked_count);
 	}
@@ -2930,6 +3061,124 @@ TEST (ledger, confirmation_height_not_updated)
 	ASSERT_EQ (nano::block_hash (0), confirmation_height_info.frontier);
 }
 
+TEST (ledger, pruning_action)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::ledger ledger (*store, stats);
+	ledger.pruning = true;
+	nano::genesis genesis;
+	auto transaction (store->tx_begin_write ());
+	store->initialize (transaction, genesis, ledger.cache);
+	nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+	nano::keypair key1;
+	nano::send_block send1 (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send1).code);
+	nano::send_block send2 (send1.hash (), key1.pub, nano::genesis_amount - 300, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (send1.hash ()));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send2).code);
+	store->confirmation_height_put (transaction, nano::genesis_account, { 3, send2.hash () });
+	ASSERT_EQ (3, ledger.cache.block_count);
+	// Genesis is never pruned
+	ASSERT_EQ (1, ledger.pruning_action (transaction, send1.hash (), 1));
+	ASSERT_FALSE (store->block_exists (transaction, send1.hash ()));
+	ASSERT_TRUE (ledger.pruned_exists (transaction, send1.hash ()));
+	ASSERT_TRUE (ledger.block_or_pruned_exists (transaction, send1.hash ()));
+	ASSERT_TRUE (store->block_exists (transaction, genesis.hash ()));
+	ASSERT_EQ (1, ledger.cache.pruned_count);
+	ASSERT_EQ (3, ledger.cache.block_count);
+	nano::pruned_info pruned;
+	ASSERT_FALSE (store->pruned_get (transaction, send1.hash (), pruned));
+	ASSERT_EQ (nano::genesis_account, pruned.account);
+	ASSERT_EQ (2, pruned.height);
+	ASSERT_EQ (nano::genesis_amount - 100, pruned.balance.number ());
+	// Blocks above the pruned one still resolve their amount and confirmation
+	ASSERT_TRUE (ledger.block_confirmed (transaction, send1.hash ()));
+	ASSERT_EQ (200, ledger.amount (transaction, send2.hash ()));
+	// Pruning stops at the blocks already pruned
+	ASSERT_EQ (1, ledger.pruning_action (transaction, send2.hash (), 1));
+	ASSERT_EQ (2, ledger.cache.pruned_count);
+	ASSERT_EQ (2, store->pruned_count (transaction));
+	// Receiving a pruned send is still possible as the pending entry is kept
+	nano::open_block open (send2.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+	ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+	ASSERT_EQ (nano::process_result::old, ledger.process (transaction, send1).code);
+}
+
+TEST (ledger, cache_generation)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::genesis genesis;
+	nano::keypair rep1;
+	nano::keypair rep2;
+	// Enough random accounts to land in every range scanned in parallel
+	auto count (1000);
+	{
+		nano::ledger_cache ledger_cache;
+		auto transaction (store->tx_begin_write ());
+		store->initialize (transaction, genesis, ledger_cache);
+		for (auto i (0); i < count; ++i)
+		{
+			nano::keypair key;
+			store->account_put (transaction, key.pub, nano::account_info (0, i % 2 ? rep1.pub : rep2.pub, 0, 3, 0, 0, nano::epoch::epoch_0));
+			store->confirmation_height_put (transaction, key.pub, { 2, 0 });
+		}
+	}
+	nano::stat stats;
+	nano::ledger ledger (*store, stats, nano::generate_cache (), &logger);
+	ASSERT_EQ (count + 1, ledger.cache.account_count);
+	ASSERT_EQ (2 * count + 1, ledger.cache.cemented_count);
+	ASSERT_EQ (3 * count / 2, ledger.cache.rep_weights.representation_get (rep1.pub));
+	ASSERT_EQ (3 * count / 2, ledger.cache.rep_weights.representation_get (rep2.pub));
+	ASSERT_EQ (nano::genesis_amount, ledger.cache.rep_weights.representation_get (nano::test_genesis_key.pub));
+}
+
+TEST (ledger, cache_checkpoint)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::stat stats;
+	nano::genesis genesis;
+	nano::keypair key1;
+	{
+		nano::ledger ledger (*store, stats);
+		nano::work_pool pool (std::numeric_limits<unsigned>::max ());
+		{
+			auto transaction (store->tx_begin_write ());
+			store->initialize (transaction, genesis, ledger.cache);
+			nano::send_block send (genesis.hash (), key1.pub, nano::genesis_amount - 100, nano::test_genesis_key.prv, nano::test_genesis_key.pub, *pool.generate (genesis.hash ()));
+			ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, send).code);
+			nano::open_block open (send.hash (), key1.pub, key1.pub, key1.prv, key1.pub, *pool.generate (key1.pub));
+			ASSERT_EQ (nano::process_result::progress, ledger.process (transaction, open).code);
+		}
+		// Differs from what scanning gives, to tell a loaded checkpoint apart
+		ledger.cache.cemented_count = 7;
+		auto transaction (store->tx_begin_write ());
+		ledger.cache_checkpoint (transaction);
+	}
+	{
+		nano::ledger ledger (*store, stats);
+		ASSERT_EQ (7, ledger.cache.cemented_count);
+		ASSERT_EQ (2, ledger.cache.account_count);
+		ASSERT_EQ (3, ledger.cache.block_count);
+		ASSERT_EQ (nano::genesis_amount - 100, ledger.cache.rep_weights.representation_get (nano::test_genesis_key.pub));
+		ASSERT_EQ (100, ledger.cache.rep_weights.representation_get (key1.pub));
+	}
+	// Any write after the checkpoint makes the next start scan the ledger
+	{
+		auto transaction (store->tx_begin_write ());
+		store->confirmation_height_put (transaction, key1.pub, { 1, genesis.hash () });
+	}
+	nano::ledger ledger (*store, stats);
+	ASSERT_EQ (2, ledger.cache.cemented_count);
+	ASSERT_EQ (2, ledger.cache.account_count);
+	ASSERT_EQ (100, ledger.cache.rep_weights.representation_get (key1.pub));
+}
+
 TEST (ledger, zero_rep)
 {
 	nano::system system (1);
@@ -287,7 +287,7 @@ TEST (node, auto_bootstrap)
 	}
 
 	auto transaction = node1->store.tx_begin_read ();
-	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->store.unchecked_count (transaction));
+	ASSERT_EQ (node1->ledger.cache.unchecked_count, node1->unchecked.count (transaction));
 
 	node1->stop ();
 }
@@ -3206,6 +3206,44 @@ TEST (node, block_processor_reject_state)
 	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
 }
 
+TEST (write_database_queue, group_commit)
+{
+	nano::stat stats;
+	std::atomic<unsigned> syncs{ 0 };
+	nano::write_database_queue queue ([&syncs]() { ++syncs; }, std::chrono::milliseconds (50), &stats);
+	{
+		auto write_guard = queue.wait (nano::writer::testing);
+		// Another writer is queued so the flush is left to it
+		ASSERT_FALSE (queue.process (nano::writer::process_batch));
+	}
+	ASSERT_EQ (0, syncs);
+	{
+		ASSERT_TRUE (queue.process (nano::writer::process_batch));
+		auto write_guard = queue.pop ();
+	}
+	// The last queued writer flushes both commits
+	ASSERT_EQ (1, syncs);
+	{
+		auto write_guard = queue.wait (nano::writer::testing);
+		ASSERT_FALSE (queue.process (nano::writer::process_batch));
+		std::this_thread::sleep_for (std::chrono::milliseconds (100));
+	}
+	ASSERT_EQ (1, syncs);
+	{
+		ASSERT_TRUE (queue.process (nano::writer::process_batch));
+		ASSERT_FALSE (queue.process (nano::writer::confirmation_height));
+		std::this_thread::sleep_for (std::chrono::milliseconds (100));
+		auto write_guard = queue.pop ();
+	}
+	// The oldest commit exceeded the delay so this writer flushes despite another being queued
+	ASSERT_EQ (2, syncs);
+	ASSERT_TRUE (queue.process (nano::writer::confirmation_height));
+	queue.pop ();
+	ASSERT_EQ (3, syncs);
+	ASSERT_EQ (5, stats.count (nano::stat::type::write_queue, nano::stat::detail::batch_commit));
+	ASSERT_EQ (3, stats.count (nano::stat::type::write_queue, nano::stat::detail::sync));
+}
+
 TEST (node, block_processor_full)
 {
 	nano::system system;
@@ -3263,6 +3301,40 @@ TEST (node, block_processor_half_full)
 	ASSERT_FALSE (node.block_processor.full ());
 }
 
+namespace nano
+{
+TEST (node, block_processor_verification_pipeline)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	auto send1 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, genesis.hash (), nano::test_genesis_key.pub, nano::genesis_amount - nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send1);
+	auto send2 (std::make_shared<nano::state_block> (nano::test_genesis_key.pub, send1->hash (), nano::test_genesis_key.pub, nano::genesis_amount - 2 * nano::Gxrb_ratio, nano::test_genesis_key.pub, nano::test_genesis_key.prv, nano::test_genesis_key.pub, 0));
+	node.work_generate_blocking (*send2);
+	{
+		// The write guard prevents block processor doing any writes, signatures must still be verified in the meantime
+		auto write_guard = node.write_database_queue.wait (nano::writer::testing);
+		node.block_processor.add (send1);
+		node.block_processor.add (send2);
+		system.deadline_set (5s);
+		auto verified (false);
+		while (!verified)
+		{
+			{
+				nano::lock_guard<std::mutex> guard (node.block_processor.mutex);
+				verified = node.block_processor.state_blocks.empty () && !node.block_processor.verifying && node.block_processor.blocks.size () == 2;
+			}
+			ASSERT_NO_ERROR (system.poll ());
+		}
+		ASSERT_FALSE (node.ledger.block_exists (send1->hash ()));
+	}
+	node.block_processor.flush ();
+	ASSERT_TRUE (node.ledger.block_exists (send1->hash ()));
+	ASSERT_TRUE (node.ledger.block_exists (send2->hash ()));
+}
+}
+
 TEST (node, confirm_back)
 {
 	nano::system system (1);
@@ -3408,6 +3480,44 @@ TEST (node, peer_cache_restart)
 	}
 }
 
+TEST (node, cache_checkpoint_copy)
+{
+	nano::system system;
+	auto path (nano::unique_path ());
+	auto copy_path (nano::unique_path ());
+	{
+		auto node1 (std::make_shared<nano::node> (system.io_ctx, nano::get_available_port (), path, system.alarm, system.logging, system.work));
+		ASSERT_FALSE (node1->init_error ());
+		// Stopping cleanly stores the checkpoint
+		node1->stop ();
+		nano::ledger_cache cache;
+		ASSERT_FALSE (node1->store.cache_checkpoint_get (node1->store.tx_begin_read (), cache));
+		// RocksDB copies keep their sequence numbers, only LMDB compaction resets transaction ids
+		if (node1->store.vendor_get ().find ("LMDB") != 0)
+		{
+			return;
+		}
+		boost::filesystem::create_directories (copy_path);
+		ASSERT_TRUE (node1->copy_with_compaction (copy_path / "data.ldb"));
+	}
+	// Starting from the compacted copy drops the checkpoint, later writes could otherwise reach its transaction id again
+	{
+		auto node2 (std::make_shared<nano::node> (system.io_ctx, nano::get_available_port (), copy_path, system.alarm, system.logging, system.work));
+		ASSERT_FALSE (node2->init_error ());
+		nano::ledger_cache cache;
+		ASSERT_TRUE (node2->store.cache_checkpoint_get (node2->store.tx_begin_read (), cache));
+		ASSERT_EQ (1, node2->ledger.cache.account_count);
+		node2->stop ();
+	}
+	// The original is loaded from its checkpoint once
+	auto node3 (std::make_shared<nano::node> (system.io_ctx, nano::get_available_port (), path, system.alarm, system.logging, system.work));
+	ASSERT_FALSE (node3->init_error ());
+	ASSERT_EQ (1, node3->ledger.cache.account_count);
+	nano::ledger_cache cache;
+	ASSERT_TRUE (node3->store.cache_checkpoint_get (node3->store.tx_begin_read (), cache));
+	node3->stop ();
+}
+
 TEST (node, unchecked_cleanup)
 {
 	nano::system system (1);
@@ -3419,7 +3529,7 @@ TEST (node, unchecked_cleanup)
 	node.config.unchecked_cutoff_time = std::chrono::seconds (2);
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3427,7 +3537,7 @@ TEST (node, unchecked_cleanup)
 	node.unchecked_cleanup ();
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 1);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -3435,7 +3545,7 @@ TEST (node, unchecked_cleanup)
 	node.unchecked_cleanup ();
 	{
 		auto transaction (node.store.tx_begin_read ());
-		auto unchecked_count (node.store.unchecked_count (transaction));
+		auto unchecked_count (node.unchecked.count (transaction));
 		ASSERT_EQ (unchecked_count, 0);
 		ASSERT_EQ (unchecked_count, node.ledger.cache.unchecked_count);
 	}
@@ -147,3 +147,153 @@ TEST (signature_checker, one)
 	block.signature.bytes[31] ^= 0x1;
 	verify_block (block, 1);
 }
+
+TEST (signature_checker, async_coalesced)
+{
+	nano::signature_checker checker (2);
+	nano::keypair key;
+	nano::state_block block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	auto block_hash (block.hash ());
+	nano::signature invalid_signature (block.signature);
+	invalid_signature.bytes[31] ^= 0x1;
+
+	// Many small submissions, the last signature of each set is invalid
+	constexpr size_t num_sets = 64;
+	constexpr size_t set_size = 7;
+	std::array<std::vector<unsigned char const *>, num_sets> messages;
+	std::array<std::vector<size_t>, num_sets> lengths;
+	std::array<std::vector<unsigned char const *>, num_sets> pub_keys;
+	std::array<std::vector<unsigned char const *>, num_sets> signatures;
+	std::array<std::vector<int>, num_sets> verifications;
+	std::vector<nano::signature_check_set> sets;
+	sets.reserve (num_sets);
+	std::atomic<size_t> completed{ 0 };
+	std::promise<void> promise;
+	for (auto i (0); i < num_sets; ++i)
+	{
+		messages[i].assign (set_size, block_hash.bytes.data ());
+		lengths[i].assign (set_size, sizeof (block_hash));
+		pub_keys[i].assign (set_size, block.hashables.account.bytes.data ());
+		signatures[i].assign (set_size, block.signature.bytes.data ());
+		signatures[i].back () = invalid_signature.bytes.data ();
+		verifications[i].assign (set_size, -1);
+		sets.emplace_back (set_size, messages[i].data (), lengths[i].data (), pub_keys[i].data (), signatures[i].data (), verifications[i].data ());
+	}
+	for (auto & set : sets)
+	{
+		checker.verify_async (set, [&completed, &promise]() {
+			if (++completed == num_sets)
+			{
+				promise.set_value ();
+			}
+		});
+	}
+	ASSERT_EQ (std::future_status::ready, promise.get_future ().wait_for (std::chrono::seconds (10)));
+	for (auto i (0); i < num_sets; ++i)
+	{
+		ASSERT_TRUE (std::all_of (verifications[i].cbegin (), verifications[i].cend () - 1, [](auto verification) { return verification == 1; }));
+		ASSERT_EQ (0, verifications[i].back ());
+	}
+}
+
+TEST (signature_checker, coalesced_concurrent)
+{
+	// A latency budget long enough for both submissions to arrive before the batch is verified
+	nano::signature_checker checker (2, std::chrono::milliseconds (500));
+	nano::keypair key;
+	nano::state_block block (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	auto block_hash (block.hash ());
+	nano::signature invalid_signature (block.signature);
+	invalid_signature.bytes[31] ^= 0x1;
+	auto verify = [&checker, &block, &block_hash](nano::signature const & signature_a) {
+		constexpr size_t set_size = 4;
+		std::vector<unsigned char const *> messages (set_size, block_hash.bytes.data ());
+		std::vector<size_t> lengths (set_size, sizeof (block_hash));
+		std::vector<unsigned char const *> pub_keys (set_size, block.hashables.account.bytes.data ());
+		std::vector<unsigned char const *> signatures (set_size, signature_a.bytes.data ());
+		std::vector<int> verifications (set_size, -1);
+		nano::signature_check_set check (set_size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data ());
+		checker.verify_coalesced (check);
+		return verifications;
+	};
+	auto valid (std::async (std::launch::async, [&verify, &block]() { return verify (block.signature); }));
+	auto invalid (std::async (std::launch::async, [&verify, &invalid_signature]() { return verify (invalid_signature); }));
+	ASSERT_EQ (std::vector<int> (4, 1), valid.get ());
+	ASSERT_EQ (std::vector<int> (4, 0), invalid.get ());
+	ASSERT_EQ (1, checker.queue_batches ());
+}
+
+TEST (signature_cache, unit)
+{
+	nano::signature_cache cache (64, 4);
+	ASSERT_EQ (64, cache.size ());
+	nano::keypair key;
+	nano::state_block block1 (key.pub, 0, key.pub, 0, 0, key.prv, key.pub, 0);
+	nano::state_block block2 (key.pub, 0, key.pub, 1, 0, key.prv, key.pub, 0);
+	ASSERT_FALSE (cache.contains (block1.hash (), key.pub, block1.signature));
+	cache.insert (block1.hash (), key.pub, block1.signature);
+	ASSERT_TRUE (cache.contains (block1.hash (), key.pub, block1.signature));
+	// Any difference in message, key or signature is a miss
+	ASSERT_FALSE (cache.contains (block2.hash (), key.pub, block1.signature));
+	ASSERT_FALSE (cache.contains (block1.hash (), nano::keypair ().pub, block1.signature));
+	ASSERT_FALSE (cache.contains (block1.hash (), key.pub, block2.signature));
+	cache.clear ();
+	ASSERT_FALSE (cache.contains (block1.hash (), key.pub, block1.signature));
+}
+
+TEST (signature_checker, prepared_keys)
+{
+	nano::keypair key1;
+	nano::keypair key2;
+	nano::prepared_key_cache cache;
+	cache.update ({ key1.pub });
+	auto keys (cache.snapshot ());
+	ASSERT_EQ (1, keys->size ());
+	auto prepared (keys->find (key1.pub));
+	ASSERT_NE (keys->end (), prepared);
+	ASSERT_EQ (0, reinterpret_cast<uintptr_t> (prepared->second->data ()) % 16);
+	size_t size (1000);
+	std::vector<nano::state_block> blocks;
+	blocks.reserve (size);
+	std::vector<nano::uint256_union> hashes;
+	hashes.reserve (size);
+	std::vector<unsigned char const *> messages;
+	std::vector<size_t> lengths (size, sizeof (nano::uint256_union));
+	std::vector<unsigned char const *> pub_keys;
+	std::vector<unsigned char const *> signatures;
+	std::vector<nano::prepared_public_key const *> prepared_keys;
+	for (auto i (0); i < size; ++i)
+	{
+		auto & key (i % 2 == 0 ? key1 : key2);
+		blocks.emplace_back (key.pub, 0, key.pub, i, 0, key.prv, key.pub, 0);
+		hashes.push_back (blocks.back ().hash ());
+		pub_keys.push_back (key.pub.bytes.data ());
+		prepared_keys.push_back (i % 2 == 0 ? prepared->second.get () : nullptr);
+	}
+	// Every third signature is invalid
+	for (auto i (0); i < size; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			blocks[i].signature.bytes[32] ^= 0x1;
+		}
+		messages.push_back (hashes[i].bytes.data ());
+		signatures.push_back (blocks[i].signature.bytes.data ());
+	}
+	nano::signature_checker checker (2);
+	std::vector<int> verifications (size, 0);
+	nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data (), prepared_keys.data () };
+	checker.verify (check);
+	for (auto i (0); i < size; ++i)
+	{
+		ASSERT_EQ (i % 3 == 0 ? 0 : 1, verifications[i]);
+	}
+	ASSERT_FALSE (nano::validate_message (*prepared->second, hashes[2], blocks[2].signature));
+	ASSERT_TRUE (nano::validate_message (*prepared->second, hashes[0], blocks[0].signature));
+	// Keys still in the set are reused rather than prepared again
+	cache.update ({ key1.pub, key2.pub });
+	ASSERT_EQ (2, cache.size ());
+	ASSERT_EQ (prepared->second, cache.snapshot ()->find (key1.pub)->second);
+	cache.update ({ key2.pub });
+	ASSERT_EQ (1, cache.size ());
+}
@@ -181,6 +181,13 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_EQ (conf.node.work_threads, defaults.node.work_threads);
 	ASSERT_EQ (conf.node.max_queued_requests, defaults.node.max_queued_requests);
+	ASSERT_EQ (conf.node.vote_processor_threads, defaults.node.vote_processor_threads);
+	ASSERT_EQ (conf.node.unchecked_memory_size, defaults.node.unchecked_memory_size);
+	ASSERT_EQ (conf.node.group_commit_max_delay, defaults.node.group_commit_max_delay);
+	ASSERT_EQ (conf.node.enable_delegators_index, defaults.node.enable_delegators_index);
+	ASSERT_EQ (conf.node.enable_account_heights_index, defaults.node.enable_account_heights_index);
+	ASSERT_EQ (conf.node.enable_pruning, defaults.node.enable_pruning);
+	ASSERT_EQ (conf.node.pruning_depth, defaults.node.pruning_depth);
 
 	ASSERT_EQ (conf.node.logging.bulk_pull_logging_value, defaults.node.logging.bulk_pull_logging_value);
 	ASSERT_EQ (conf.node.logging.flush, defaults.node.logging.flush);
@@ -254,6 +261,10 @@ TEST (toml, daemon_config_deserialize_defaults)
 	ASSERT_EQ (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_EQ (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_EQ (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_EQ (conf.node.rocksdb_config.table_profiles, defaults.node.rocksdb_config.table_profiles);
+	ASSERT_EQ (conf.node.rocksdb_config.prefix_bloom_filter_bits, defaults.node.rocksdb_config.prefix_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.point_lookup_bloom_filter_bits, defaults.node.rocksdb_config.point_lookup_bloom_filter_bits);
+	ASSERT_EQ (conf.node.rocksdb_config.small_memtable_size, defaults.node.rocksdb_config.small_memtable_size);
 }
 
 TEST (toml, optional_child)
@@ -418,6 +429,13 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	work_watcher_period = 999
 	max_work_generate_multiplier = 1.0
 	max_queued_requests = 999
+	vote_processor_threads = 999
+	unchecked_memory_size = 999
+	group_commit_max_delay = 999
+	enable_delegators_index = true
+	enable_account_heights_index = true
+	enable_pruning = true
+	pruning_depth = 999
 	frontiers_confirmation = "always"
 	[node.diagnostics.txn_tracking]
 	enable = true
@@ -504,6 +522,10 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	memtable_size = 128
 	num_memtables = 3
 	total_memtable_size = 0
+	table_profiles = true
+	prefix_bloom_filter_bits = 16
+	point_lookup_bloom_filter_bits = 16
+	small_memtable_size = 8
 
 	[node.experimental]
 	secondary_work_peers = ["test.org:998"]
@@ -579,6 +601,13 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.work_peers, defaults.node.work_peers);
 	ASSERT_NE (conf.node.work_threads, defaults.node.work_threads);
 	ASSERT_NE (conf.node.max_queued_requests, defaults.node.max_queued_requests);
+	ASSERT_NE (conf.node.vote_processor_threads, defaults.node.vote_processor_threads);
+	ASSERT_NE (conf.node.unchecked_memory_size, defaults.node.unchecked_memory_size);
+	ASSERT_NE (conf.node.group_commit_max_delay, defaults.node.group_commit_max_delay);
+	ASSERT_NE (conf.node.enable_delegators_index, defaults.node.enable_delegators_index);
+	ASSERT_NE (conf.node.enable_account_heights_index, defaults.node.enable_account_heights_index);
+	ASSERT_NE (conf.node.enable_pruning, defaults.node.enable_pruning);
+	ASSERT_NE (conf.node.pruning_depth, defaults.node.pruning_depth);
 
 	ASSERT_NE (conf.node.logging.bulk_pull_logging_value, defaults.node.logging.bulk_pull_logging_value);
 	ASSERT_NE (conf.node.logging.flush, defaults.node.logging.flush);
@@ -652,6 +681,10 @@ TEST (toml, daemon_config_deserialize_no_defaults)
 	ASSERT_NE (conf.node.rocksdb_config.memtable_size, defaults.node.rocksdb_config.memtable_size);
 	ASSERT_NE (conf.node.rocksdb_config.num_memtables, defaults.node.rocksdb_config.num_memtables);
 	ASSERT_NE (conf.node.rocksdb_config.total_memtable_size, defaults.node.rocksdb_config.total_memtable_size);
+	ASSERT_NE (conf.node.rocksdb_config.table_profiles, defaults.node.rocksdb_config.table_profiles);
+	ASSERT_NE (conf.node.rocksdb_config.prefix_bloom_filter_bits, defaults.node.rocksdb_config.prefix_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.point_lookup_bloom_filter_bits, defaults.node.rocksdb_config.point_lookup_bloom_filter_bits);
+	ASSERT_NE (conf.node.rocksdb_config.small_memtable_size, defaults.node.rocksdb_config.small_memtable_size);
 }
 
 /** There should be no required values **/
@@ -0,0 +1,104 @@
+#include <nano/core_test/testutil.hpp>
+#include <nano/node/node.hpp>
+#include <nano/node/unchecked_map.hpp>
+#include <nano/secure/blockstore.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::shared_ptr<nano::block> make_block (nano::block_hash const & previous_a)
+{
+	return std::make_shared<nano::send_block> (previous_a, 1, 2, nano::keypair ().prv, 4, 5);
+}
+}
+
+TEST (unchecked_map, memory)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::unchecked_map unchecked (*store, 4 * nano::unchecked_map::entry_size);
+	auto block1 (make_block (1));
+	auto block2 (make_block (1));
+	nano::unchecked_key key1 (1, block1->hash ());
+	nano::unchecked_key key2 (1, block2->hash ());
+	auto transaction (store->tx_begin_write ());
+	ASSERT_TRUE (unchecked.put (transaction, key1, nano::unchecked_info (block1, 0, 0)));
+	ASSERT_FALSE (unchecked.put (transaction, key1, nano::unchecked_info (block1, 0, 0)));
+	ASSERT_TRUE (unchecked.put (transaction, key2, nano::unchecked_info (block2, 0, 0)));
+	// Entries stay in memory while under the budget
+	ASSERT_EQ (2, unchecked.memory_size ());
+	ASSERT_EQ (0, store->unchecked_count (transaction));
+	ASSERT_EQ (2, unchecked.count (transaction));
+	ASSERT_TRUE (unchecked.exists (transaction, key1));
+	ASSERT_EQ (2, unchecked.get (transaction, 1).size ());
+	ASSERT_TRUE (unchecked.get (transaction, 2).empty ());
+	ASSERT_FALSE (unchecked.del (transaction, key1));
+	ASSERT_TRUE (unchecked.del (transaction, key1));
+	ASSERT_EQ (1, unchecked.count (transaction));
+	unchecked.flush (transaction);
+	ASSERT_EQ (0, unchecked.memory_size ());
+	ASSERT_EQ (1, store->unchecked_count (transaction));
+	// Entries in the table are updated in place rather than added to memory
+	ASSERT_FALSE (unchecked.put (transaction, key2, nano::unchecked_info (block2, 0, 0)));
+	ASSERT_EQ (0, unchecked.memory_size ());
+	ASSERT_EQ (1, unchecked.get (transaction, 1).size ());
+	ASSERT_FALSE (unchecked.del (transaction, key2));
+	ASSERT_EQ (0, unchecked.count (transaction));
+}
+
+TEST (unchecked_map, spill)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::unchecked_map unchecked (*store, 4 * nano::unchecked_map::entry_size);
+	auto transaction (store->tx_begin_write ());
+	std::vector<nano::unchecked_key> keys;
+	for (auto i (0); i < 5; ++i)
+	{
+		auto block (make_block (i + 1));
+		keys.emplace_back (block->previous (), block->hash ());
+		ASSERT_TRUE (unchecked.put (transaction, keys.back (), nano::unchecked_info (block, 0, 0)));
+	}
+	// Exceeding the budget writes the oldest entries until a quarter of it is free
+	ASSERT_EQ (3, unchecked.memory_size ());
+	ASSERT_EQ (2, store->unchecked_count (transaction));
+	ASSERT_TRUE (store->unchecked_exists (transaction, keys[0]));
+	ASSERT_TRUE (store->unchecked_exists (transaction, keys[1]));
+	ASSERT_EQ (5, unchecked.count (transaction));
+	for (auto const & key : keys)
+	{
+		ASSERT_TRUE (unchecked.exists (transaction, key));
+		ASSERT_EQ (1, unchecked.get (transaction, key.previous).size ());
+	}
+	// Iteration merges both in key order
+	std::vector<nano::unchecked_key> visited;
+	unchecked.for_each (transaction, nano::unchecked_key (0, 0), [&visited](nano::unchecked_key const & key_a, nano::unchecked_info const &) {
+		visited.push_back (key_a);
+		return true;
+	});
+	ASSERT_EQ (keys, visited);
+	visited.clear ();
+	unchecked.for_each (transaction, keys[1], [&visited](nano::unchecked_key const & key_a, nano::unchecked_info const &) {
+		visited.push_back (key_a);
+		return visited.size () < 2;
+	});
+	ASSERT_EQ ((std::vector<nano::unchecked_key>{ keys[1], keys[2] }), visited);
+	unchecked.clear (transaction);
+	ASSERT_EQ (0, unchecked.count (transaction));
+}
+
+TEST (unchecked_map, disabled)
+{
+	nano::logger_mt logger;
+	auto store = nano::make_store (logger, nano::unique_path ());
+	ASSERT_TRUE (!store->init_error ());
+	nano::unchecked_map unchecked (*store, 0);
+	auto block (make_block (1));
+	auto transaction (store->tx_begin_write ());
+	ASSERT_TRUE (unchecked.put (transaction, nano::unchecked_key (1, block->hash ()), nano::unchecked_info (block, 0, 0)));
+	ASSERT_EQ (0, unchecked.memory_size ());
+	ASSERT_EQ (1, store->unchecked_count (transaction));
+}
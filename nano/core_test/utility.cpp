@@ -1,4 +1,5 @@
 #include <nano/lib/timer.hpp>
+#include <nano/lib/timing_wheel.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/lib/worker.hpp>
 #include <nano/secure/utility.hpp>
@@ -81,3 +82,33 @@ TEST (filesystem, move_all_files)
 	ASSERT_FALSE (boost::filesystem::exists (dummy_file1));
 	ASSERT_FALSE (boost::filesystem::exists (dummy_file2));
 }
+
+TEST (timing_wheel, deadlines)
+{
+	auto start (std::chrono::steady_clock::now ());
+	auto const tick (std::chrono::milliseconds (10));
+	nano::timing_wheel<int> wheel (tick, 4, start);
+	// Within the first level, after a full turn and beyond both levels
+	wheel.insert (1, start + tick);
+	wheel.insert (2, start + 6 * tick);
+	wheel.insert (3, start + 100 * tick);
+	// Deadlines in the past are due immediately
+	wheel.insert (0, start - tick);
+	ASSERT_EQ (4, wheel.size ());
+	std::vector<int> due;
+	wheel.advance (start, due);
+	ASSERT_EQ (std::vector<int>{ 0 }, due);
+	due.clear ();
+	wheel.advance (start + 5 * tick, due);
+	ASSERT_EQ (std::vector<int>{ 1 }, due);
+	due.clear ();
+	wheel.advance (start + 6 * tick, due);
+	ASSERT_EQ (std::vector<int>{ 2 }, due);
+	due.clear ();
+	wheel.advance (start + 99 * tick, due);
+	ASSERT_TRUE (due.empty ());
+	ASSERT_EQ (1, wheel.size ());
+	wheel.advance (start + 100 * tick, due);
+	ASSERT_EQ (std::vector<int>{ 3 }, due);
+	ASSERT_EQ (0, wheel.size ());
+}
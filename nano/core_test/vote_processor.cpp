@@ -87,6 +87,36 @@ TEST (vote_processor, invalid_signature)
 	ASSERT_EQ (2, election.first->last_votes.size ());
 }
 
+TEST (vote_processor, signature_cache)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	nano::genesis genesis;
+	nano::keypair key;
+	auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, std::vector<nano::block_hash>{ genesis.open->hash () }));
+	auto vote_invalid = std::make_shared<nano::vote> (*vote);
+	vote_invalid->signature.bytes[0] ^= 1;
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	node.vote_processor.vote (vote_invalid, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_hit));
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_miss));
+	// Invalid signatures are never cached
+	node.vote_processor.vote (vote_invalid, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (0, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_hit));
+	ASSERT_EQ (2, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_miss));
+	node.vote_processor.vote (vote, channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_miss));
+	ASSERT_TRUE (node.signature_cache.contains (vote->hash (), vote->account, vote->signature));
+	// The same vote received again is not verified again
+	node.vote_processor.vote (std::make_shared<nano::vote> (*vote), channel);
+	node.vote_processor.flush ();
+	ASSERT_EQ (1, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_hit));
+	ASSERT_EQ (3, node.stats.count (nano::stat::type::signature_cache, nano::stat::detail::cache_miss));
+}
+
 namespace nano
 {
 TEST (vote_processor, weights)
@@ -140,4 +170,76 @@ TEST (vote_processor, weights)
 	ASSERT_NE (node.vote_processor.representatives_2.end (), node.vote_processor.representatives_2.find (nano::test_genesis_key.pub));
 	ASSERT_NE (node.vote_processor.representatives_3.end (), node.vote_processor.representatives_3.find (nano::test_genesis_key.pub));
 }
+
+TEST (vote_processor, prepared_keys)
+{
+	nano::system system (1);
+	auto & node (*system.nodes[0]);
+	node.vote_processor.calculate_weights ();
+	// The genesis representative holds all the weight
+	auto keys (node.vote_processor.prepared_keys.snapshot ());
+	ASSERT_EQ (1, keys->size ());
+	ASSERT_NE (keys->end (), keys->find (nano::test_genesis_key.pub));
+	auto vote (std::make_shared<nano::vote> (nano::test_genesis_key.pub, nano::test_genesis_key.prv, 1, std::vector<nano::block_hash>{ nano::genesis_hash }));
+	ASSERT_FALSE (nano::validate_message (*keys->find (nano::test_genesis_key.pub)->second, vote->hash (), vote->signature));
+	node.vote_processor.vote (vote, std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	node.vote_processor.flush ();
+	// Verified as valid through the prepared key
+	ASSERT_TRUE (node.signature_cache.contains (vote->hash (), vote->account, vote->signature));
+}
+
+TEST (vote_processor, shards)
+{
+	nano::system system;
+	nano::node_config config (nano::get_available_port (), system.logging);
+	config.vote_processor_threads = 4;
+	auto & node (*system.add_node (config));
+	ASSERT_EQ (4, node.vote_processor.shards.size ());
+	nano::genesis genesis;
+	auto election (node.active.insert (genesis.open));
+	ASSERT_TRUE (election.second);
+	auto channel (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, node.network.endpoint (), node.network_params.protocol.protocol_version));
+	std::vector<nano::keypair> keys (16);
+	for (auto & key : keys)
+	{
+		auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, std::vector<nano::block_hash>{ genesis.open->hash () }));
+		node.vote_processor.vote (vote, channel);
+	}
+	node.vote_processor.flush ();
+	ASSERT_TRUE (node.vote_processor.empty ());
+	// Every shard applied its votes to the same election
+	ASSERT_EQ (1 + keys.size (), election.first->last_votes.size ());
+}
+
+TEST (vote_processor, channel_fairness)
+{
+	nano::system system;
+	nano::node_config config (nano::get_available_port (), system.logging);
+	config.vote_processor_threads = 1;
+	auto & node (*system.add_node (config));
+	nano::genesis genesis;
+	nano::keypair key;
+	auto vote (std::make_shared<nano::vote> (key.pub, key.prv, 1, std::vector<nano::block_hash>{ genesis.hash () }));
+	auto channel1 (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, nano::endpoint (boost::asio::ip::address_v6::loopback (), 10000), node.network_params.protocol.protocol_version));
+	auto channel2 (std::make_shared<nano::transport::channel_udp> (node.network.udp_channels, nano::endpoint (boost::asio::ip::address_v6::loopback (), 10001), node.network_params.protocol.protocol_version));
+	// A shard which is not attached to a processing thread
+	nano::vote_processor::shard shard;
+	// The first channel floods until it reaches its budget
+	size_t accepted (0);
+	while (node.vote_processor.enqueue (shard, vote, channel1))
+	{
+		++accepted;
+	}
+	ASSERT_EQ (nano::vote_processor::channel_votes_max, accepted);
+	// Other channels are not affected by it
+	ASSERT_TRUE (node.vote_processor.enqueue (shard, vote, channel2));
+	ASSERT_TRUE (node.vote_processor.enqueue (shard, vote, channel2));
+	ASSERT_EQ (accepted + 2, shard.size);
+	// Each channel gets a quantum per round, so the second channel is drained while the first one still has votes queued
+	auto votes (node.vote_processor.drain (shard, 2 * nano::vote_processor::quantum));
+	ASSERT_EQ (2 * nano::vote_processor::quantum, votes.size ());
+	ASSERT_EQ (2, std::count_if (votes.begin (), votes.end (), [&channel2](auto const & entry_a) { return entry_a.second == channel2; }));
+	ASSERT_EQ (1, shard.queues.size ());
+	ASSERT_EQ (accepted + 2 - votes.size (), shard.size);
+}
 }
@@ -428,12 +428,42 @@ bool nano::validate_message (nano::public_key const & public_key, nano::uint256_
 	return result;
 }
 
+bool nano::validate_message (nano::prepared_public_key const & public_key, nano::uint256_union const & message, nano::signature const & signature)
+{
+	auto result (0 != ed25519_sign_open_prepared (message.bytes.data (), sizeof (message.bytes), reinterpret_cast<ed25519_prepared_key const *> (public_key.data ()), signature.bytes.data ()));
+	return result;
+}
+
 bool nano::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, const unsigned char ** RS, size_t num, int * valid)
 {
 	bool result (0 == ed25519_sign_open_batch (m, mlen, pk, RS, num, valid));
 	return result;
 }
 
+bool nano::validate_message_batch (const unsigned char ** m, size_t * mlen, const unsigned char ** pk, nano::prepared_public_key const * const * prepared, const unsigned char ** RS, size_t num, int * valid)
+{
+	std::vector<ed25519_prepared_key const *> prepared_l;
+	prepared_l.reserve (num);
+	std::transform (prepared, prepared + num, std::back_inserter (prepared_l), [](nano::prepared_public_key const * key_a) {
+		return key_a != nullptr ? reinterpret_cast<ed25519_prepared_key const *> (key_a->data ()) : nullptr;
+	});
+	bool result (0 == ed25519_sign_open_batch_prepared (m, mlen, pk, prepared_l.data (), RS, num, valid));
+	return result;
+}
+
+nano::prepared_public_key::prepared_public_key (bool & error_a, nano::public_key const & key_a) :
+key (key_a)
+{
+	debug_assert (ed25519_prepared_key_size () <= ED25519_PREPARED_KEY_MAX_SIZE);
+	error_a = 0 != ed25519_prepare_key (key.bytes.data (), reinterpret_cast<ed25519_prepared_key *> (const_cast<uint8_t *> (data ())));
+}
+
+uint8_t const * nano::prepared_public_key::data () const
+{
+	auto misalignment (reinterpret_cast<uintptr_t> (storage.data ()) % alignment);
+	return storage.data () + (misalignment == 0 ? 0 : alignment - misalignment);
+}
+
 nano::uint128_union::uint128_union (std::string const & string_a)
 {
 	auto error (decode_hex (string_a));
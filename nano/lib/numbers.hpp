@@ -1,7 +1,12 @@
 #pragma once
 
+#include <crypto/ed25519-donna/ed25519.h>
+
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <array>
+#include <vector>
+
 namespace nano
 {
 using uint128_t = boost::multiprecision::uint128_t;
@@ -242,9 +247,33 @@ public:
 	}
 };
 
+/**
+ * Public key with its curve point decompressed and a table of its multiples precomputed, which makes verifying many signatures by the same key cheaper.
+ * Sets \p error_a if the key is not a valid curve point.
+ */
+class prepared_public_key final
+{
+public:
+	prepared_public_key (bool & error_a, nano::public_key const &);
+	// A copy could start at a different offset from an aligned address
+	prepared_public_key (nano::prepared_public_key const &) = delete;
+	nano::prepared_public_key & operator= (nano::prepared_public_key const &) = delete;
+	/** Opaque ed25519_prepared_key, at the first 16 byte aligned address within the storage */
+	uint8_t const * data () const;
+	nano::public_key key;
+
+private:
+	static size_t constexpr alignment{ 16 };
+	/** The curve points need 16 byte alignment, which allocators do not guarantee before C++17, so the storage has room to align them itself */
+	std::array<uint8_t, ED25519_PREPARED_KEY_MAX_SIZE + alignment - 1> storage;
+};
+
 nano::signature sign_message (nano::raw_key const &, nano::public_key const &, nano::uint256_union const &);
 bool validate_message (nano::public_key const &, nano::uint256_union const &, nano::signature const &);
+bool validate_message (nano::prepared_public_key const &, nano::uint256_union const &, nano::signature const &);
 bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, const unsigned char **, size_t, int *);
+/** Prepared keys may be null for signatures which should use the regular public key */
+bool validate_message_batch (const unsigned char **, size_t *, const unsigned char **, nano::prepared_public_key const * const *, const unsigned char **, size_t, int *);
 nano::private_key deterministic_key (nano::raw_key const &, uint32_t);
 nano::public_key pub_key (nano::private_key const &);
 
@@ -1,68 +1,144 @@
 #include <nano/lib/rep_weights.hpp>
 #include <nano/secure/blockstore.hpp>
 
+nano::rep_weights::rep_weights ()
+{
+	tables.push_back (std::make_unique<nano::rep_weights::table> (1024));
+	current = tables.back ().get ();
+}
+
 void nano::rep_weights::representation_add (nano::account const & source_rep, nano::uint128_t const & amount_a)
 {
 	nano::lock_guard<std::mutex> guard (mutex);
-	auto source_previous (get (source_rep));
-	put (source_rep, source_previous + amount_a);
+	auto & weight (get (source_rep));
+	weight.store (weight.load () + amount_a);
 }
 
 void nano::rep_weights::representation_put (nano::account const & account_a, nano::uint128_union const & representation_a)
 {
 	nano::lock_guard<std::mutex> guard (mutex);
-	put (account_a, representation_a);
+	get (account_a).store (representation_a.number ());
 }
 
-nano::uint128_t nano::rep_weights::representation_get (nano::account const & account_a)
+nano::uint128_t nano::rep_weights::representation_get (nano::account const & account_a) const
 {
-	nano::lock_guard<std::mutex> lk (mutex);
-	return get (account_a);
+	auto weight (current.load (std::memory_order_acquire)->find (account_a));
+	return weight != nullptr ? weight->load () : nano::uint128_t{ 0 };
 }
 
 /** Makes a copy */
 std::unordered_map<nano::account, nano::uint128_t> nano::rep_weights::get_rep_amounts ()
+{
+	std::unordered_map<nano::account, nano::uint128_t> result;
+	nano::lock_guard<std::mutex> guard (mutex);
+	for (auto const & node : current.load ()->nodes)
+	{
+		result.emplace (node.account, node.weight.load ());
+	}
+	return result;
+}
+
+size_t nano::rep_weights::size () const
 {
 	nano::lock_guard<std::mutex> guard (mutex);
-	return rep_amounts;
+	return current.load ()->nodes.size ();
 }
 
-void nano::rep_weights::put (nano::account const & account_a, nano::uint128_union const & representation_a)
+nano::rep_weights::weight & nano::rep_weights::get (nano::account const & account_a)
 {
-	auto it = rep_amounts.find (account_a);
-	auto amount = representation_a.number ();
-	if (it != rep_amounts.end ())
+	auto table_l (current.load ());
+	auto result (table_l->find (account_a));
+	if (result == nullptr)
 	{
-		it->second = amount;
+		weights.emplace_back ();
+		result = &weights.back ();
+		if (table_l->nodes.size () > table_l->mask)
+		{
+			// Readers may still be walking the old table, it is kept and the larger one is published once filled
+			auto grown (std::make_unique<nano::rep_weights::table> (2 * (table_l->mask + 1)));
+			for (auto const & node : table_l->nodes)
+			{
+				grown->insert (node.account, node.weight);
+			}
+			grown->insert (account_a, *result);
+			current.store (grown.get (), std::memory_order_release);
+			tables.push_back (std::move (grown));
+		}
+		else
+		{
+			table_l->insert (account_a, *result);
+		}
 	}
-	else
+	return *result;
+}
+
+nano::uint128_t nano::rep_weights::weight::load () const
+{
+	uint64_t sequence_l;
+	uint64_t lower_l;
+	uint64_t upper_l;
+	do
 	{
-		rep_amounts.emplace (account_a, amount);
-	}
+		sequence_l = sequence.load (std::memory_order_acquire);
+		lower_l = lower.load (std::memory_order_relaxed);
+		upper_l = upper.load (std::memory_order_relaxed);
+		std::atomic_thread_fence (std::memory_order_acquire);
+	} while ((sequence_l & 1) != 0 || sequence_l != sequence.load (std::memory_order_relaxed));
+	return (nano::uint128_t (upper_l) << 64) | lower_l;
+}
+
+void nano::rep_weights::weight::store (nano::uint128_t const & value_a)
+{
+	auto sequence_l (sequence.load (std::memory_order_relaxed));
+	sequence.store (sequence_l + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+	lower.store (static_cast<uint64_t> (value_a), std::memory_order_relaxed);
+	upper.store (static_cast<uint64_t> (value_a >> 64), std::memory_order_relaxed);
+	sequence.store (sequence_l + 2, std::memory_order_release);
 }
 
-nano::uint128_t nano::rep_weights::get (nano::account const & account_a)
+nano::rep_weights::node::node (nano::account const & account_a, nano::rep_weights::weight & weight_a, nano::rep_weights::node * next_a) :
+account (account_a),
+weight (weight_a),
+next (next_a)
 {
-	auto it = rep_amounts.find (account_a);
-	if (it != rep_amounts.end ())
+}
+
+nano::rep_weights::table::table (size_t bucket_count_a) :
+mask (bucket_count_a - 1),
+buckets (new std::atomic<nano::rep_weights::node *>[bucket_count_a])
+{
+	debug_assert ((bucket_count_a & mask) == 0);
+	for (size_t i (0); i < bucket_count_a; ++i)
 	{
-		return it->second;
+		buckets[i].store (nullptr, std::memory_order_relaxed);
 	}
-	else
+}
+
+nano::rep_weights::weight * nano::rep_weights::table::find (nano::account const & account_a) const
+{
+	nano::rep_weights::weight * result (nullptr);
+	for (auto node (buckets[account_a.qwords[0] & mask].load (std::memory_order_acquire)); node != nullptr && result == nullptr; node = node->next)
 	{
-		return nano::uint128_t{ 0 };
+		if (node->account == account_a)
+		{
+			result = &node->weight;
+		}
 	}
+	return result;
 }
 
-std::unique_ptr<nano::container_info_component> nano::collect_container_info (nano::rep_weights & rep_weights, const std::string & name)
+void nano::rep_weights::table::insert (nano::account const & account_a, nano::rep_weights::weight & weight_a)
 {
-	size_t rep_amounts_count;
+	auto & bucket (buckets[account_a.qwords[0] & mask]);
+	nodes.emplace_back (account_a, weight_a, bucket.load (std::memory_order_relaxed));
+	bucket.store (&nodes.back (), std::memory_order_release);
+}
 
-	{
-		nano::lock_guard<std::mutex> guard (rep_weights.mutex);
-		rep_amounts_count = rep_weights.rep_amounts.size ();
-	}
-	auto sizeof_element = sizeof (decltype (rep_weights.rep_amounts)::value_type);
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (nano::rep_weights & rep_weights, const std::string & name)
+{
+	auto rep_amounts_count (rep_weights.size ());
+	auto sizeof_element = sizeof (nano::rep_weights::weight) + sizeof (nano::rep_weights::node) + sizeof (std::atomic<nano::rep_weights::node *>);
 	auto composite = std::make_unique<nano::container_info_composite> (name);
 	composite->add_component (std::make_unique<nano::container_info_leaf> (container_info{ "rep_amounts", rep_amounts_count, sizeof_element }));
 	return composite;
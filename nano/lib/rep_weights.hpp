@@ -3,28 +3,71 @@
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
 
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace nano
 {
 class block_store;
 class transaction;
 
+/**
+ * Voting weight of each representative.
+ * Reads do not take a lock, representatives are held in a hash table which only ever grows and is read through an atomic pointer.
+ * Writers are serialized by a mutex, a weight is updated in place and read with a sequence lock so readers never see a torn 128-bit value.
+ */
 class rep_weights
 {
 public:
+	rep_weights ();
 	void representation_add (nano::account const & source_a, nano::uint128_t const & amount_a);
-	nano::uint128_t representation_get (nano::account const & account_a);
+	nano::uint128_t representation_get (nano::account const & account_a) const;
 	void representation_put (nano::account const & account_a, nano::uint128_union const & representation_a);
 	std::unordered_map<nano::account, nano::uint128_t> get_rep_amounts ();
+	size_t size () const;
 
 private:
-	std::mutex mutex;
-	std::unordered_map<nano::account, nano::uint128_t> rep_amounts;
-	void put (nano::account const & account_a, nano::uint128_union const & representation_a);
-	nano::uint128_t get (nano::account const & account_a);
+	class weight final
+	{
+	public:
+		nano::uint128_t load () const;
+		/** Only called by one writer at a time */
+		void store (nano::uint128_t const &);
+
+	private:
+		std::atomic<uint64_t> sequence{ 0 };
+		std::atomic<uint64_t> lower{ 0 };
+		std::atomic<uint64_t> upper{ 0 };
+	};
+	class node final
+	{
+	public:
+		node (nano::account const &, nano::rep_weights::weight &, nano::rep_weights::node *);
+		nano::account account;
+		nano::rep_weights::weight & weight;
+		/** Set before the node is published and never changed after */
+		nano::rep_weights::node * next;
+	};
+	class table final
+	{
+	public:
+		explicit table (size_t bucket_count_a);
+		nano::rep_weights::weight * find (nano::account const &) const;
+		void insert (nano::account const &, nano::rep_weights::weight &);
+		size_t const mask;
+		std::unique_ptr<std::atomic<nano::rep_weights::node *>[]> buckets;
+		std::deque<nano::rep_weights::node> nodes;
+	};
+	mutable std::mutex mutex;
+	std::deque<nano::rep_weights::weight> weights;
+	std::atomic<nano::rep_weights::table *> current;
+	/** Tables replaced by a larger one, kept as readers may still hold them. Bucket counts double so these use less memory than the current table */
+	std::vector<std::unique_ptr<nano::rep_weights::table>> tables;
+	nano::rep_weights::weight & get (nano::account const & account_a);
 
 	friend std::unique_ptr<container_info_component> collect_container_info (rep_weights &, const std::string &);
 };
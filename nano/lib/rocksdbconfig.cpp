@@ -13,6 +13,10 @@ nano::error nano::rocksdb_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("num_memtables", num_memtables, "Number of memtables to keep in memory per column family. 2 is the minimum, 3 is recommended.\ntype:uint32");
 	toml.put ("memtable_size", memtable_size, "Amount of memory (MB) to build up before flushing to disk for an individual column family. Large values increase performance. 64 or 128 is recommended.\ntype:uint32");
 	toml.put ("total_memtable_size", total_memtable_size, "Total memory (MB) which can be used across all memtables, set to 0 for unconstrained.\ntype:uint32");
+	toml.put ("table_profiles", table_profiles, "Whether column families use options suited to how they are accessed. When false every column family uses the options above. Experimental, not yet benchmarked against the shared options.\ntype:bool");
+	toml.put ("prefix_bloom_filter_bits", prefix_bloom_filter_bits, "Number of bits to use with the bloom filter of the pending and unchecked column families, which also holds the account or dependency prefix of their keys. 0 disables the bloom filter.\ntype:uint32");
+	toml.put ("point_lookup_bloom_filter_bits", point_lookup_bloom_filter_bits, "Number of bits to use with the bloom filter of the block column families, which are only read by hash. 0 disables the bloom filter.\ntype:uint32");
+	toml.put ("small_memtable_size", small_memtable_size, "Size (MB) of each memtable for the rarely written peers and online_weight column families.\ntype:uint32");
 	return toml.get_error ();
 }
 
@@ -28,12 +32,24 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	toml.get_optional<unsigned> ("num_memtables", num_memtables);
 	toml.get_optional<unsigned> ("memtable_size", memtable_size);
 	toml.get_optional<unsigned> ("total_memtable_size", total_memtable_size);
+	toml.get_optional<bool> ("table_profiles", table_profiles);
+	toml.get_optional<unsigned> ("prefix_bloom_filter_bits", prefix_bloom_filter_bits);
+	toml.get_optional<unsigned> ("point_lookup_bloom_filter_bits", point_lookup_bloom_filter_bits);
+	toml.get_optional<unsigned> ("small_memtable_size", small_memtable_size);
 
 	// Validate ranges
 	if (bloom_filter_bits > 100)
 	{
 		toml.get_error ().set ("bloom_filter_bits is too high");
 	}
+	if (prefix_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("prefix_bloom_filter_bits is too high");
+	}
+	if (point_lookup_bloom_filter_bits > 100)
+	{
+		toml.get_error ().set ("point_lookup_bloom_filter_bits is too high");
+	}
 	if (num_memtables < 2)
 	{
 		toml.get_error ().set ("num_memtables must be at least 2");
@@ -46,6 +62,10 @@ nano::error nano::rocksdb_config::deserialize_toml (nano::tomlconfig & toml)
 	{
 		toml.get_error ().set ("total_memtable_size should be at least 8 times greater than memtable_size or be set to 0");
 	}
+	if (small_memtable_size == 0)
+	{
+		toml.get_error ().set ("small_memtable_size must be non-zero");
+	}
 	if (io_threads == 0)
 	{
 		toml.get_error ().set ("io_threads must be non-zero");
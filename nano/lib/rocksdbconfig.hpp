@@ -25,5 +25,10 @@ public:
 	unsigned memtable_size{ 32 }; // MB
 	unsigned num_memtables{ 2 }; // Need a minimum of 2
 	unsigned total_memtable_size{ 512 }; // MB
+	/** Use options suited to how each column family is accessed, otherwise every column family uses the same options. Off until benchmarked against the shared options */
+	bool table_profiles{ false };
+	unsigned prefix_bloom_filter_bits{ 10 };
+	unsigned point_lookup_bloom_filter_bits{ 10 };
+	unsigned small_memtable_size{ 4 }; // MB
 };
 }
@@ -444,6 +444,15 @@ std::string nano::stat::type_to_string (uint32_t key)
 		case nano::stat::type::requests:
 			res = "requests";
 			break;
+		case nano::stat::type::signature_cache:
+			res = "signature_cache";
+			break;
+		case nano::stat::type::read_txn_pool:
+			res = "read_txn_pool";
+			break;
+		case nano::stat::type::write_queue:
+			res = "write_queue";
+			break;
 	}
 	return res;
 }
@@ -595,6 +604,9 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::vote_overflow:
 			res = "vote_overflow";
 			break;
+		case nano::stat::detail::vote_channel_overflow:
+			res = "vote_channel_overflow";
+			break;
 		case nano::stat::detail::vote_new:
 			res = "vote_new";
 			break;
@@ -607,6 +619,12 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::late_block_seconds:
 			res = "late_block_seconds";
 			break;
+		case nano::stat::detail::election_tick:
+			res = "election_tick";
+			break;
+		case nano::stat::detail::election_due:
+			res = "election_due";
+			break;
 		case nano::stat::detail::blocking:
 			res = "blocking";
 			break;
@@ -694,6 +712,18 @@ std::string nano::stat::detail_to_string (uint32_t key)
 		case nano::stat::detail::requests_unknown:
 			res = "requests_unknown";
 			break;
+		case nano::stat::detail::cache_hit:
+			res = "cache_hit";
+			break;
+		case nano::stat::detail::cache_miss:
+			res = "cache_miss";
+			break;
+		case nano::stat::detail::batch_commit:
+			res = "batch_commit";
+			break;
+		case nano::stat::detail::sync:
+			res = "sync";
+			break;
 	}
 	return res;
 }
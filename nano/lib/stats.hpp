@@ -199,7 +199,10 @@ public:
 		confirmation_height,
 		drop,
 		aggregator,
-		requests
+		requests,
+		signature_cache,
+		read_txn_pool,
+		write_queue
 	};
 
 	/** Optional detail type */
@@ -265,12 +268,15 @@ public:
 		vote_indeterminate,
 		vote_invalid,
 		vote_overflow,
+		vote_channel_overflow,
 
 		// election specific
 		vote_new,
 		vote_cached,
 		late_block,
 		late_block_seconds,
+		election_tick,
+		election_due,
 
 		// udp
 		blocking,
@@ -314,7 +320,15 @@ public:
 		requests_generated_hashes,
 		requests_cached_votes,
 		requests_generated_votes,
-		requests_unknown
+		requests_unknown,
+
+		// caches
+		cache_hit,
+		cache_miss,
+
+		// write queue
+		batch_commit,
+		sync
 	};
 
 	/** Direction of the stat. If the direction is irrelevant, use in */
@@ -39,6 +39,9 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::block_processing:
 			thread_role_name_string = "Blck processing";
 			break;
+		case nano::thread_role::name::block_verification:
+			thread_role_name_string = "Blck verifying";
+			break;
 		case nano::thread_role::name::request_loop:
 			thread_role_name_string = "Request loop";
 			break;
@@ -72,6 +75,9 @@ std::string nano::thread_role::get_string (nano::thread_role::name role)
 		case nano::thread_role::name::request_aggregator:
 			thread_role_name_string = "Req aggregator";
 			break;
+		case nano::thread_role::name::db_parallel_traversal:
+			thread_role_name_string = "DB traversal";
+			break;
 	}
 
 	/*
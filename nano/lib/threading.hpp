@@ -22,6 +22,7 @@ namespace thread_role
 		alarm,
 		vote_processing,
 		block_processing,
+		block_verification,
 		request_loop,
 		wallet_actions,
 		bootstrap_initiator,
@@ -32,7 +33,8 @@ namespace thread_role
 		work_watcher,
 		confirmation_height_processing,
 		worker,
-		request_aggregator
+		request_aggregator,
+		db_parallel_traversal
 	};
 	/*
 	 * Get/Set the identifier for the current thread
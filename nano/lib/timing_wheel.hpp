@@ -0,0 +1,117 @@
+#pragma once
+
+#include <nano/lib/utility.hpp>
+
+#include <chrono>
+#include <vector>
+
+namespace nano
+{
+/**
+ * Hierarchical timing wheel holding items until their deadline.
+ * The first level has one slot per tick, the second level has one slot per turn of the first level. Items due further ahead than both
+ * levels cover are kept in the last slot of the second level and placed again when it comes around.
+ * Deadlines are rounded up to whole ticks, items are returned at most one tick late and never early.
+ * Inserting and advancing are O(1) per item, independent of how many items are waiting.
+ * @note This class is not thread-safe.
+ */
+template <typename T>
+class timing_wheel final
+{
+public:
+	using clock = std::chrono::steady_clock;
+	timing_wheel (clock::duration tick_a, size_t slots_a, clock::time_point start_a = clock::now ()) :
+	tick (tick_a),
+	start (start_a),
+	level0 (slots_a),
+	level1 (slots_a)
+	{
+		debug_assert (tick_a.count () > 0);
+		debug_assert (slots_a > 1);
+	}
+
+	void insert (T const & item_a, clock::time_point deadline_a)
+	{
+		place (entry{ item_a, ticks_ceil (deadline_a) });
+		++count;
+	}
+
+	/** Appends the items due at \p now_a to \p items_a */
+	void advance (clock::time_point now_a, std::vector<T> & items_a)
+	{
+		auto target (ticks_floor (now_a));
+		auto const slots (level0.size ());
+		std::vector<entry> cascade;
+		while (current <= target)
+		{
+			if (current % slots == 0)
+			{
+				// Start of a new turn, spread the items of the matching second level slot over the first level
+				cascade.clear ();
+				cascade.swap (level1[(current / slots) % slots]);
+				for (auto & entry_l : cascade)
+				{
+					place (std::move (entry_l));
+				}
+			}
+			auto & slot (level0[current % slots]);
+			for (auto & entry_l : slot)
+			{
+				debug_assert (entry_l.tick <= current);
+				items_a.push_back (std::move (entry_l.item));
+			}
+			count -= slot.size ();
+			slot.clear ();
+			++current;
+		}
+	}
+
+	size_t size () const
+	{
+		return count;
+	}
+
+private:
+	class entry final
+	{
+	public:
+		T item;
+		/** Tick at which the item is due, counted from start */
+		uint64_t tick;
+	};
+
+	void place (entry && entry_a)
+	{
+		auto const slots (level0.size ());
+		auto tick_l (std::max (entry_a.tick, current));
+		if (tick_l - current < slots)
+		{
+			level0[tick_l % slots].push_back (std::move (entry_a));
+		}
+		else
+		{
+			// Anything beyond the range of the second level waits in its last slot
+			auto turn (std::min (tick_l / slots, current / slots + slots - 1));
+			level1[turn % slots].push_back (std::move (entry_a));
+		}
+	}
+
+	uint64_t ticks_floor (clock::time_point time_a) const
+	{
+		return time_a > start ? (time_a - start) / tick : 0;
+	}
+
+	uint64_t ticks_ceil (clock::time_point time_a) const
+	{
+		return time_a > start ? (time_a - start + tick - clock::duration (1)) / tick : 0;
+	}
+
+	clock::duration const tick;
+	clock::time_point const start;
+	std::vector<std::vector<entry>> level0;
+	std::vector<std::vector<entry>> level1;
+	/** Next tick to be processed */
+	uint64_t current{ 0 };
+	size_t count{ 0 };
+};
+}
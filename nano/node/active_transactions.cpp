@@ -23,6 +23,7 @@ election_time_to_live (node_a.network_params.network.is_test_network () ? 0s : 1
 min_time_between_requests (node_a.network_params.network.is_test_network () ? 25ms : 3s),
 min_time_between_floods (node_a.network_params.network.is_test_network () ? 50ms : 6s),
 min_request_count_flood (node_a.network_params.network.is_test_network () ? 0 : 2),
+scheduled (std::chrono::milliseconds (node_a.network_params.network.request_interval_ms), 64),
 thread ([this]() {
 	nano::thread_role::set (nano::thread_role::name::request_loop);
 	request_loop ();
@@ -211,6 +212,8 @@ void nano::active_transactions::cemented_batch_finished_callback ()
 void nano::active_transactions::election_escalate (std::shared_ptr<nano::election> & election_l, nano::transaction const & transaction_l, size_t const & roots_size_l)
 {
 	constexpr unsigned high_confirmation_request_count{ 128 };
+	// Representative weights may have changed since the votes were counted
+	election_l->refresh_tally ();
 	// Log votes for very long unconfirmed elections
 	if (election_l->confirmation_request_count % (4 * high_confirmation_request_count) == 1)
 	{
@@ -280,8 +283,6 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 		}
 	}
 	auto const now (std::chrono::steady_clock::now ());
-	// Any new election started from process_live only gets requests after at least 1 second
-	auto cutoff_l (now - election_request_delay);
 	// Elections taking too long get escalated
 	auto long_election_cutoff_l (now - long_election_threshold);
 	// The lowest PoW difficulty elections have a maximum time to live if they are beyond the soft threshold size for the container
@@ -293,22 +294,62 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 
 	auto roots_size_l (roots.size ());
 	auto & sorted_roots_l = roots.get<tag_difficulty> ();
-	size_t count_l{ 0 };
+
+	/*
+	 * Elections extending the soft config.active_elections_size limit are flushed after a certain time-to-live cutoff, lowest difficulty first
+	 * Flushed elections are later re-activated via frontier confirmation
+	 */
+	if (roots_size_l > node.config.active_elections_size)
+	{
+		auto excess_l (roots_size_l - node.config.active_elections_size);
+		for (auto i = sorted_roots_l.rbegin (), n = sorted_roots_l.rend (); i != n && excess_l > 0; ++i, --excess_l)
+		{
+			auto election_l (i->election);
+			if (!election_l->stopped && election_l->election_start < election_ttl_cutoff_l && !node.wallets.watcher->is_watched (i->root))
+			{
+				election_l->stop ();
+				inactive_l.insert (i->root);
+				add_dropped_elections_cache (i->root);
+			}
+		}
+	}
+
+	// Only elections whose next request or broadcast is due are visited
+	std::vector<scheduled_election> scheduled_l;
+	scheduled.advance (now, scheduled_l);
+	std::vector<nano::conflict_info> due_l;
+	due_l.reserve (scheduled_l.size ());
+	for (auto const & item : scheduled_l)
+	{
+		auto election_l (item.first.lock ());
+		if (election_l != nullptr && election_l->next_action == item.second)
+		{
+			auto existing (roots.get<tag_root> ().find (election_l->status.winner->qualified_root ()));
+			if (existing != roots.get<tag_root> ().end () && existing->election == election_l)
+			{
+				due_l.push_back (*existing);
+			}
+		}
+	}
+	node.stats.inc (nano::stat::type::election, nano::stat::detail::election_tick);
+	node.stats.add (nano::stat::type::election, nano::stat::detail::election_due, nano::stat::dir::in, due_l.size ());
+	// Descending order of proof-of-work difficulty, so the highest difficulty elections get the limited requests and broadcasts
+	std::sort (due_l.begin (), due_l.end (), [](nano::conflict_info const & a, nano::conflict_info const & b) {
+		return a.adjusted_difficulty > b.adjusted_difficulty;
+	});
 
 	// Only representatives ready to receive batched confirm_req
 	solicitor.prepare (node.rep_crawler.representatives (node.network_params.protocol.tcp_realtime_protocol_version_min));
 
 	/*
-	 * Loop through active elections in descending order of proof-of-work difficulty, requesting confirmation
+	 * Loop through due elections, requesting confirmation
 	 *
 	 * Only up to a certain amount of elections are queued for confirmation request and block rebroadcasting. The remaining elections can still be confirmed if votes arrive
-	 * Elections extending the soft config.active_elections_size limit are flushed after a certain time-to-live cutoff
-	 * Flushed elections are later re-activated via frontier confirmation
 	 */
-	for (auto i = sorted_roots_l.begin (), n = sorted_roots_l.end (); i != n; ++i, ++count_l)
+	for (auto & info : due_l)
 	{
-		auto election_l (i->election);
-		auto root_l (i->root);
+		auto & election_l (info.election);
+		auto root_l (info.root);
 		if (election_l->confirmed () || (election_l->confirmation_request_count != 0 && !node.ledger.could_fit (transaction_l, *election_l->status.winner)))
 		{
 			election_l->stop ();
@@ -318,15 +359,8 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 		{
 			inactive_l.insert (root_l);
 		}
-		// Drop elections
-		else if (count_l >= node.config.active_elections_size && election_l->election_start < election_ttl_cutoff_l && !node.wallets.watcher->is_watched (root_l))
-		{
-			election_l->stop ();
-			inactive_l.insert (root_l);
-			add_dropped_elections_cache (root_l);
-		}
 		// Attempt obtaining votes
-		else if (election_l->skip_delay || election_l->election_start < cutoff_l)
+		else
 		{
 			// Broadcast the winner when elections are taking longer to confirm
 			if (election_l->confirmation_request_count >= min_request_count_flood && election_l->last_broadcast < flood_cutoff && !solicitor.broadcast (*election_l))
@@ -344,6 +378,13 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 			{
 				election_escalate (election_l, transaction_l, roots_size_l);
 			}
+			// Due again once a request or a broadcast is allowed, or on the next iteration if the solicitor had no room this time
+			auto next_l (election_l->last_request + min_time_between_requests);
+			if (election_l->confirmation_request_count >= min_request_count_flood)
+			{
+				next_l = std::min (next_l, election_l->last_broadcast + min_time_between_floods);
+			}
+			schedule (election_l, std::max (next_l, now + std::chrono::milliseconds (node.network_params.network.request_interval_ms)));
 		}
 	}
 	lock_a.unlock ();
@@ -362,6 +403,13 @@ void nano::active_transactions::request_confirm (nano::unique_lock<std::mutex> &
 	}
 }
 
+void nano::active_transactions::schedule (std::shared_ptr<nano::election> const & election_a, std::chrono::steady_clock::time_point deadline_a)
+{
+	debug_assert (!mutex.try_lock ());
+	election_a->next_action = deadline_a;
+	scheduled.insert (scheduled_election{ election_a, deadline_a }, deadline_a);
+}
+
 void nano::active_transactions::request_loop ()
 {
 	nano::unique_lock<std::mutex> lock (mutex);
@@ -585,6 +633,8 @@ std::pair<std::shared_ptr<nano::election>, bool> nano::active_transactions::inse
 				roots.get<tag_root> ().emplace (nano::conflict_info{ root, difficulty, difficulty, result.first });
 				blocks.emplace (hash, result.first);
 				adjust_difficulty (hash);
+				// Any new election started from process_live only gets requests after election_request_delay
+				schedule (result.first, skip_delay_a ? std::chrono::steady_clock::now () : result.first->election_start + election_request_delay);
 				result.first->insert_inactive_votes_cache (hash);
 			}
 		}
@@ -610,6 +660,10 @@ nano::vote_code nano::active_transactions::vote (std::shared_ptr<nano::vote> vot
 	bool at_least_one (false);
 	bool replay (false);
 	bool processed (false);
+	// Votes for hashes without an election are recorded in the inactive votes cache under the lock, so they are ordered with elections starting and stopping.
+	// Checking whether they warrant bootstrapping looks up the weight of every voter, that is done once the lock is released
+	auto principal (node.ledger.weight (vote_a->account) > node.minimum_principal_weight ());
+	std::vector<std::pair<nano::block_hash, std::vector<nano::account>>> inactive;
 	{
 		nano::lock_guard<std::mutex> lock (mutex);
 		for (auto vote_block : vote_a->blocks)
@@ -624,9 +678,13 @@ nano::vote_code nano::active_transactions::vote (std::shared_ptr<nano::vote> vot
 					at_least_one = true;
 					result = existing->second->vote (vote_a->account, vote_a->sequence, block_hash);
 				}
-				else // possibly a vote for a recently confirmed election
+				else if (principal) // possibly a vote for a recently confirmed election
 				{
-					add_inactive_votes_cache (block_hash, vote_a->account);
+					auto voters (inactive_votes_cache_insert (block_hash, vote_a->account));
+					if (voters)
+					{
+						inactive.emplace_back (block_hash, std::move (*voters));
+					}
 				}
 			}
 			else
@@ -638,15 +696,23 @@ nano::vote_code nano::active_transactions::vote (std::shared_ptr<nano::vote> vot
 					at_least_one = true;
 					result = existing->election->vote (vote_a->account, vote_a->sequence, block->hash ());
 				}
-				else
+				else if (principal)
 				{
-					add_inactive_votes_cache (block->hash (), vote_a->account);
+					auto voters (inactive_votes_cache_insert (block->hash (), vote_a->account));
+					if (voters)
+					{
+						inactive.emplace_back (block->hash (), std::move (*voters));
+					}
 				}
 			}
 			processed = processed || result.processed;
 			replay = replay || result.replay;
 		}
 	}
+	for (auto const & entry : inactive)
+	{
+		inactive_votes_cache_check (entry.first, entry.second);
+	}
 	if (at_least_one)
 	{
 		if (processed && !node.wallets.rep_counts ().have_half_rep ())
@@ -994,9 +1060,27 @@ void nano::active_transactions::add_inactive_votes_cache (nano::block_hash const
 	// Check principal representative status
 	if (node.ledger.weight (representative_a) > node.minimum_principal_weight ())
 	{
-		auto & inactive_by_hash (inactive_votes_cache.get<tag_hash> ());
-		auto existing (inactive_by_hash.find (hash_a));
-		if (existing != inactive_by_hash.end () && (!existing->confirmed || !existing->bootstrap_started))
+		boost::optional<std::vector<nano::account>> voters;
+		{
+			nano::lock_guard<std::mutex> guard (mutex);
+			voters = inactive_votes_cache_insert (hash_a, representative_a);
+		}
+		if (voters)
+		{
+			inactive_votes_cache_check (hash_a, *voters);
+		}
+	}
+}
+
+boost::optional<std::vector<nano::account>> nano::active_transactions::inactive_votes_cache_insert (nano::block_hash const & hash_a, nano::account const & representative_a)
+{
+	debug_assert (!mutex.try_lock ());
+	boost::optional<std::vector<nano::account>> result;
+	auto & inactive_by_hash (inactive_votes_cache.get<tag_hash> ());
+	auto existing (inactive_by_hash.find (hash_a));
+	if (existing != inactive_by_hash.end ())
+	{
+		if (!existing->confirmed || !existing->bootstrap_started)
 		{
 			auto is_new (false);
 			inactive_by_hash.modify (existing, [representative_a, &is_new](nano::inactive_cache_information & info) {
@@ -1008,35 +1092,42 @@ void nano::active_transactions::add_inactive_votes_cache (nano::block_hash const
 					info.voters.push_back (representative_a);
 				}
 			});
-
 			if (is_new)
 			{
-				bool confirmed (false);
-				if (inactive_votes_bootstrap_check (existing->voters, hash_a, confirmed) && !existing->bootstrap_started)
-				{
-					inactive_by_hash.modify (existing, [](nano::inactive_cache_information & info) {
-						info.bootstrap_started = true;
-					});
-				}
-				if (confirmed && !existing->confirmed)
-				{
-					inactive_by_hash.modify (existing, [](nano::inactive_cache_information & info) {
-						info.confirmed = true;
-					});
-				}
+				result = existing->voters;
 			}
 		}
-		else
+	}
+	else
+	{
+		std::vector<nano::account> representative_vector (1, representative_a);
+		auto & inactive_by_arrival (inactive_votes_cache.get<tag_arrival> ());
+		inactive_by_arrival.emplace (nano::inactive_cache_information{ std::chrono::steady_clock::now (), hash_a, representative_vector, false, false });
+		if (inactive_votes_cache.size () > inactive_votes_cache_max)
 		{
-			std::vector<nano::account> representative_vector (1, representative_a);
-			bool confirmed (false);
-			bool start_bootstrap (inactive_votes_bootstrap_check (representative_vector, hash_a, confirmed));
-			auto & inactive_by_arrival (inactive_votes_cache.get<tag_arrival> ());
-			inactive_by_arrival.emplace (nano::inactive_cache_information{ std::chrono::steady_clock::now (), hash_a, representative_vector, start_bootstrap, confirmed });
-			if (inactive_votes_cache.size () > inactive_votes_cache_max)
-			{
-				inactive_by_arrival.erase (inactive_by_arrival.begin ());
-			}
+			inactive_by_arrival.erase (inactive_by_arrival.begin ());
+		}
+		result = representative_vector;
+	}
+	return result;
+}
+
+void nano::active_transactions::inactive_votes_cache_check (nano::block_hash const & hash_a, std::vector<nano::account> const & voters_a)
+{
+	bool confirmed (false);
+	auto start_bootstrap (inactive_votes_bootstrap_check (voters_a, hash_a, confirmed));
+	if (start_bootstrap || confirmed)
+	{
+		// The entry may have been erased by an election starting or evicted meanwhile, in which case there is nothing to update
+		nano::lock_guard<std::mutex> guard (mutex);
+		auto & inactive_by_hash (inactive_votes_cache.get<tag_hash> ());
+		auto existing (inactive_by_hash.find (hash_a));
+		if (existing != inactive_by_hash.end ())
+		{
+			inactive_by_hash.modify (existing, [start_bootstrap, confirmed](nano::inactive_cache_information & info) {
+				info.bootstrap_started = info.bootstrap_started || start_bootstrap;
+				info.confirmed = info.confirmed || confirmed;
+			});
 		}
 	}
 }
@@ -1154,22 +1245,29 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (ac
 	size_t roots_count;
 	size_t blocks_count;
 	size_t confirmed_count;
+	size_t scheduled_count;
 
 	{
 		nano::lock_guard<std::mutex> guard (active_transactions.mutex);
 		roots_count = active_transactions.roots.size ();
 		blocks_count = active_transactions.blocks.size ();
 		confirmed_count = active_transactions.confirmed.size ();
+		scheduled_count = active_transactions.scheduled.size ();
 	}
 
 	auto composite = std::make_unique<container_info_composite> (name);
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "roots", roots_count, sizeof (decltype (active_transactions.roots)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "blocks", blocks_count, sizeof (decltype (active_transactions.blocks)::value_type) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "scheduled", scheduled_count, sizeof (nano::active_transactions::scheduled_election) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "election_winner_details", active_transactions.election_winner_details_size (), sizeof (decltype (active_transactions.election_winner_details)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "confirmed", confirmed_count, sizeof (decltype (active_transactions.confirmed)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "priority_wallet_cementable_frontiers_count", active_transactions.priority_wallet_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "priority_cementable_frontiers_count", active_transactions.priority_cementable_frontiers_size (), sizeof (nano::cementable_account) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "inactive_votes_cache_count", active_transactions.inactive_votes_cache_size (), sizeof (nano::gap_information) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "dropped_elections_count", active_transactions.dropped_elections_cache_size (), sizeof (nano::election_timepoint) }));
+	// Elections still referenced anywhere in the node, including by confirmation observers, and the total created since startup
+	auto constructed (nano::election::constructed.load ());
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "elections_alive", static_cast<size_t> (constructed - nano::election::destroyed.load ()), nano::determine_shared_ptr_pool_size<nano::election> () }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "elections_constructed", static_cast<size_t> (constructed), nano::determine_shared_ptr_pool_size<nano::election> () }));
 	return composite;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nano/lib/numbers.hpp>
+#include <nano/lib/timing_wheel.hpp>
 #include <nano/node/confirmation_solicitor.hpp>
 #include <nano/node/election.hpp>
 #include <nano/node/gap_cache.hpp>
@@ -15,6 +16,7 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
+#include <boost/optional.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <atomic>
@@ -153,6 +155,8 @@ private:
 	void search_frontiers (nano::transaction const &);
 	void election_escalate (std::shared_ptr<nano::election> &, nano::transaction const &, size_t const &);
 	void request_confirm (nano::unique_lock<std::mutex> &);
+	/** Registers the election to be visited by request_confirm at \p deadline_a, replacing any earlier registration */
+	void schedule (std::shared_ptr<nano::election> const &, std::chrono::steady_clock::time_point deadline_a);
 	nano::account next_frontier_account{ 0 };
 	std::chrono::steady_clock::time_point next_frontier_check{ std::chrono::steady_clock::now () };
 	nano::condition_variable condition;
@@ -172,6 +176,13 @@ private:
 	// Minimum election request count to start broadcasting blocks, as a backup to requesting confirmations
 	size_t const min_request_count_flood;
 
+	/*
+	 * Elections keyed by the time of their next confirmation request or broadcast, so each request loop iteration only visits those which are due.
+	 * Entries are not removed when an election finishes or is rescheduled, stale ones are skipped when they come up.
+	 */
+	using scheduled_election = std::pair<std::weak_ptr<nano::election>, std::chrono::steady_clock::time_point>;
+	nano::timing_wheel<scheduled_election> scheduled;
+
 	// clang-format off
 	boost::multi_index_container<nano::qualified_root,
 	mi::indexed_by<
@@ -207,6 +218,10 @@ private:
 	// clang-format on
 	static size_t constexpr inactive_votes_cache_max{ 16 * 1024 };
 	bool inactive_votes_bootstrap_check (std::vector<nano::account> const &, nano::block_hash const &, bool &);
+	/** Records the vote in the cache, returns the voters of the entry if the vote is new and bootstrapping it should be checked. Requires the mutex to be held */
+	boost::optional<std::vector<nano::account>> inactive_votes_cache_insert (nano::block_hash const &, nano::account const &);
+	/** Checks whether the voters of an entry warrant bootstrapping it. Must be called without the mutex held, it is only taken to update the entry */
+	void inactive_votes_cache_check (nano::block_hash const &, std::vector<nano::account> const &);
 	// clang-format off
 	boost::multi_index_container<nano::election_timepoint,
 	mi::indexed_by<
@@ -219,6 +234,7 @@ private:
 	boost::thread thread;
 
 	friend class confirmation_height_prioritize_frontiers_Test;
+	friend std::unique_ptr<container_info_component> collect_container_info (active_transactions &, const std::string &);
 	friend class confirmation_height_prioritize_frontiers_overwrite_Test;
 };
 
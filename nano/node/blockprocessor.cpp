@@ -1,3 +1,4 @@
+#include <nano/lib/threading.hpp>
 #include <nano/lib/timer.hpp>
 #include <nano/node/blockprocessor.hpp>
 #include <nano/node/node.hpp>
@@ -13,7 +14,11 @@ stopped (false),
 active (false),
 next_log (std::chrono::steady_clock::now ()),
 node (node_a),
-write_database_queue (write_database_queue_a)
+write_database_queue (write_database_queue_a),
+verification_thread ([this]() {
+	nano::thread_role::set (nano::thread_role::name::block_verification);
+	this->verify_loop ();
+})
 {
 }
 
@@ -30,13 +35,17 @@ void nano::block_processor::stop ()
 		stopped = true;
 	}
 	condition.notify_all ();
+	if (verification_thread.joinable ())
+	{
+		verification_thread.join ();
+	}
 }
 
 void nano::block_processor::flush ()
 {
 	node.checker.flush ();
 	nano::unique_lock<std::mutex> lock (mutex);
-	while (!stopped && (have_blocks () || active))
+	while (!stopped && (have_blocks () || active || verifying))
 	{
 		condition.wait (lock);
 	}
@@ -115,7 +124,7 @@ void nano::block_processor::process_blocks ()
 	nano::unique_lock<std::mutex> lock (mutex);
 	while (!stopped)
 	{
-		if (have_blocks ())
+		if (have_verified_blocks ())
 		{
 			active = true;
 			lock.unlock ();
@@ -149,6 +158,40 @@ bool nano::block_processor::have_blocks ()
 	return !blocks.empty () || !forced.empty () || !state_blocks.empty ();
 }
 
+bool nano::block_processor::have_verified_blocks ()
+{
+	debug_assert (!mutex.try_lock ());
+	return !blocks.empty () || !forced.empty ();
+}
+
+size_t nano::block_processor::verification_batch_size () const
+{
+	return node.flags.block_processor_verification_size != 0 ? node.flags.block_processor_verification_size : 2048 * (node.config.signature_checker_threads + 1);
+}
+
+void nano::block_processor::verify_loop ()
+{
+	auto max_verification_batch (verification_batch_size ());
+	nano::unique_lock<std::mutex> lock (mutex);
+	while (!stopped)
+	{
+		// Backpressure: verify the next batch only while the ledger stage has less than a full batch waiting
+		if (!state_blocks.empty () && blocks.size () < max_verification_batch)
+		{
+			verifying = true;
+			verify_state_blocks (lock, max_verification_batch);
+			verifying = false;
+			lock.unlock ();
+			condition.notify_all ();
+			lock.lock ();
+		}
+		else
+		{
+			condition.wait (lock);
+		}
+	}
+}
+
 void nano::block_processor::verify_state_blocks (nano::unique_lock<std::mutex> & lock_a, size_t max_count)
 {
 	debug_assert (!mutex.try_lock ());
@@ -187,12 +230,13 @@ void nano::block_processor::verify_state_blocks (nano::unique_lock<std::mutex> &
 		signatures.reserve (size);
 		std::vector<int> verifications;
 		verifications.resize (size, 0);
+		// Indices into items of the blocks not found in the signature cache
+		std::vector<size_t> unverified;
+		unverified.reserve (size);
 		for (auto i (0); i < size; ++i)
 		{
 			auto & item (items[i]);
 			hashes.push_back (item.block->hash ());
-			messages.push_back (hashes.back ().bytes.data ());
-			lengths.push_back (sizeof (decltype (hashes)::value_type));
 			nano::account account (item.block->account ());
 			if (!item.block->link ().is_zero () && node.ledger.is_epoch_link (item.block->link ()))
 			{
@@ -203,12 +247,37 @@ void nano::block_processor::verify_state_blocks (nano::unique_lock<std::mutex> &
 				account = item.account;
 			}
 			accounts.push_back (account);
-			pub_keys.push_back (accounts.back ().bytes.data ());
 			blocks_signatures.push_back (item.block->block_signature ());
-			signatures.push_back (blocks_signatures.back ().bytes.data ());
+			if (node.signature_cache.contains (hashes.back (), accounts.back (), blocks_signatures.back ()))
+			{
+				verifications[i] = 1;
+			}
+			else
+			{
+				messages.push_back (hashes.back ().bytes.data ());
+				lengths.push_back (sizeof (decltype (hashes)::value_type));
+				pub_keys.push_back (accounts.back ().bytes.data ());
+				signatures.push_back (blocks_signatures.back ().bytes.data ());
+				unverified.push_back (i);
+			}
+		}
+		node.stats.add (nano::stat::type::signature_cache, nano::stat::detail::cache_hit, nano::stat::dir::in, size - unverified.size ());
+		node.stats.add (nano::stat::type::signature_cache, nano::stat::detail::cache_miss, nano::stat::dir::in, unverified.size ());
+		if (!unverified.empty ())
+		{
+			std::vector<int> unverified_verifications (unverified.size (), 0);
+			nano::signature_check_set check = { unverified.size (), messages.data (), lengths.data (), pub_keys.data (), signatures.data (), unverified_verifications.data () };
+			node.checker.verify_coalesced (check);
+			for (auto j (0); j < unverified.size (); ++j)
+			{
+				auto index (unverified[j]);
+				verifications[index] = unverified_verifications[j];
+				if (verifications[index] == 1)
+				{
+					node.signature_cache.insert (hashes[index], accounts[index], blocks_signatures[index]);
+				}
+			}
 		}
-		nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
-		node.checker.verify (check);
 		lock_a.lock ();
 		for (auto i (0); i < size; ++i)
 		{
@@ -256,23 +325,9 @@ void nano::block_processor::verify_state_blocks (nano::unique_lock<std::mutex> &
 void nano::block_processor::process_batch (nano::unique_lock<std::mutex> & lock_a)
 {
 	nano::timer<std::chrono::milliseconds> timer_l;
-	lock_a.lock ();
-	timer_l.start ();
-	// Limit state blocks verification time
-
-	{
-		if (!state_blocks.empty ())
-		{
-			size_t max_verification_batch (node.flags.block_processor_verification_size != 0 ? node.flags.block_processor_verification_size : 2048 * (node.config.signature_checker_threads + 1));
-			while (!state_blocks.empty () && timer_l.before_deadline (std::chrono::seconds (2)))
-			{
-				verify_state_blocks (lock_a, max_verification_batch);
-			}
-		}
-	}
-	lock_a.unlock ();
+	// State block signatures are verified by verify_loop () concurrently with this write transaction
 	auto scoped_write_guard = write_database_queue.wait (nano::writer::process_batch);
-	auto transaction (node.store.tx_begin_write ({ tables::accounts, nano::tables::cached_counts, nano::tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked }, { tables::confirmation_height }));
+	auto transaction (node.store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, nano::tables::cached_counts, tables::delegators, tables::frontiers, tables::pending, tables::representation, tables::unchecked, tables::unchecked_bodies }, { tables::confirmation_height }));
 	timer_l.restart ();
 	lock_a.lock ();
 	// Processing blocks
@@ -352,11 +407,10 @@ void nano::block_processor::process_batch (nano::unique_lock<std::mutex> & lock_
 		number_of_blocks_processed++;
 		process_one (transaction, info);
 		lock_a.lock ();
-		/* Verify more state blocks if blocks deque is empty
-		 Because verification is long process, avoid large deque verification inside of write transaction */
-		if (blocks.empty () && !state_blocks.empty ())
+		if (!state_blocks.empty () && blocks.size () < verification_batch_size ())
 		{
-			verify_state_blocks (lock_a, 256 * (node.config.signature_checker_threads + 1));
+			// Wake up the verification stage, it may be waiting for the ledger stage to catch up
+			condition.notify_all ();
 		}
 	}
 	awaiting_write = false;
@@ -424,9 +478,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			}
 
 			nano::unchecked_key unchecked_key (info_a.block->previous (), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
+			if (node.unchecked.put (transaction_a, unchecked_key, info_a))
 			{
 				++node.ledger.cache.unchecked_count;
 			}
@@ -448,9 +500,7 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 			}
 
 			nano::unchecked_key unchecked_key (node.ledger.block_source (transaction_a, *(info_a.block)), hash);
-			auto exists = node.store.unchecked_exists (transaction_a, unchecked_key);
-			node.store.unchecked_put (transaction_a, unchecked_key, info_a);
-			if (!exists)
+			if (node.unchecked.put (transaction_a, unchecked_key, info_a))
 			{
 				++node.ledger.cache.unchecked_count;
 			}
@@ -547,12 +597,12 @@ nano::process_return nano::block_processor::process_one (nano::write_transaction
 
 void nano::block_processor::queue_unchecked (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a)
 {
-	auto unchecked_blocks (node.store.unchecked_get (transaction_a, hash_a));
+	auto unchecked_blocks (node.unchecked.get (transaction_a, hash_a));
 	for (auto & info : unchecked_blocks)
 	{
 		if (!node.flags.disable_block_processor_unchecked_deletion)
 		{
-			if (!node.store.unchecked_del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ())))
+			if (!node.unchecked.del (transaction_a, nano::unchecked_key (hash_a, info.block->hash ())))
 			{
 				debug_assert (node.ledger.cache.unchecked_count > 0);
 				--node.ledger.cache.unchecked_count;
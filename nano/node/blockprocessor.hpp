@@ -12,6 +12,7 @@
 
 #include <chrono>
 #include <memory>
+#include <thread>
 #include <unordered_set>
 
 namespace nano
@@ -24,6 +25,8 @@ class write_database_queue;
 /**
  * Processing blocks is a potentially long IO operation.
  * This class isolates block insertion from other operations like servicing network operations
+ * Blocks pass through two pipelined stages: state block signatures are batch verified on a dedicated thread
+ * while the previously verified batch is written to the ledger by the block processing thread.
  */
 class block_processor final
 {
@@ -41,6 +44,7 @@ public:
 	void wait_write ();
 	bool should_log (bool);
 	bool have_blocks ();
+	bool have_verified_blocks ();
 	void process_blocks ();
 	nano::process_return process_one (nano::write_transaction const &, nano::unchecked_info, const bool = false);
 	nano::process_return process_one (nano::write_transaction const &, std::shared_ptr<nano::block>, const bool = false);
@@ -51,11 +55,14 @@ public:
 private:
 	void queue_unchecked (nano::write_transaction const &, nano::block_hash const &);
 	void verify_state_blocks (nano::unique_lock<std::mutex> &, size_t = std::numeric_limits<size_t>::max ());
+	void verify_loop ();
+	size_t verification_batch_size () const;
 	void process_batch (nano::unique_lock<std::mutex> &);
 	void process_live (nano::block_hash const &, std::shared_ptr<nano::block>, const bool = false);
 	void requeue_invalid (nano::block_hash const &, nano::unchecked_info const &);
 	bool stopped;
 	bool active;
+	bool verifying{ false };
 	bool awaiting_write{ false };
 	std::chrono::steady_clock::time_point next_log;
 	std::deque<nano::unchecked_info> state_blocks;
@@ -67,7 +74,9 @@ private:
 	nano::node & node;
 	nano::write_database_queue & write_database_queue;
 	std::mutex mutex;
+	std::thread verification_thread;
 
 	friend std::unique_ptr<container_info_component> collect_container_info (block_processor & block_processor, const std::string & name);
+	friend class node_block_processor_verification_pipeline_Test;
 };
 }
@@ -892,7 +892,7 @@ void nano::bootstrap_attempt::lazy_pull_flush ()
 		{
 			auto const & pull_start (lazy_pulls.front ());
 			// Recheck if block was already processed
-			if (lazy_blocks.find (pull_start.first) == lazy_blocks.end () && !node->store.block_exists (transaction, pull_start.first))
+			if (lazy_blocks.find (pull_start.first) == lazy_blocks.end () && !node->ledger.block_or_pruned_exists (transaction, pull_start.first))
 			{
 				pulls.emplace_back (pull_start.first, pull_start.first, nano::block_hash (0), batch_count, pull_start.second);
 				++count;
@@ -920,7 +920,7 @@ bool nano::bootstrap_attempt::lazy_finished ()
 	nano::lock_guard<std::mutex> lazy_lock (lazy_mutex);
 	for (auto it (lazy_keys.begin ()), end (lazy_keys.end ()); it != end && !stopped;)
 	{
-		if (node->store.block_exists (transaction, *it))
+		if (node->ledger.block_or_pruned_exists (transaction, *it))
 		{
 			it = lazy_keys.erase (it);
 		}
@@ -1139,7 +1139,7 @@ void nano::bootstrap_attempt::lazy_block_state (std::shared_ptr<nano::block> blo
 		nano::uint128_t balance (block_l->hashables.balance.number ());
 		auto const & link (block_l->hashables.link);
 		// If link is not epoch link or 0. And if block from link is unknown
-		if (!link.is_zero () && !node->ledger.is_epoch_link (link) && lazy_blocks.find (link) == lazy_blocks.end () && !node->store.block_exists (transaction, link))
+		if (!link.is_zero () && !node->ledger.is_epoch_link (link) && lazy_blocks.find (link) == lazy_blocks.end () && !node->ledger.block_or_pruned_exists (transaction, link))
 		{
 			auto const & previous (block_l->hashables.previous);
 			// If state block previous is 0 then source block required
@@ -1148,7 +1148,7 @@ void nano::bootstrap_attempt::lazy_block_state (std::shared_ptr<nano::block> blo
 				lazy_add (link, retry_limit);
 			}
 			// In other cases previous block balance required to find out subtype of state block
-			else if (node->store.block_exists (transaction, previous))
+			else if (node->ledger.block_or_pruned_exists (transaction, previous))
 			{
 				if (node->ledger.balance (transaction, previous) <= balance)
 				{
@@ -1221,7 +1221,7 @@ void nano::bootstrap_attempt::lazy_backlog_cleanup ()
 	nano::lock_guard<std::mutex> lazy_lock (lazy_mutex);
 	for (auto it (lazy_state_backlog.begin ()), end (lazy_state_backlog.end ()); it != end && !stopped;)
 	{
-		if (node->store.block_exists (transaction, it->first))
+		if (node->ledger.block_or_pruned_exists (transaction, it->first))
 		{
 			auto next_block (it->second);
 			if (node->ledger.balance (transaction, it->first) <= next_block.balance) // balance
@@ -53,6 +53,8 @@ void nano::add_node_options (boost::program_options::options_description & descr
 	("peer_clear", "Clear online peers database dump")
 	("unchecked_clear", "Clear unchecked blocks")
 	("confirmation_height_clear", "Clear confirmation height")
+	("rebuild_delegators_index", "Rebuild the index of accounts delegating to each representative, see the enable_delegators_index node setting")
+	("rebuild_account_heights_index", "Rebuild the index of block hashes by account and height, see the enable_account_heights_index node setting")
 	("rebuild_database", "Rebuild LMDB database with vacuum for best compaction")
 	("diagnostics", "Run internal diagnostics")
 	("generate_config", boost::program_options::value<std::string> (), "Write configuration to stdout, populated with defaults suitable for this system. Pass the configuration type node or rpc. See also use_defaults.")
@@ -178,7 +180,7 @@ bool copy_database (boost::filesystem::path const & data_path, boost::program_op
 		if (vm.count ("unchecked_clear"))
 		{
 			auto transaction (node.node->store.tx_begin_write ());
-			node.node->store.unchecked_clear (transaction);
+			node.node->unchecked.clear (transaction);
 		}
 		if (vm.count ("clear_send_ids"))
 		{
@@ -421,7 +423,7 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 		if (!node.node->init_error ())
 		{
 			auto transaction (node.node->store.tx_begin_write ());
-			node.node->store.unchecked_clear (transaction);
+			node.node->unchecked.clear (transaction);
 			std::cout << "Unchecked blocks deleted" << std::endl;
 		}
 		else
@@ -463,6 +465,42 @@ std::error_code nano::handle_node_options (boost::program_options::variables_map
 			database_write_lock_error (ec);
 		}
 	}
+	else if (vm.count ("rebuild_delegators_index"))
+	{
+		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
+		auto node_flags = nano::inactive_node_flag_defaults ();
+		node_flags.read_only = false;
+		nano::inactive_node node (data_path, 24000, node_flags);
+		if (!node.node->init_error ())
+		{
+			auto transaction (node.node->store.tx_begin_write ());
+			node.node->ledger.delegators_index_build (transaction);
+			node.node->ledger.delegators_index = true;
+			std::cout << "Delegators index rebuilt" << std::endl;
+		}
+		else
+		{
+			database_write_lock_error (ec);
+		}
+	}
+	else if (vm.count ("rebuild_account_heights_index"))
+	{
+		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
+		auto node_flags = nano::inactive_node_flag_defaults ();
+		node_flags.read_only = false;
+		nano::inactive_node node (data_path, 24000, node_flags);
+		if (!node.node->init_error ())
+		{
+			auto transaction (node.node->store.tx_begin_write ());
+			node.node->ledger.account_heights_index_build (transaction);
+			node.node->ledger.account_heights_index = true;
+			std::cout << "Account heights index rebuilt" << std::endl;
+		}
+		else
+		{
+			database_write_lock_error (ec);
+		}
+	}
 	else if (vm.count ("peer_clear"))
 	{
 		boost::filesystem::path data_path = vm.count ("data_path") ? boost::filesystem::path (vm["data_path"].as<std::string> ()) : nano::working_path ();
@@ -9,6 +9,9 @@ nano::election_vote_result::election_vote_result (bool replay_a, bool processed_
 	processed = processed_a;
 }
 
+std::atomic<uint64_t> nano::election::constructed{ 0 };
+std::atomic<uint64_t> nano::election::destroyed{ 0 };
+
 nano::election::election (nano::node & node_a, std::shared_ptr<nano::block> block_a, bool const skip_delay_a, std::function<void(std::shared_ptr<nano::block>)> const & confirmation_action_a) :
 confirmation_action (confirmation_action_a),
 confirmed_m (false),
@@ -18,9 +21,15 @@ status ({ block_a, 0, std::chrono::duration_cast<std::chrono::milliseconds> (std
 skip_delay (skip_delay_a),
 stopped (false)
 {
-	last_votes.emplace (node.network_params.random.not_an_account, nano::vote_info{ std::chrono::steady_clock::now (), 0, block_a->hash () });
+	tally_vote (node.network_params.random.not_an_account, nano::vote_info{ std::chrono::steady_clock::now (), 0, block_a->hash () });
 	blocks.emplace (block_a->hash (), block_a);
 	update_dependent ();
+	++constructed;
+}
+
+nano::election::~election ()
+{
+	++destroyed;
 }
 
 void nano::election::confirm_once (nano::election_status_type type_a)
@@ -84,24 +93,69 @@ bool nano::election::have_quorum (nano::tally_t const & tally_a, nano::uint128_t
 
 nano::tally_t nano::election::tally ()
 {
-	std::unordered_map<nano::block_hash, nano::uint128_t> block_weights;
-	for (auto vote_info : last_votes)
-	{
-		block_weights[vote_info.second.hash] += node.ledger.weight (vote_info.first);
-	}
-	last_tally = block_weights;
 	nano::tally_t result;
-	for (auto item : block_weights)
+	for (auto const & item : last_tally)
 	{
 		auto block (blocks.find (item.first));
 		if (block != blocks.end ())
 		{
-			result.emplace (item.second, block->second);
+			result.emplace (item.second.weight, block->second);
 		}
 	}
 	return result;
 }
 
+void nano::election::refresh_tally ()
+{
+	last_tally.clear ();
+	for (auto & vote_info : last_votes)
+	{
+		vote_info.second.weight = node.ledger.weight (vote_info.first);
+		add_tally (vote_info.second.hash, vote_info.second.weight);
+	}
+}
+
+void nano::election::tally_vote (nano::account const & rep_a, nano::vote_info const & vote_a)
+{
+	auto existing (last_votes.find (rep_a));
+	if (existing != last_votes.end ())
+	{
+		remove_tally (existing->second.hash, existing->second.weight);
+		existing->second = vote_a;
+	}
+	else
+	{
+		last_votes.emplace (rep_a, vote_a);
+	}
+	add_tally (vote_a.hash, vote_a.weight);
+}
+
+void nano::election::add_tally (nano::block_hash const & hash_a, nano::uint128_t const & weight_a)
+{
+	auto existing (last_tally.find (hash_a));
+	if (existing != last_tally.end ())
+	{
+		existing->second.weight += weight_a;
+		++existing->second.voters;
+	}
+	else
+	{
+		last_tally.emplace (hash_a, nano::election_block_tally{ weight_a, 1 });
+	}
+}
+
+void nano::election::remove_tally (nano::block_hash const & hash_a, nano::uint128_t const & weight_a)
+{
+	auto existing (last_tally.find (hash_a));
+	debug_assert (existing != last_tally.end () && existing->second.weight >= weight_a && existing->second.voters > 0);
+	existing->second.weight -= weight_a;
+	// A block nobody votes for any more is dropped from the tally, as it would be by refresh_tally
+	if (--existing->second.voters == 0)
+	{
+		last_tally.erase (existing);
+	}
+}
+
 void nano::election::confirm_if_quorum ()
 {
 	auto tally_l (tally ());
@@ -196,7 +250,7 @@ nano::election_vote_result nano::election::vote (nano::account rep, uint64_t seq
 		if (should_process)
 		{
 			node.stats.inc (nano::stat::type::election, nano::stat::detail::vote_new);
-			last_votes[rep] = { std::chrono::steady_clock::now (), sequence, block_hash };
+			tally_vote (rep, nano::vote_info{ std::chrono::steady_clock::now (), sequence, block_hash, weight });
 			if (!confirmed ())
 			{
 				confirm_if_quorum ();
@@ -211,7 +265,8 @@ bool nano::election::publish (std::shared_ptr<nano::block> block_a)
 	auto result (false);
 	if (blocks.size () >= 10)
 	{
-		if (last_tally[block_a->hash ()] < node.online_reps.online_stake () / 10)
+		auto existing (last_tally.find (block_a->hash ()));
+		if (existing == last_tally.end () || existing->second.weight < node.online_reps.online_stake () / 10)
 		{
 			result = true;
 		}
@@ -269,10 +324,7 @@ void nano::election::update_dependent ()
 		auto existing (node.active.blocks.find (block_search));
 		if (existing != node.active.blocks.end () && !existing->second->confirmed () && !existing->second->stopped)
 		{
-			if (existing->second->dependent_blocks.find (hash) == existing->second->dependent_blocks.end ())
-			{
-				existing->second->dependent_blocks.insert (hash);
-			}
+			existing->second->dependent_blocks.insert (hash);
 		}
 	}
 }
@@ -309,9 +361,9 @@ void nano::election::insert_inactive_votes_cache (nano::block_hash const & hash_
 	auto cache (node.active.find_inactive_votes_cache (hash_a));
 	for (auto & rep : cache.voters)
 	{
-		auto inserted (last_votes.emplace (rep, nano::vote_info{ std::chrono::steady_clock::time_point::min (), 0, hash_a }));
-		if (inserted.second)
+		if (last_votes.find (rep) == last_votes.end ())
 		{
+			tally_vote (rep, nano::vote_info{ std::chrono::steady_clock::time_point::min (), 0, hash_a, node.ledger.weight (rep) });
 			node.stats.inc (nano::stat::type::election, nano::stat::detail::vote_cached);
 		}
 	}
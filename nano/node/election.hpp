@@ -4,10 +4,13 @@
 #include <nano/secure/common.hpp>
 #include <nano/secure/ledger.hpp>
 
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
+
 #include <atomic>
 #include <chrono>
 #include <memory>
-#include <unordered_set>
 
 namespace nano
 {
@@ -39,6 +42,16 @@ public:
 	std::chrono::steady_clock::time_point time;
 	uint64_t sequence;
 	nano::block_hash hash;
+	/** Weight of the representative when the vote was counted into the election tally */
+	nano::uint128_t weight{ 0 };
+};
+class election_block_tally final
+{
+public:
+	/** Sum of the weights of the votes for the block */
+	nano::uint128_t weight{ 0 };
+	/** Number of votes for the block, the entry is removed from the tally when it reaches zero */
+	size_t voters{ 0 };
 };
 class election_vote_result final
 {
@@ -48,6 +61,14 @@ public:
 	bool replay{ false };
 	bool processed{ false };
 };
+/*
+ * Almost every election holds one or two blocks, so the per block containers keep that many entries inline and are only
+ * heap allocated on forks. Voters are kept in a single sorted array rather than a node per voter.
+ */
+template <typename Value, size_t Inline>
+using election_hash_map = boost::container::flat_map<nano::block_hash, Value, std::less<nano::block_hash>, boost::container::small_vector<std::pair<nano::block_hash, Value>, Inline>>;
+using election_hash_set = boost::container::flat_set<nano::block_hash, std::less<nano::block_hash>, boost::container::small_vector<nano::block_hash, 2>>;
+using election_votes = boost::container::flat_map<nano::account, nano::vote_info>;
 class election final : public std::enable_shared_from_this<nano::election>
 {
 	std::function<void(std::shared_ptr<nano::block>)> confirmation_action;
@@ -55,8 +76,12 @@ class election final : public std::enable_shared_from_this<nano::election>
 
 public:
 	election (nano::node &, std::shared_ptr<nano::block>, bool const, std::function<void(std::shared_ptr<nano::block>)> const &);
+	~election ();
 	nano::election_vote_result vote (nano::account, uint64_t, nano::block_hash);
+	/** Returns the running tally of the blocks in this election, the representative weights are those at the time of each vote */
 	nano::tally_t tally ();
+	/** Recalculates the running tally with the current representative weights */
+	void refresh_tally ();
 	// Check if we have vote quorum
 	bool have_quorum (nano::tally_t const &, nano::uint128_t) const;
 	void confirm_once (nano::election_status_type = nano::election_status_type::active_confirmed_quorum);
@@ -72,17 +97,29 @@ public:
 	void stop ();
 	bool confirmed ();
 	nano::node & node;
-	std::unordered_map<nano::account, nano::vote_info> last_votes;
-	std::unordered_map<nano::block_hash, std::shared_ptr<nano::block>> blocks;
+	nano::election_votes last_votes;
+	nano::election_hash_map<std::shared_ptr<nano::block>, 2> blocks;
 	std::chrono::steady_clock::time_point election_start;
 	nano::election_status status;
 	bool skip_delay;
 	bool stopped;
-	std::unordered_map<nano::block_hash, nano::uint128_t> last_tally;
+	/** Sum of the weights in last_votes and number of voters for each block hash, updated as votes arrive. Only holds blocks which have a vote */
+	nano::election_hash_map<nano::election_block_tally, 2> last_tally;
 	unsigned confirmation_request_count{ 0 };
 	std::chrono::steady_clock::time_point last_broadcast;
 	std::chrono::steady_clock::time_point last_request;
-	std::unordered_set<nano::block_hash> dependent_blocks;
+	/** When this election is next due in active_transactions::request_confirm */
+	std::chrono::steady_clock::time_point next_action;
+	nano::election_hash_set dependent_blocks;
 	std::chrono::seconds late_blocks_delay{ 5 };
+	/** Number of election objects constructed and destroyed since startup */
+	static std::atomic<uint64_t> constructed;
+	static std::atomic<uint64_t> destroyed;
+
+private:
+	/** Replaces the vote of \p rep_a in last_votes and moves its weight in last_tally accordingly */
+	void tally_vote (nano::account const & rep_a, nano::vote_info const & vote_a);
+	void add_tally (nano::block_hash const &, nano::uint128_t const &);
+	void remove_tally (nano::block_hash const &, nano::uint128_t const &);
 };
 }
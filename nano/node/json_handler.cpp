@@ -773,16 +773,26 @@ void nano::json_handler::account_weight ()
 void nano::json_handler::accounts_balances ()
 {
 	boost::property_tree::ptree balances;
+	std::vector<nano::account> accounts_l;
 	for (auto & accounts : request.get_child ("accounts"))
 	{
 		auto account (account_impl (accounts.second.data ()));
 		if (!ec)
+		{
+			accounts_l.push_back (account);
+		}
+	}
+	if (!ec)
+	{
+		auto transaction (node.store.tx_begin_read ());
+		auto infos (node.store.account_get_many (transaction, accounts_l));
+		for (size_t i (0); i < accounts_l.size (); ++i)
 		{
 			boost::property_tree::ptree entry;
-			auto balance (node.balance_pending (account));
-			entry.put ("balance", balance.first.convert_to<std::string> ());
-			entry.put ("pending", balance.second.convert_to<std::string> ());
-			balances.push_back (std::make_pair (account.to_account (), entry));
+			nano::uint128_t balance (infos[i] ? infos[i]->balance.number () : 0);
+			entry.put ("balance", balance.convert_to<std::string> ());
+			entry.put ("pending", node.ledger.account_pending (transaction, accounts_l[i]).convert_to<std::string> ());
+			balances.push_back (std::make_pair (accounts_l[i].to_account (), entry));
 		}
 	}
 	response_l.add_child ("balances", balances);
@@ -818,16 +828,24 @@ void nano::json_handler::accounts_create ()
 void nano::json_handler::accounts_frontiers ()
 {
 	boost::property_tree::ptree frontiers;
-	auto transaction (node.store.tx_begin_read ());
+	std::vector<nano::account> accounts_l;
 	for (auto & accounts : request.get_child ("accounts"))
 	{
 		auto account (account_impl (accounts.second.data ()));
 		if (!ec)
 		{
-			auto latest (node.ledger.latest (transaction, account));
-			if (!latest.is_zero ())
+			accounts_l.push_back (account);
+		}
+	}
+	if (!ec)
+	{
+		auto transaction (node.store.tx_begin_read ());
+		auto infos (node.store.account_get_many (transaction, accounts_l));
+		for (size_t i (0); i < accounts_l.size (); ++i)
+		{
+			if (infos[i])
 			{
-				frontiers.put (account.to_account (), latest.to_string ());
+				frontiers.put (accounts_l[i].to_account (), infos[i]->head.to_string ());
 			}
 		}
 	}
@@ -852,7 +870,7 @@ void nano::json_handler::accounts_pending ()
 		if (!ec)
 		{
 			boost::property_tree::ptree peers_l;
-			for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+			for (auto i (node.store.pending_account_begin (transaction, account)), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
 			{
 				nano::pending_key const & key (i->first);
 				if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
@@ -964,6 +982,22 @@ void state_subtype (nano::transaction const & transaction_a, nano::node & node_a
 	}
 }
 
+/** Fills in what is known of a pruned block, returns true if \p hash_a wasn't pruned */
+bool pruned_block_info (nano::transaction const & transaction_a, nano::node & node_a, nano::block_hash const & hash_a, boost::property_tree::ptree & tree_a)
+{
+	nano::pruned_info pruned;
+	auto error (!node_a.ledger.pruning || node_a.store.pruned_get (transaction_a, hash_a, pruned));
+	if (!error)
+	{
+		tree_a.put ("block_account", pruned.account.to_account ());
+		tree_a.put ("balance", pruned.balance.to_string_dec ());
+		tree_a.put ("height", std::to_string (pruned.height));
+		tree_a.put ("confirmed", true);
+		tree_a.put ("pruned", true);
+	}
+	return error;
+}
+
 void nano::json_handler::block_info ()
 {
 	auto hash (hash_impl ());
@@ -1003,7 +1037,7 @@ void nano::json_handler::block_info ()
 				state_subtype (transaction, node, block, balance, response_l);
 			}
 		}
-		else
+		else if (pruned_block_info (transaction, node, hash, response_l))
 		{
 			ec = nano::error_blocks::not_found;
 		}
@@ -1062,41 +1096,52 @@ void nano::json_handler::blocks ()
 {
 	const bool json_block_l = request.get<bool> ("json_block", false);
 	boost::property_tree::ptree blocks;
-	auto transaction (node.store.tx_begin_read ());
+	std::vector<std::string> hash_texts;
+	std::vector<nano::block_hash> hashes_l;
+	bool bad_hash (false);
 	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
 	{
-		if (!ec)
+		if (!bad_hash)
 		{
-			std::string hash_text = hashes.second.data ();
 			nano::block_hash hash;
-			if (!hash.decode_hex (hash_text))
+			bad_hash = hash.decode_hex (hashes.second.data ());
+			if (!bad_hash)
 			{
-				auto block (node.store.block_get (transaction, hash));
-				if (block != nullptr)
-				{
-					if (json_block_l)
-					{
-						boost::property_tree::ptree block_node_l;
-						block->serialize_json (block_node_l);
-						blocks.add_child (hash_text, block_node_l);
-					}
-					else
-					{
-						std::string contents;
-						block->serialize_json (contents);
-						blocks.put (hash_text, contents);
-					}
-				}
-				else
-				{
-					ec = nano::error_blocks::not_found;
-				}
+				hash_texts.push_back (hashes.second.data ());
+				hashes_l.push_back (hash);
+			}
+		}
+	}
+	auto transaction (node.store.tx_begin_read ());
+	auto blocks_l (node.store.block_get_many (transaction, hashes_l));
+	for (size_t i (0); i < hashes_l.size () && !ec; ++i)
+	{
+		auto const & hash_text (hash_texts[i]);
+		auto const & block (blocks_l[i]);
+		if (block != nullptr)
+		{
+			if (json_block_l)
+			{
+				boost::property_tree::ptree block_node_l;
+				block->serialize_json (block_node_l);
+				blocks.add_child (hash_text, block_node_l);
 			}
 			else
 			{
-				ec = nano::error_blocks::bad_hash_number;
+				std::string contents;
+				block->serialize_json (contents);
+				blocks.put (hash_text, contents);
 			}
 		}
+		else
+		{
+			ec = nano::error_blocks::not_found;
+		}
+	}
+	// Blocks are fetched together, an invalid hash is only reported if every hash before it was found
+	if (!ec && bad_hash)
+	{
+		ec = nano::error_blocks::bad_hash_number;
 	}
 	response_l.add_child ("blocks", blocks);
 	response_errors ();
@@ -1111,90 +1156,109 @@ void nano::json_handler::blocks_info ()
 
 	boost::property_tree::ptree blocks;
 	boost::property_tree::ptree blocks_not_found;
-	auto transaction (node.store.tx_begin_read ());
+	std::vector<std::string> hash_texts;
+	std::vector<nano::block_hash> hashes_l;
+	bool bad_hash (false);
 	for (boost::property_tree::ptree::value_type & hashes : request.get_child ("hashes"))
 	{
-		if (!ec)
+		if (!bad_hash)
 		{
-			std::string hash_text = hashes.second.data ();
 			nano::block_hash hash;
-			if (!hash.decode_hex (hash_text))
+			bad_hash = hash.decode_hex (hashes.second.data ());
+			if (!bad_hash)
 			{
-				nano::block_sideband sideband;
-				auto block (node.store.block_get (transaction, hash, &sideband));
-				if (block != nullptr)
-				{
-					boost::property_tree::ptree entry;
-					nano::account account (block->account ().is_zero () ? sideband.account : block->account ());
-					entry.put ("block_account", account.to_account ());
-					auto amount (node.ledger.amount (transaction, hash));
-					entry.put ("amount", amount.convert_to<std::string> ());
-					auto balance (node.ledger.balance (transaction, hash));
-					entry.put ("balance", balance.convert_to<std::string> ());
-					entry.put ("height", std::to_string (sideband.height));
-					entry.put ("local_timestamp", std::to_string (sideband.timestamp));
-					auto confirmed (node.ledger.block_confirmed (transaction, hash));
-					entry.put ("confirmed", confirmed);
+				hash_texts.push_back (hashes.second.data ());
+				hashes_l.push_back (hash);
+			}
+		}
+	}
+	auto transaction (node.store.tx_begin_read ());
+	std::vector<nano::block_sideband> sidebands;
+	auto blocks_l (node.store.block_get_many (transaction, hashes_l, &sidebands));
+	for (size_t i (0); i < hashes_l.size () && !ec; ++i)
+	{
+		auto const & hash_text (hash_texts[i]);
+		auto const & hash (hashes_l[i]);
+		auto const & block (blocks_l[i]);
+		auto const & sideband (sidebands[i]);
+		if (block != nullptr)
+		{
+			boost::property_tree::ptree entry;
+			nano::account account (block->account ().is_zero () ? sideband.account : block->account ());
+			entry.put ("block_account", account.to_account ());
+			auto amount (node.ledger.amount (transaction, hash));
+			entry.put ("amount", amount.convert_to<std::string> ());
+			auto balance (node.ledger.balance (transaction, hash));
+			entry.put ("balance", balance.convert_to<std::string> ());
+			entry.put ("height", std::to_string (sideband.height));
+			entry.put ("local_timestamp", std::to_string (sideband.timestamp));
+			auto confirmed (node.ledger.block_confirmed (transaction, hash));
+			entry.put ("confirmed", confirmed);
 
-					if (json_block_l)
-					{
-						boost::property_tree::ptree block_node_l;
-						block->serialize_json (block_node_l);
-						entry.add_child ("contents", block_node_l);
-					}
-					else
-					{
-						std::string contents;
-						block->serialize_json (contents);
-						entry.put ("contents", contents);
-					}
-					if (block->type () == nano::block_type::state)
-					{
-						state_subtype (transaction, node, block, balance, entry);
-					}
-					if (pending)
-					{
-						bool exists (false);
-						auto destination (node.ledger.block_destination (transaction, *block));
-						if (!destination.is_zero ())
-						{
-							exists = node.store.pending_exists (transaction, nano::pending_key (destination, hash));
-						}
-						entry.put ("pending", exists ? "1" : "0");
-					}
-					if (source)
-					{
-						nano::block_hash source_hash (node.ledger.block_source (transaction, *block));
-						auto block_a (node.store.block_get (transaction, source_hash));
-						if (block_a != nullptr)
-						{
-							auto source_account (node.ledger.account (transaction, source_hash));
-							entry.put ("source_account", source_account.to_account ());
-						}
-						else
-						{
-							entry.put ("source_account", "0");
-						}
-					}
-					blocks.push_back (std::make_pair (hash_text, entry));
+			if (json_block_l)
+			{
+				boost::property_tree::ptree block_node_l;
+				block->serialize_json (block_node_l);
+				entry.add_child ("contents", block_node_l);
+			}
+			else
+			{
+				std::string contents;
+				block->serialize_json (contents);
+				entry.put ("contents", contents);
+			}
+			if (block->type () == nano::block_type::state)
+			{
+				state_subtype (transaction, node, block, balance, entry);
+			}
+			if (pending)
+			{
+				bool exists (false);
+				auto destination (node.ledger.block_destination (transaction, *block));
+				if (!destination.is_zero ())
+				{
+					exists = node.store.pending_exists (transaction, nano::pending_key (destination, hash));
 				}
-				else if (include_not_found)
+				entry.put ("pending", exists ? "1" : "0");
+			}
+			if (source)
+			{
+				nano::block_hash source_hash (node.ledger.block_source (transaction, *block));
+				auto block_a (node.store.block_get (transaction, source_hash));
+				if (block_a != nullptr)
 				{
-					boost::property_tree::ptree entry;
-					entry.put ("", hash_text);
-					blocks_not_found.push_back (std::make_pair ("", entry));
+					auto source_account (node.ledger.account (transaction, source_hash));
+					entry.put ("source_account", source_account.to_account ());
 				}
 				else
 				{
-					ec = nano::error_blocks::not_found;
+					entry.put ("source_account", "0");
 				}
 			}
-			else
-			{
-				ec = nano::error_blocks::bad_hash_number;
-			}
+			blocks.push_back (std::make_pair (hash_text, entry));
+		}
+		else if (node.ledger.pruning && node.store.pruned_exists (transaction, hash))
+		{
+			boost::property_tree::ptree entry;
+			pruned_block_info (transaction, node, hash, entry);
+			blocks.push_back (std::make_pair (hash_text, entry));
+		}
+		else if (include_not_found)
+		{
+			boost::property_tree::ptree entry;
+			entry.put ("", hash_text);
+			blocks_not_found.push_back (std::make_pair ("", entry));
+		}
+		else
+		{
+			ec = nano::error_blocks::not_found;
 		}
 	}
+	// Blocks are fetched together, an invalid hash is only reported if every hash before it was found
+	if (!ec && bad_hash)
+	{
+		ec = nano::error_blocks::bad_hash_number;
+	}
 	if (!ec)
 	{
 		response_l.add_child ("blocks", blocks);
@@ -1212,11 +1276,16 @@ void nano::json_handler::block_account ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_read ());
+		nano::pruned_info pruned;
 		if (node.store.block_exists (transaction, hash))
 		{
 			auto account (node.ledger.account (transaction, hash));
 			response_l.put ("account", account.to_account ());
 		}
+		else if (node.ledger.pruning && !node.store.pruned_get (transaction, hash, pruned))
+		{
+			response_l.put ("account", pruned.account.to_account ());
+		}
 		else
 		{
 			ec = nano::error_blocks::not_found;
@@ -1231,6 +1300,10 @@ void nano::json_handler::block_count ()
 	response_l.put ("count", std::to_string (node.store.block_count (transaction).sum ()));
 	response_l.put ("unchecked", std::to_string (node.ledger.cache.unchecked_count));
 	response_l.put ("cemented", std::to_string (node.ledger.cache.cemented_count));
+	if (node.ledger.pruning)
+	{
+		response_l.put ("pruned", std::to_string (node.ledger.cache.pruned_count));
+	}
 	response_errors ();
 }
 
@@ -1727,6 +1800,17 @@ void nano::json_handler::chain (bool successors)
 	{
 		boost::property_tree::ptree blocks;
 		auto transaction (node.store.tx_begin_read ());
+		if (offset > 0 && node.ledger.account_heights_index)
+		{
+			// Seek directly to the first block past the offset instead of walking the chain
+			nano::block_sideband sideband;
+			if (node.store.block_get (transaction, hash, &sideband) != nullptr)
+			{
+				auto height (successors ? sideband.height + offset : (sideband.height > offset ? sideband.height - offset : 0));
+				hash = height > 0 ? node.store.account_height_get (transaction, node.ledger.account (transaction, hash), height) : nano::block_hash (0);
+				offset = 0;
+			}
+		}
 		while (!hash.is_zero () && blocks.size () < count)
 		{
 			auto block_l (node.store.block_get (transaction, hash));
@@ -1987,15 +2071,36 @@ void nano::json_handler::delegators ()
 	{
 		boost::property_tree::ptree delegators;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+		if (node.ledger.delegators_index)
 		{
-			nano::account_info const & info (i->second);
-			if (info.representative == account)
+			std::vector<nano::account> accounts;
+			for (auto i (node.store.delegators_begin (transaction, account)), n (node.store.delegators_end ()); i != n && i->first.representative == account; ++i)
 			{
-				std::string balance;
-				nano::uint128_union (info.balance).encode_dec (balance);
-				nano::account const & account (i->first);
-				delegators.put (account.to_account (), balance);
+				accounts.push_back (i->first.account);
+			}
+			auto infos (node.store.account_get_many (transaction, accounts));
+			for (size_t i (0); i < accounts.size (); ++i)
+			{
+				if (infos[i])
+				{
+					std::string balance;
+					nano::uint128_union (infos[i]->balance).encode_dec (balance);
+					delegators.put (accounts[i].to_account (), balance);
+				}
+			}
+		}
+		else
+		{
+			for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+			{
+				nano::account_info const & info (i->second);
+				if (info.representative == account)
+				{
+					std::string balance;
+					nano::uint128_union (info.balance).encode_dec (balance);
+					nano::account const & account (i->first);
+					delegators.put (account.to_account (), balance);
+				}
 			}
 		}
 		response_l.add_child ("delegators", delegators);
@@ -2010,14 +2115,24 @@ void nano::json_handler::delegators_count ()
 	{
 		uint64_t count (0);
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+		if (node.ledger.delegators_index)
 		{
-			nano::account_info const & info (i->second);
-			if (info.representative == account)
+			for (auto i (node.store.delegators_begin (transaction, account)), n (node.store.delegators_end ()); i != n && i->first.representative == account; ++i)
 			{
 				++count;
 			}
 		}
+		else
+		{
+			for (auto i (node.store.latest_begin (transaction)), n (node.store.latest_end ()); i != n; ++i)
+			{
+				nano::account_info const & info (i->second);
+				if (info.representative == account)
+				{
+					++count;
+				}
+			}
+		}
 		response_l.put ("count", std::to_string (count));
 	}
 	response_errors ();
@@ -2560,6 +2675,14 @@ void nano::json_handler::account_history ()
 		response_l.put ("account", account.to_account ());
 		nano::block_sideband sideband;
 		auto block (node.store.block_get (transaction, hash, &sideband));
+		if (offset > 0 && block != nullptr && node.ledger.account_heights_index)
+		{
+			// Seek directly to the first block past the offset instead of walking the chain
+			auto height (reverse ? sideband.height + offset : (sideband.height > offset ? sideband.height - offset : 0));
+			hash = height > 0 ? node.store.account_height_get (transaction, account, height) : nano::block_hash (0);
+			block = node.store.block_get (transaction, hash, &sideband);
+			offset = 0;
+		}
 		while (block != nullptr && count > 0)
 		{
 			if (offset > 0)
@@ -2932,7 +3055,7 @@ void nano::json_handler::pending ()
 	{
 		boost::property_tree::ptree peers_l;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.pending_begin (transaction, nano::pending_key (account, 0))), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
+		for (auto i (node.store.pending_account_begin (transaction, account)), n (node.store.pending_end ()); i != n && nano::pending_key (i->first).account == account && peers_l.size () < count; ++i)
 		{
 			nano::pending_key const & key (i->first);
 			if (block_confirmed (node, transaction, key.hash, include_active, include_only_confirmed))
@@ -4071,22 +4194,24 @@ void nano::json_handler::unchecked ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
-			nano::unchecked_info const & info (i->second);
-			if (json_block_l)
+		node.unchecked.for_each (transaction, nano::unchecked_key (0, 0), [&unchecked, count, json_block_l](nano::unchecked_key const &, nano::unchecked_info const & info) {
+			if (unchecked.size () < count)
 			{
-				boost::property_tree::ptree block_node_l;
-				info.block->serialize_json (block_node_l);
-				unchecked.add_child (info.block->hash ().to_string (), block_node_l);
-			}
-			else
-			{
-				std::string contents;
-				info.block->serialize_json (contents);
-				unchecked.put (info.block->hash ().to_string (), contents);
+				if (json_block_l)
+				{
+					boost::property_tree::ptree block_node_l;
+					info.block->serialize_json (block_node_l);
+					unchecked.add_child (info.block->hash ().to_string (), block_node_l);
+				}
+				else
+				{
+					std::string contents;
+					info.block->serialize_json (contents);
+					unchecked.put (info.block->hash ().to_string (), contents);
+				}
 			}
-		}
+			return unchecked.size () < count;
+		});
 		response_l.add_child ("blocks", unchecked);
 	}
 	response_errors ();
@@ -4096,8 +4221,8 @@ void nano::json_handler::unchecked_clear ()
 {
 	auto rpc_l (shared_from_this ());
 	node.worker.push_task ([rpc_l]() {
-		auto transaction (rpc_l->node.store.tx_begin_write ({ tables::unchecked }));
-		rpc_l->node.store.unchecked_clear (transaction);
+		auto transaction (rpc_l->node.store.tx_begin_write ({ tables::unchecked, tables::unchecked_bodies }));
+		rpc_l->node.unchecked.clear (transaction);
 		rpc_l->node.ledger.cache.unchecked_count = 0;
 		rpc_l->response_l.put ("success", "");
 		rpc_l->response_errors ();
@@ -4111,12 +4236,10 @@ void nano::json_handler::unchecked_get ()
 	if (!ec)
 	{
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction)), n (node.store.unchecked_end ()); i != n; ++i)
-		{
-			nano::unchecked_key const & key (i->first);
-			if (key.hash == hash)
+		node.unchecked.for_each (transaction, nano::unchecked_key (0, 0), [this, &hash, json_block_l](nano::unchecked_key const & key, nano::unchecked_info const & info) {
+			auto found (key.hash == hash);
+			if (found)
 			{
-				nano::unchecked_info const & info (i->second);
 				response_l.put ("modified_timestamp", std::to_string (info.modified));
 
 				if (json_block_l)
@@ -4131,9 +4254,9 @@ void nano::json_handler::unchecked_get ()
 					info.block->serialize_json (contents);
 					response_l.put ("contents", contents);
 				}
-				break;
 			}
-		}
+			return !found;
+		});
 		if (response_l.empty ())
 		{
 			ec = nano::error_blocks::not_found;
@@ -4159,27 +4282,29 @@ void nano::json_handler::unchecked_keys ()
 	{
 		boost::property_tree::ptree unchecked;
 		auto transaction (node.store.tx_begin_read ());
-		for (auto i (node.store.unchecked_begin (transaction, nano::unchecked_key (key, 0))), n (node.store.unchecked_end ()); i != n && unchecked.size () < count; ++i)
-		{
-			boost::property_tree::ptree entry;
-			nano::unchecked_info const & info (i->second);
-			entry.put ("key", i->first.key ().to_string ());
-			entry.put ("hash", info.block->hash ().to_string ());
-			entry.put ("modified_timestamp", std::to_string (info.modified));
-			if (json_block_l)
+		node.unchecked.for_each (transaction, nano::unchecked_key (key, 0), [&unchecked, count, json_block_l](nano::unchecked_key const & unchecked_key, nano::unchecked_info const & info) {
+			if (unchecked.size () < count)
 			{
-				boost::property_tree::ptree block_node_l;
-				info.block->serialize_json (block_node_l);
-				entry.add_child ("contents", block_node_l);
-			}
-			else
-			{
-				std::string contents;
-				info.block->serialize_json (contents);
-				entry.put ("contents", contents);
+				boost::property_tree::ptree entry;
+				entry.put ("key", unchecked_key.key ().to_string ());
+				entry.put ("hash", info.block->hash ().to_string ());
+				entry.put ("modified_timestamp", std::to_string (info.modified));
+				if (json_block_l)
+				{
+					boost::property_tree::ptree block_node_l;
+					info.block->serialize_json (block_node_l);
+					entry.add_child ("contents", block_node_l);
+				}
+				else
+				{
+					std::string contents;
+					info.block->serialize_json (contents);
+					entry.put ("contents", contents);
+				}
+				unchecked.push_back (std::make_pair ("", entry));
 			}
-			unchecked.push_back (std::make_pair ("", entry));
-		}
+			return unchecked.size () < count;
+		});
 		response_l.add_child ("unchecked", unchecked);
 	}
 	response_errors ();
@@ -4717,7 +4842,7 @@ void nano::json_handler::wallet_pending ()
 		{
 			nano::account const & account (i->first);
 			boost::property_tree::ptree peers_l;
-			for (auto ii (node.store.pending_begin (block_transaction, nano::pending_key (account, 0))), nn (node.store.pending_end ()); ii != nn && nano::pending_key (ii->first).account == account && peers_l.size () < count; ++ii)
+			for (auto ii (node.store.pending_account_begin (block_transaction, account)), nn (node.store.pending_end ()); ii != nn && nano::pending_key (ii->first).account == account && peers_l.size () < count; ++ii)
 			{
 				nano::pending_key key (ii->first);
 				if (block_confirmed (node, block_transaction, key.hash, include_active, include_only_confirmed))
@@ -40,9 +40,10 @@ void mdb_val::convert_buffer_to_value ()
 }
 }
 
-nano::mdb_store::mdb_store (nano::logger_mt & logger_a, boost::filesystem::path const & path_a, nano::txn_tracking_config const & txn_tracking_config_a, std::chrono::milliseconds block_processor_batch_max_time_a, int lmdb_max_dbs, size_t const batch_size, bool backup_before_upgrade) :
+nano::mdb_store::mdb_store (nano::logger_mt & logger_a, boost::filesystem::path const & path_a, nano::txn_tracking_config const & txn_tracking_config_a, std::chrono::milliseconds block_processor_batch_max_time_a, int lmdb_max_dbs, size_t const batch_size, bool backup_before_upgrade, nano::stat * stats_a) :
 logger (logger_a),
 env (error, path_a, lmdb_max_dbs, true),
+read_txn_pool (stats_a),
 mdb_txn_tracker (logger_a, txn_tracking_config_a, block_processor_batch_max_time_a),
 txn_tracking_enabled (txn_tracking_config_a.enable)
 {
@@ -51,12 +52,15 @@ txn_tracking_enabled (txn_tracking_config_a.enable)
 		auto is_fully_upgraded (false);
 		auto is_fresh_db (false);
 		{
-			auto transaction (tx_begin_read ());
+			// Transactions opening databases are not pooled as they must commit for the handles to be visible to other transactions
+			auto transaction (env.tx_begin_read ());
 			auto err = mdb_dbi_open (env.tx (transaction), "meta", 0, &meta);
 			is_fresh_db = err != MDB_SUCCESS;
 			if (err == MDB_SUCCESS)
 			{
-				is_fully_upgraded = (version_get (transaction) == version);
+				// Which databases are opened depends on the version, so it is known before opening them on either path
+				cached_version = version_get (transaction);
+				is_fully_upgraded = (cached_version == version);
 				mdb_dbi_close (env, meta);
 			}
 		}
@@ -97,7 +101,7 @@ txn_tracking_enabled (txn_tracking_config_a.enable)
 		}
 		else
 		{
-			auto transaction (tx_begin_read ());
+			auto transaction (env.tx_begin_read ());
 			open_databases (error, transaction, 0);
 		}
 	}
@@ -112,6 +116,7 @@ bool nano::mdb_store::vacuum_after_upgrade (boost::filesystem::path const & path
 	if (vacuum_success)
 	{
 		// Need to close the database to release the file handle
+		read_txn_pool.clear ();
 		mdb_env_close (env.environment);
 		env.environment = nullptr;
 
@@ -122,7 +127,7 @@ bool nano::mdb_store::vacuum_after_upgrade (boost::filesystem::path const & path
 		env.init (error, path_a, lmdb_max_dbs, true);
 		if (!error)
 		{
-			auto transaction (tx_begin_read ());
+			auto transaction (env.tx_begin_read ());
 			open_databases (error, transaction, 0);
 		}
 	}
@@ -146,7 +151,7 @@ nano::write_transaction nano::mdb_store::tx_begin_write (std::vector<nano::table
 
 nano::read_transaction nano::mdb_store::tx_begin_read ()
 {
-	return env.tx_begin_read (create_txn_callbacks ());
+	return env.tx_begin_read (create_txn_callbacks (), &read_txn_pool);
 }
 
 std::string nano::mdb_store::vendor_get () const
@@ -172,17 +177,18 @@ nano::mdb_txn_callbacks nano::mdb_store::create_txn_callbacks ()
 void nano::mdb_store::open_databases (bool & error_a, nano::transaction const & transaction_a, unsigned flags)
 {
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "frontiers", flags, &frontiers) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "send", flags, &send_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "receive", flags, &receive_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "open", flags, &open_blocks) != 0;
-	error_a |= mdb_dbi_open (env.tx (transaction_a), "change", flags, &change_blocks) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "blocks", flags, &blocks) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "unchecked", flags, &unchecked) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "vote", flags, &vote) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "online_weight", flags, &online_weight) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "meta", flags, &meta) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "peers", flags, &peers) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "delegators", flags, &delegators) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "account_heights", flags, &account_heights) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "unchecked_bodies", flags, &unchecked_bodies) != 0;
+	error_a |= mdb_dbi_open (env.tx (transaction_a), "pruned", flags, &pruned) != 0;
 	error_a |= mdb_dbi_open (env.tx (transaction_a), "confirmation_height", flags, &confirmation_height) != 0;
-	if (!full_sideband (transaction_a))
+	if (!full_sideband ())
 	{
 		// The blocks_info database is no longer used, but need opening so that it can be deleted during an upgrade
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "blocks_info", flags, &blocks_info) != 0;
@@ -198,19 +204,27 @@ void nano::mdb_store::open_databases (bool & error_a, nano::transaction const &
 		error_a |= mdb_dbi_open (env.tx (transaction_a), "representation", flags, &representation) != 0;
 	}
 
-	if (version_get (transaction_a) < 15)
+	if (version_get (transaction_a) < 19)
 	{
-		// These databases are no longer used, but need opening so they can be deleted during an upgrade
-		error_a |= mdb_dbi_open (env.tx (transaction_a), "state", flags, &state_blocks_v0) != 0;
-		state_blocks = state_blocks_v0;
-		error_a |= mdb_dbi_open (env.tx (transaction_a), "accounts_v1", flags, &accounts_v1) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction_a), "pending_v1", flags, &pending_v1) != 0;
-		error_a |= mdb_dbi_open (env.tx (transaction_a), "state_v1", flags, &state_blocks_v1) != 0;
-	}
-	else
-	{
-		error_a |= mdb_dbi_open (env.tx (transaction_a), "state_blocks", flags, &state_blocks) != 0;
-		state_blocks_v0 = state_blocks;
+		// The per type block databases are no longer used, but need opening so they can be merged into blocks during an upgrade
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "send", flags, &send_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "receive", flags, &receive_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "open", flags, &open_blocks) != 0;
+		error_a |= mdb_dbi_open (env.tx (transaction_a), "change", flags, &change_blocks) != 0;
+		if (version_get (transaction_a) < 15)
+		{
+			// These databases are no longer used, but need opening so they can be deleted during an upgrade
+			error_a |= mdb_dbi_open (env.tx (transaction_a), "state", flags, &state_blocks_v0) != 0;
+			state_blocks = state_blocks_v0;
+			error_a |= mdb_dbi_open (env.tx (transaction_a), "accounts_v1", flags, &accounts_v1) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction_a), "pending_v1", flags, &pending_v1) != 0;
+			error_a |= mdb_dbi_open (env.tx (transaction_a), "state_v1", flags, &state_blocks_v1) != 0;
+		}
+		else
+		{
+			error_a |= mdb_dbi_open (env.tx (transaction_a), "state_blocks", flags, &state_blocks) != 0;
+			state_blocks_v0 = state_blocks;
+		}
 	}
 }
 
@@ -218,6 +232,7 @@ bool nano::mdb_store::do_upgrades (nano::write_transaction & transaction_a, bool
 {
 	auto error (false);
 	auto version_l = version_get (transaction_a);
+	cached_version = version_l;
 	switch (version_l)
 	{
 		case 1:
@@ -257,6 +272,17 @@ bool nano::mdb_store::do_upgrades (nano::write_transaction & transaction_a, bool
 			upgrade_v17_to_v18 (transaction_a);
 			needs_vacuuming = true;
 		case 18:
+			upgrade_v18_to_v19 (transaction_a);
+			needs_vacuuming = true;
+		case 19:
+			upgrade_v19_to_v20 (transaction_a);
+		case 20:
+			upgrade_v20_to_v21 (transaction_a);
+		case 21:
+			upgrade_v21_to_v22 (transaction_a);
+		case 22:
+			upgrade_v22_to_v23 (transaction_a);
+		case 23:
 			break;
 		default:
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
@@ -703,98 +729,74 @@ void nano::mdb_store::upgrade_v15_to_v16 (nano::write_transaction const & transa
 	version_put (transaction_a, 16);
 }
 
-void nano::mdb_store::upgrade_v16_to_v17 (nano::write_transaction const & transaction_a)
+void nano::mdb_store::upgrade_v16_to_v17 (nano::write_transaction & transaction_a)
 {
 	logger.always_log ("Preparing v16 to v17 database upgrade...");
 
-	auto account_info_i = latest_begin (transaction_a);
-	auto account_info_n = latest_end ();
-
 	// Set the confirmed frontier for each account in the confirmation height table
-	std::vector<std::pair<nano::account, nano::confirmation_height_info>> confirmation_height_infos;
-	auto num = 0u;
-	for (nano::mdb_iterator<nano::account, uint64_t> i (transaction_a, confirmation_height), n (nano::mdb_iterator<nano::account, uint64_t>{}); i != n; ++i, ++account_info_i, ++num)
-	{
-		nano::account account (i->first);
-		uint64_t confirmation_height (i->second);
-
-		// Check account hashes matches both the accounts table and confirmation height table
-		debug_assert (account == account_info_i->first);
-
-		auto const & account_info = account_info_i->second;
-
-		if (confirmation_height == 0)
-		{
-			confirmation_height_infos.emplace_back (account, confirmation_height_info{ 0, nano::block_hash (0) });
-		}
-		else
+	upgrade_entries (transaction_a, confirmation_height, confirmation_height, 0, 17, [this](nano::transaction const & transaction_l, nano::mdb_val const & key_a, nano::mdb_val const & value_a) {
+		nano::account account (key_a);
+		auto confirmation_height (static_cast<uint64_t> (value_a));
+		nano::confirmation_height_info confirmation_height_info (0, nano::block_hash (0));
+		if (confirmation_height != 0)
 		{
-			if (account_info_i->second.block_count / 2 >= confirmation_height)
+			nano::account_info account_info;
+			auto error (account_get (transaction_l, account, account_info));
+			(void)error;
+			debug_assert (!error);
+			if (account_info.block_count / 2 >= confirmation_height)
 			{
 				// The confirmation height of the account is closer to the bottom of the chain, so start there and work up
 				nano::block_sideband sideband;
-				auto block = block_get (transaction_a, account_info.open_block, &sideband);
+				auto block = block_get (transaction_l, account_info.open_block, &sideband);
 				debug_assert (block);
 				auto height = 1;
 
 				while (height != confirmation_height)
 				{
-					block = block_get (transaction_a, sideband.successor, &sideband);
+					block = block_get (transaction_l, sideband.successor, &sideband);
 					debug_assert (block);
 					++height;
 				}
 
 				debug_assert (sideband.height == confirmation_height);
-				confirmation_height_infos.emplace_back (account, confirmation_height_info{ confirmation_height, block->hash () });
+				confirmation_height_info = nano::confirmation_height_info{ confirmation_height, block->hash () };
 			}
 			else
 			{
 				// The confirmation height of the account is closer to the top of the chain so start there and work down
 				nano::block_sideband sideband;
-				auto block = block_get (transaction_a, account_info.head, &sideband);
+				auto block = block_get (transaction_l, account_info.head, &sideband);
 				auto height = sideband.height;
 				while (height != confirmation_height)
 				{
-					block = block_get (transaction_a, block->previous ());
+					block = block_get (transaction_l, block->previous ());
 					debug_assert (block);
 					--height;
 				}
-				confirmation_height_infos.emplace_back (account, confirmation_height_info{ confirmation_height, block->hash () });
+				confirmation_height_info = nano::confirmation_height_info{ confirmation_height, block->hash () };
 			}
 		}
-
-		// Every so often output to the log to indicate progress (every 200k accounts)
-		constexpr auto output_cutoff = 200000;
-		if (num % output_cutoff == 0 && num != 0)
+		std::vector<uint8_t> result;
 		{
-			logger.always_log (boost::str (boost::format ("Confirmation height frontier set for %1%00k accounts") % ((num / output_cutoff) * 2)));
+			nano::vectorstream stream (result);
+			confirmation_height_info.serialize (stream);
 		}
-	}
-
-	// Clear it then append
-	auto status (mdb_drop (env.tx (transaction_a), confirmation_height, 0));
-	release_assert (status == MDB_SUCCESS);
-
-	for (auto const & confirmation_height_info_pair : confirmation_height_infos)
-	{
-		mdb_put (env.tx (transaction_a), confirmation_height, nano::mdb_val (confirmation_height_info_pair.first), nano::mdb_val (confirmation_height_info_pair.second), MDB_APPEND);
-	}
+		return result;
+	});
 
 	version_put (transaction_a, 17);
 	logger.always_log ("Finished upgrading confirmation height frontiers");
 }
 
-void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transaction_a)
+void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction & transaction_a)
 {
 	logger.always_log ("Preparing v17 to v18 database upgrade...");
 
 	auto count_pre (count (transaction_a, state_blocks));
 
-	nano::network_params network_params;
-	auto num = 0u;
-	for (nano::mdb_iterator<nano::block_hash, nano::state_block_w_sideband> state_i (transaction_a, state_blocks), state_n{}; state_i != state_n; ++state_i, ++num)
-	{
-		nano::state_block_w_sideband block_sideband (state_i->second);
+	upgrade_entries (transaction_a, state_blocks, state_blocks, 0, 18, [this](nano::transaction const & transaction_l, nano::mdb_val const &, nano::mdb_val const & value_a) {
+		nano::state_block_w_sideband block_sideband (value_a);
 		auto & block (block_sideband.state_block);
 		auto & sideband (block_sideband.sideband);
 
@@ -805,7 +807,7 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 		nano::amount prev_balance (0);
 		if (!block->hashables.previous.is_zero ())
 		{
-			prev_balance = block_balance (transaction_a, block->hashables.previous);
+			prev_balance = block_balance (transaction_l, block->hashables.previous);
 		}
 		if (block->hashables.balance == prev_balance && network_params.ledger.epochs.is_epoch_link (block->hashables.link))
 		{
@@ -821,24 +823,14 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 		}
 
 		nano::block_sideband new_sideband (sideband.type, sideband.account, sideband.successor, sideband.balance, sideband.height, sideband.timestamp, sideband.details.epoch, is_send, is_receive, is_epoch);
-		// Write these out
-		std::vector<uint8_t> data;
+		std::vector<uint8_t> result;
 		{
-			nano::vectorstream stream (data);
+			nano::vectorstream stream (result);
 			block->serialize (stream);
 			new_sideband.serialize (stream);
 		}
-		nano::mdb_val value{ data.size (), (void *)data.data () };
-		auto s = mdb_cursor_put (state_i.cursor, state_i->first, value, MDB_CURRENT);
-		release_assert (success (s));
-
-		// Every so often output to the log to indicate progress
-		constexpr auto output_cutoff = 1000000;
-		if (num > 0 && num % output_cutoff == 0)
-		{
-			logger.always_log (boost::str (boost::format ("Database sideband upgrade %1% million state blocks upgraded (out of %2%)") % (num / output_cutoff) % count_pre));
-		}
-	}
+		return result;
+	});
 
 	auto count_post (count (transaction_a, state_blocks));
 	release_assert (count_pre == count_post);
@@ -847,6 +839,180 @@ void nano::mdb_store::upgrade_v17_to_v18 (nano::write_transaction const & transa
 	logger.always_log ("Finished upgrading the sideband");
 }
 
+void nano::mdb_store::upgrade_v18_to_v19 (nano::write_transaction & transaction_a)
+{
+	logger.always_log ("Preparing v18 to v19 database upgrade...");
+
+	std::pair<MDB_dbi *, nano::block_type> legacy_tables[]{ { &send_blocks, nano::block_type::send }, { &receive_blocks, nano::block_type::receive }, { &open_blocks, nano::block_type::open }, { &change_blocks, nano::block_type::change }, { &state_blocks, nano::block_type::state } };
+	for (auto const & legacy : legacy_tables)
+	{
+		auto type (legacy.second);
+		// Entries already in the merged table were written after the legacy ones and take precedence
+		upgrade_entries (
+		transaction_a, *legacy.first, blocks, MDB_NOOVERWRITE, (19 << 8) | static_cast<uint8_t> (type), [type](nano::transaction const &, nano::mdb_val const &, nano::mdb_val const & value_a) {
+			std::vector<uint8_t> result;
+			result.reserve (1 + value_a.size ());
+			result.push_back (static_cast<uint8_t> (type));
+			result.insert (result.end (), static_cast<uint8_t *> (value_a.data ()), static_cast<uint8_t *> (value_a.data ()) + value_a.size ());
+			return result;
+		},
+		[this, &transaction_a, type](uint64_t written_a) {
+			block_count_add (transaction_a, type, written_a);
+		});
+		// Only emptied, the handle stays valid for the rest of this session but is not opened again once the version is 19
+		auto status (mdb_drop (env.tx (transaction_a), *legacy.first, 0));
+		release_assert (status == MDB_SUCCESS);
+	}
+
+	version_put (transaction_a, 19);
+	logger.always_log ("Finished merging block tables");
+}
+
+uint64_t nano::mdb_store::upgrade_entries (nano::write_transaction & transaction_a, MDB_dbi source_a, MDB_dbi destination_a, unsigned flags_a, uint64_t pass_a, std::function<std::vector<uint8_t> (nano::transaction const &, nano::mdb_val const &, nano::mdb_val const &)> const & upgrade_a, std::function<void(uint64_t)> const & batch_written_a)
+{
+	// Earlier upgrades in this session are committed so the read transactions of the workers see them
+	transaction_a.commit ();
+	transaction_a.renew ();
+	nano::uint256_union const progress_key (upgrade_progress_key);
+	// Resume after the last key committed by an interrupted run of this pass
+	std::vector<uint8_t> resume_key;
+	{
+		nano::mdb_val progress;
+		auto status (mdb_get (env.tx (transaction_a), meta, nano::mdb_val (progress_key), progress));
+		release_assert (success (status) || not_found (status));
+		uint64_t pass (0);
+		if (success (status) && progress.size () > sizeof (pass))
+		{
+			std::copy (static_cast<uint8_t *> (progress.data ()), static_cast<uint8_t *> (progress.data ()) + sizeof (pass), reinterpret_cast<uint8_t *> (&pass));
+			if (pass == pass_a)
+			{
+				resume_key.assign (static_cast<uint8_t *> (progress.data ()) + sizeof (pass), static_cast<uint8_t *> (progress.data ()) + progress.size ());
+				logger.always_log ("Resuming the interrupted upgrade");
+			}
+		}
+	}
+	auto progress_stored (!resume_key.empty ());
+	unsigned const thread_count (std::max (1u, std::thread::hardware_concurrency ()));
+	auto start (std::chrono::steady_clock::now ());
+	auto last_log (start);
+	uint64_t upgraded_count (0);
+	auto done (false);
+	while (!done)
+	{
+		// Entries are copied out as the write transaction is committed between batches
+		std::vector<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>> entries;
+		{
+			MDB_cursor * cursor;
+			auto status (mdb_cursor_open (env.tx (transaction_a), source_a, &cursor));
+			release_assert (success (status));
+			MDB_val key{ resume_key.size (), resume_key.data () };
+			MDB_val value;
+			status = mdb_cursor_get (cursor, &key, &value, resume_key.empty () ? MDB_FIRST : MDB_SET_RANGE);
+			if (success (status) && key.mv_size == resume_key.size () && std::equal (resume_key.begin (), resume_key.end (), static_cast<uint8_t *> (key.mv_data)))
+			{
+				status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT);
+			}
+			while (success (status) && entries.size () < upgrade_batch_size)
+			{
+				auto key_data (static_cast<uint8_t *> (key.mv_data));
+				auto value_data (static_cast<uint8_t *> (value.mv_data));
+				entries.emplace_back (std::vector<uint8_t> (key_data, key_data + key.mv_size), std::vector<uint8_t> (value_data, value_data + value.mv_size));
+				status = mdb_cursor_get (cursor, &key, &value, MDB_NEXT);
+			}
+			release_assert (success (status) || not_found (status));
+			done = not_found (status);
+			mdb_cursor_close (cursor);
+		}
+
+		// Decoding and re-encoding is spread over worker threads, which read the rest of the ledger as of the last commit through their own read transactions
+		std::vector<std::vector<uint8_t>> upgraded (entries.size ());
+		std::vector<std::thread> threads;
+		auto slice_size ((entries.size () + thread_count - 1) / thread_count);
+		for (size_t begin (0); begin < entries.size (); begin += slice_size)
+		{
+			threads.emplace_back ([this, &entries, &upgraded, &upgrade_a, begin, end = std::min (begin + slice_size, entries.size ())]() {
+				nano::thread_role::set (nano::thread_role::name::db_parallel_traversal);
+				auto transaction (tx_begin_read ());
+				for (auto i (begin); i < end; ++i)
+				{
+					upgraded[i] = upgrade_a (transaction, nano::mdb_val (entries[i].first.size (), entries[i].first.data ()), nano::mdb_val (entries[i].second.size (), entries[i].second.data ()));
+				}
+			});
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+
+		uint64_t written (0);
+		for (size_t i (0); i < entries.size (); ++i)
+		{
+			auto status (mdb_put (env.tx (transaction_a), destination_a, nano::mdb_val (entries[i].first.size (), entries[i].first.data ()), nano::mdb_val (upgraded[i].size (), upgraded[i].data ()), flags_a));
+			release_assert (success (status) || status == MDB_KEYEXIST);
+			written += success (status) ? 1 : 0;
+		}
+		if (batch_written_a)
+		{
+			batch_written_a (written);
+		}
+		upgraded_count += entries.size ();
+
+		if (!done)
+		{
+			// The batch is committed along with where to resume from, so an interrupted upgrade does not start over
+			resume_key = entries.back ().first;
+			std::vector<uint8_t> progress (reinterpret_cast<uint8_t const *> (&pass_a), reinterpret_cast<uint8_t const *> (&pass_a) + sizeof (pass_a));
+			progress.insert (progress.end (), resume_key.begin (), resume_key.end ());
+			auto status (mdb_put (env.tx (transaction_a), meta, nano::mdb_val (progress_key), nano::mdb_val (progress.size (), progress.data ()), 0));
+			release_assert (success (status));
+			progress_stored = true;
+			transaction_a.commit ();
+			transaction_a.renew ();
+		}
+		else if (progress_stored)
+		{
+			// The rest of the upgrade commits together with the final batch
+			auto status (mdb_del (env.tx (transaction_a), meta, nano::mdb_val (progress_key), nullptr));
+			release_assert (success (status));
+		}
+
+		auto now (std::chrono::steady_clock::now ());
+		if (done || now - last_log >= std::chrono::seconds (10))
+		{
+			auto elapsed (std::chrono::duration_cast<std::chrono::milliseconds> (now - start).count ());
+			logger.always_log (boost::str (boost::format ("Upgraded %1% entries, %2% per second") % upgraded_count % (upgraded_count * 1000 / std::max<uint64_t> (elapsed, 1))));
+			last_log = now;
+		}
+	}
+	return upgraded_count;
+}
+
+void nano::mdb_store::upgrade_v19_to_v20 (nano::write_transaction const & transaction_a)
+{
+	// The delegators table is created empty when opening the databases, it is populated by ledgers enabling the index
+	version_put (transaction_a, 20);
+}
+
+void nano::mdb_store::upgrade_v20_to_v21 (nano::write_transaction const & transaction_a)
+{
+	// The account_heights table is created empty when opening the databases, it is populated by ledgers enabling the index
+	version_put (transaction_a, 21);
+}
+
+void nano::mdb_store::upgrade_v21_to_v22 (nano::write_transaction const & transaction_a)
+{
+	// Unchecked entries no longer hold the block, the old entries are dropped and requested again while bootstrapping
+	mdb_drop (env.tx (transaction_a), unchecked, 0);
+	mdb_drop (env.tx (transaction_a), unchecked_bodies, 0);
+	version_put (transaction_a, 22);
+}
+
+void nano::mdb_store::upgrade_v22_to_v23 (nano::write_transaction const & transaction_a)
+{
+	// The pruned table is created empty when opening the databases, it is populated by ledgers enabling pruning
+	version_put (transaction_a, 23);
+}
+
 /** Takes a filepath, appends '_backup_<timestamp>' to the end (but before any extension) and saves that file in the same directory */
 void nano::mdb_store::create_backup_file (nano::mdb_env & env_a, boost::filesystem::path const & filepath_a, nano::logger_mt & logger_a)
 {
@@ -884,12 +1050,13 @@ void nano::mdb_store::version_put (nano::write_transaction const & transaction_a
 	nano::uint256_union version_value (version_a);
 	auto status (mdb_put (env.tx (transaction_a), meta, nano::mdb_val (version_key), nano::mdb_val (version_value), 0));
 	release_assert (status == 0);
-	if (blocks_info == 0 && !full_sideband (transaction_a))
+	cached_version = version_a;
+	if (blocks_info == 0 && !full_sideband ())
 	{
 		auto status (mdb_dbi_open (env.tx (transaction_a), "blocks_info", MDB_CREATE, &blocks_info));
 		release_assert (status == MDB_SUCCESS);
 	}
-	if (blocks_info != 0 && full_sideband (transaction_a))
+	if (blocks_info != 0 && full_sideband ())
 	{
 		auto status (mdb_drop (env.tx (transaction_a), blocks_info, 1));
 		release_assert (status == MDB_SUCCESS);
@@ -899,7 +1066,7 @@ void nano::mdb_store::version_put (nano::write_transaction const & transaction_a
 
 bool nano::mdb_store::block_info_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_info & block_info_a) const
 {
-	debug_assert (!full_sideband (transaction_a));
+	debug_assert (!full_sideband ());
 	nano::mdb_val value;
 	auto status (mdb_get (env.tx (transaction_a), blocks_info, nano::mdb_val (hash_a), value));
 	release_assert (status == 0 || status == MDB_NOTFOUND);
@@ -932,6 +1099,22 @@ int nano::mdb_store::get (nano::transaction const & transaction_a, tables table_
 	return mdb_get (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a);
 }
 
+void nano::mdb_store::get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::mdb_val> const & keys_a, std::vector<nano::mdb_val> & values_a) const
+{
+	debug_assert (keys_a.size () == values_a.size ());
+	MDB_cursor * cursor;
+	auto status (mdb_cursor_open (env.tx (transaction_a), table_to_dbi (table_a), &cursor));
+	release_assert (status == MDB_SUCCESS);
+	for (size_t i (0); i < keys_a.size (); ++i)
+	{
+		// With ascending keys a positioned cursor finds neighbouring keys on its current leaf page without searching down from the root
+		auto key (keys_a[i].value);
+		auto status2 (mdb_cursor_get (cursor, &key, values_a[i], MDB_SET));
+		release_assert (status2 == MDB_SUCCESS || status2 == MDB_NOTFOUND);
+	}
+	mdb_cursor_close (cursor);
+}
+
 int nano::mdb_store::put (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, const nano::mdb_val & value_a) const
 {
 	return (mdb_put (env.tx (transaction_a), table_to_dbi (table_a), key_a, value_a, 0));
@@ -965,6 +1148,11 @@ size_t nano::mdb_store::count (nano::transaction const & transaction_a, MDB_dbi
 	return (stats.ms_entries);
 }
 
+nano::tables nano::mdb_store::block_counts_table () const
+{
+	return tables::meta;
+}
+
 MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 {
 	switch (table_a)
@@ -973,6 +1161,8 @@ MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 			return frontiers;
 		case tables::accounts:
 			return accounts;
+		case tables::blocks:
+			return blocks;
 		case tables::send_blocks:
 			return send_blocks;
 		case tables::receive_blocks:
@@ -997,6 +1187,14 @@ MDB_dbi nano::mdb_store::table_to_dbi (tables table_a) const
 			return meta;
 		case tables::peers:
 			return peers;
+		case tables::delegators:
+			return delegators;
+		case tables::account_heights:
+			return account_heights;
+		case tables::unchecked_bodies:
+			return unchecked_bodies;
+		case tables::pruned:
+			return pruned;
 		case tables::confirmation_height:
 			return confirmation_height;
 		default:
@@ -1020,6 +1218,12 @@ int nano::mdb_store::status_code_not_found () const
 	return MDB_NOTFOUND;
 }
 
+uint64_t nano::mdb_store::transaction_sequence (nano::transaction const & transaction_a) const
+{
+	// Read transactions have the id of the snapshot they see, a write transaction the id it commits with. Commits which change nothing are not stored and leave the id unchanged
+	return mdb_txn_id (env.tx (transaction_a));
+}
+
 bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file)
 {
 	return !mdb_env_copy2 (env.environment, destination_file.string ().c_str (), MDB_CP_COMPACT);
@@ -1028,7 +1232,7 @@ bool nano::mdb_store::copy_db (boost::filesystem::path const & destination_file)
 void nano::mdb_store::rebuild_db (nano::write_transaction const & transaction_a)
 {
 	// Tables with uint256_union key
-	std::vector<MDB_dbi> tables = { accounts, send_blocks, receive_blocks, open_blocks, change_blocks, state_blocks, vote, confirmation_height };
+	std::vector<MDB_dbi> tables = { accounts, blocks, vote, confirmation_height };
 	for (auto const & table : tables)
 	{
 		MDB_dbi temp;
@@ -1080,6 +1284,18 @@ bool nano::mdb_store::init_error () const
 	return error;
 }
 
+void nano::mdb_store::deferred_sync_set (bool enable_a)
+{
+	auto status (mdb_env_set_flags (env, MDB_NOSYNC, enable_a ? 1 : 0));
+	release_assert (status == MDB_SUCCESS);
+}
+
+void nano::mdb_store::sync ()
+{
+	auto status (mdb_env_sync (env, 1));
+	release_assert (status == MDB_SUCCESS);
+}
+
 // All the v14 functions below are only needed during upgrades
 bool nano::mdb_store::entry_has_sideband_v14 (size_t entry_size_a, nano::block_type type_a) const
 {
@@ -1089,7 +1305,7 @@ bool nano::mdb_store::entry_has_sideband_v14 (size_t entry_size_a, nano::block_t
 size_t nano::mdb_store::block_successor_offset_v14 (nano::transaction const & transaction_a, size_t entry_size_a, nano::block_type type_a) const
 {
 	size_t result;
-	if (full_sideband (transaction_a) || entry_has_sideband_v14 (entry_size_a, type_a))
+	if (full_sideband () || entry_has_sideband_v14 (entry_size_a, type_a))
 	{
 		result = entry_size_a - nano::block_sideband_v14::size (type_a);
 	}
@@ -1213,7 +1429,7 @@ nano::account nano::mdb_store::block_account_v14 (nano::transaction const & tran
 // Return account containing hash
 nano::account nano::mdb_store::block_account_computed_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 {
-	debug_assert (!full_sideband (transaction_a));
+	debug_assert (!full_sideband ());
 	nano::account result (0);
 	auto hash (hash_a);
 	while (result.is_zero ())
@@ -1255,7 +1471,7 @@ nano::account nano::mdb_store::block_account_computed_v14 (nano::transaction con
 
 nano::uint128_t nano::mdb_store::block_balance_computed_v14 (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 {
-	debug_assert (!full_sideband (transaction_a));
+	debug_assert (!full_sideband ());
 	summation_visitor visitor (transaction_a, *this, true);
 	return visitor.compute_balance (hash_a);
 }
@@ -1273,7 +1489,7 @@ std::shared_ptr<nano::block> nano::mdb_store::block_get_v14 (nano::transaction c
 		if (sideband_a)
 		{
 			sideband_a->type = type;
-			if (full_sideband (transaction_a) || entry_has_sideband_v14 (value.size (), type))
+			if (full_sideband () || entry_has_sideband_v14 (value.size (), type))
 			{
 				bool error = sideband_a->deserialize (stream);
 				(void)error;
@@ -36,7 +36,7 @@ public:
 	using block_store_partial::block_exists;
 	using block_store_partial::unchecked_put;
 
-	mdb_store (nano::logger_mt &, boost::filesystem::path const &, nano::txn_tracking_config const & txn_tracking_config_a = nano::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), int lmdb_max_dbs = 128, size_t batch_size = 512, bool backup_before_upgrade = false);
+	mdb_store (nano::logger_mt &, boost::filesystem::path const &, nano::txn_tracking_config const & txn_tracking_config_a = nano::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), int lmdb_max_dbs = 128, size_t batch_size = 512, bool backup_before_upgrade = false, nano::stat * stats = nullptr);
 	nano::write_transaction tx_begin_write (std::vector<nano::tables> const & tables_requiring_lock = {}, std::vector<nano::tables> const & tables_no_lock = {}) override;
 	nano::read_transaction tx_begin_read () override;
 
@@ -56,6 +56,8 @@ private:
 
 public:
 	nano::mdb_env env;
+	/** Declared after env so pooled transactions are aborted before the environment closes */
+	nano::mdb_read_txn_pool read_txn_pool;
 
 	/**
 	 * Maps head block to owning account
@@ -82,25 +84,31 @@ public:
 	MDB_dbi accounts{ 0 };
 
 	/**
-	 * Maps block hash to send block.
+	 * Maps block hash to block type, block and sideband.
+	 * nano::block_hash -> nano::block_type, nano::block, nano::block_sideband
+	 */
+	MDB_dbi blocks{ 0 };
+
+	/**
+	 * Maps block hash to send block. (Removed)
 	 * nano::block_hash -> nano::send_block
 	 */
 	MDB_dbi send_blocks{ 0 };
 
 	/**
-	 * Maps block hash to receive block.
+	 * Maps block hash to receive block. (Removed)
 	 * nano::block_hash -> nano::receive_block
 	 */
 	MDB_dbi receive_blocks{ 0 };
 
 	/**
-	 * Maps block hash to open block.
+	 * Maps block hash to open block. (Removed)
 	 * nano::block_hash -> nano::open_block
 	 */
 	MDB_dbi open_blocks{ 0 };
 
 	/**
-	 * Maps block hash to change block.
+	 * Maps block hash to change block. (Removed)
 	 * nano::block_hash -> nano::change_block
 	 */
 	MDB_dbi change_blocks{ 0 };
@@ -118,7 +126,7 @@ public:
 	MDB_dbi state_blocks_v1{ 0 };
 
 	/**
-	 * Maps block hash to state block.
+	 * Maps block hash to state block. (Removed)
 	 * nano::block_hash -> nano::state_block
 	 */
 	MDB_dbi state_blocks{ 0 };
@@ -154,11 +162,23 @@ public:
 	MDB_dbi representation{ 0 };
 
 	/**
-	 * Unchecked bootstrap blocks info.
-	 * nano::block_hash -> nano::unchecked_info
+	 * Unchecked bootstrap blocks info, without the block which is held in unchecked_bodies.
+	 * nano::unchecked_key -> nano::account, uint64_t, nano::signature_verification
 	 */
 	MDB_dbi unchecked{ 0 };
 
+	/**
+	 * Unchecked block bodies, shared by every unchecked entry for the block.
+	 * nano::block_hash -> uint64_t, nano::block
+	 */
+	MDB_dbi unchecked_bodies{ 0 };
+
+	/**
+	 * Blocks deleted by ledger pruning, with the account and height they had
+	 * nano::block_hash -> nano::pruned_info
+	 */
+	MDB_dbi pruned{ 0 };
+
 	/**
 	 * Highest vote observed for account.
 	 * nano::account -> uint64_t
@@ -172,7 +192,7 @@ public:
 	MDB_dbi online_weight{ 0 };
 
 	/**
-	 * Meta information about block store, such as versions.
+	 * Meta information about block store, such as versions and the number of blocks of each type.
 	 * nano::uint256_union (arbitrary key) -> blob
 	 */
 	MDB_dbi meta{ 0 };
@@ -183,6 +203,18 @@ public:
 	*/
 	MDB_dbi peers{ 0 };
 
+	/*
+	 * Accounts delegating to a representative, only populated when the delegators index is enabled
+	 * nano::delegator_key -> no_value
+	 */
+	MDB_dbi delegators{ 0 };
+
+	/*
+	 * Hash of each block by account and height, only populated when the account heights index is enabled
+	 * nano::account_height_key -> nano::block_hash
+	 */
+	MDB_dbi account_heights{ 0 };
+
 	/*
 	 * Confirmation height of an account, and the hash for the block at that height
 	 * nano::account -> uint64_t, nano::block_hash
@@ -192,6 +224,7 @@ public:
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
 	int get (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, nano::mdb_val & value_a) const;
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::mdb_val> const & keys_a, std::vector<nano::mdb_val> & values_a) const;
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a, const nano::mdb_val & value_a) const;
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::mdb_val const & key_a) const;
 
@@ -210,8 +243,18 @@ public:
 		return nano::store_iterator<Key, Value> (std::make_unique<nano::mdb_iterator<Key, Value>> (transaction_a, table_to_dbi (table_a), key));
 	}
 
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::mdb_val const & key, size_t) const
+	{
+		// Cursors have no prefix seek, they continue past the prefix
+		return make_iterator<Key, Value> (transaction_a, table_a, key);
+	}
+
 	bool init_error () const override;
 
+	void deferred_sync_set (bool) override;
+	void sync () override;
+
 	size_t count (nano::transaction const &, MDB_dbi) const;
 
 	// These are only use in the upgrade process.
@@ -241,8 +284,23 @@ private:
 	void upgrade_v13_to_v14 (nano::write_transaction const &);
 	void upgrade_v14_to_v15 (nano::write_transaction &);
 	void upgrade_v15_to_v16 (nano::write_transaction const &);
-	void upgrade_v16_to_v17 (nano::write_transaction const &);
-	void upgrade_v17_to_v18 (nano::write_transaction const &);
+	void upgrade_v16_to_v17 (nano::write_transaction &);
+	void upgrade_v17_to_v18 (nano::write_transaction &);
+	void upgrade_v18_to_v19 (nano::write_transaction &);
+	void upgrade_v19_to_v20 (nano::write_transaction const &);
+	void upgrade_v20_to_v21 (nano::write_transaction const &);
+	void upgrade_v21_to_v22 (nano::write_transaction const &);
+	void upgrade_v22_to_v23 (nano::write_transaction const &);
+
+	/**
+	 * Rewrites every entry of \p source_a into \p destination_a, which may be the same table, as returned by \p upgrade_a. Batches of entries are upgraded on worker threads and written by the calling thread,
+	 * each batch is committed along with the key it ended at so a run interrupted part way through pass \p pass_a resumes after it. \p batch_written_a is called before each commit with the number of entries written
+	 * @return The number of entries upgraded
+	 */
+	uint64_t upgrade_entries (nano::write_transaction &, MDB_dbi source_a, MDB_dbi destination_a, unsigned flags_a, uint64_t pass_a, std::function<std::vector<uint8_t> (nano::transaction const &, nano::mdb_val const &, nano::mdb_val const &)> const & upgrade_a, std::function<void(uint64_t)> const & batch_written_a = nullptr);
+	static size_t constexpr upgrade_batch_size{ 64 * 1024 };
+	/** Key in the meta table holding where an interrupted upgrade resumes, offset past the ledger cache checkpoint key */
+	static uint64_t constexpr upgrade_progress_key{ 0x300 };
 
 	void open_databases (bool &, nano::transaction const &, unsigned);
 
@@ -252,6 +310,7 @@ private:
 	bool not_found (int status) const override;
 	bool success (int status) const override;
 	int status_code_not_found () const override;
+	uint64_t transaction_sequence (nano::transaction const & transaction_a) const override;
 
 	MDB_dbi table_to_dbi (tables table_a) const;
 
@@ -260,6 +319,7 @@ private:
 	bool txn_tracking_enabled;
 
 	size_t count (nano::transaction const & transaction_a, tables table_a) const override;
+	tables block_counts_table () const override;
 
 	bool vacuum_after_upgrade (boost::filesystem::path const & path_a, int lmdb_max_dbs);
 
@@ -1,5 +1,6 @@
 #include <nano/lib/jsonconfig.hpp>
 #include <nano/lib/logger_mt.hpp>
+#include <nano/lib/stats.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/node/lmdb/lmdb_env.hpp>
@@ -49,19 +50,33 @@ private:
 };
 }
 
-nano::read_mdb_txn::read_mdb_txn (nano::mdb_env const & environment_a, nano::mdb_txn_callbacks txn_callbacks_a) :
-txn_callbacks (txn_callbacks_a)
+nano::read_mdb_txn::read_mdb_txn (nano::mdb_env const & environment_a, nano::mdb_txn_callbacks txn_callbacks_a, nano::mdb_read_txn_pool * pool_a) :
+txn_callbacks (txn_callbacks_a),
+pool (pool_a)
 {
-	auto status (mdb_txn_begin (environment_a, nullptr, MDB_RDONLY, &handle));
-	release_assert (status == 0);
+	handle = pool != nullptr ? pool->acquire () : nullptr;
+	if (handle == nullptr)
+	{
+		auto status (mdb_txn_begin (environment_a, nullptr, MDB_RDONLY, &handle));
+		release_assert (status == 0);
+	}
 	txn_callbacks.txn_start (this);
 }
 
 nano::read_mdb_txn::~read_mdb_txn ()
 {
-	// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
-	auto status (mdb_txn_commit (handle));
-	release_assert (status == MDB_SUCCESS);
+	if (pool != nullptr)
+	{
+		// Pooled transactions are only handed out once the databases are open, so there are no handles needing a commit to be published
+		mdb_txn_reset (handle);
+		pool->release (handle);
+	}
+	else
+	{
+		// This uses commit rather than abort, as it is needed when opening databases with a read only transaction
+		auto status (mdb_txn_commit (handle));
+		release_assert (status == MDB_SUCCESS);
+	}
 	txn_callbacks.txn_end (this);
 }
 
@@ -83,6 +98,87 @@ void * nano::read_mdb_txn::get_handle () const
 	return handle;
 }
 
+nano::mdb_read_txn_pool::mdb_read_txn_pool (nano::stat * stats_a, size_t max_size_a, std::chrono::milliseconds max_idle_a) :
+stats (stats_a),
+max_size (max_size_a),
+max_idle (max_idle_a)
+{
+}
+
+nano::mdb_read_txn_pool::~mdb_read_txn_pool ()
+{
+	clear ();
+}
+
+MDB_txn * nano::mdb_read_txn_pool::acquire ()
+{
+	MDB_txn * result (nullptr);
+	{
+		nano::lock_guard<std::mutex> guard (mutex);
+		erase_idle (std::chrono::steady_clock::now ());
+		if (!txns.empty ())
+		{
+			// The most recently released transaction is the least likely to have had its reader slot reclaimed
+			result = txns.back ().txn;
+			txns.pop_back ();
+		}
+	}
+	if (result != nullptr)
+	{
+		auto status (mdb_txn_renew (result));
+		if (status != MDB_SUCCESS)
+		{
+			mdb_txn_abort (result);
+			result = nullptr;
+		}
+	}
+	if (stats != nullptr)
+	{
+		stats->inc (nano::stat::type::read_txn_pool, result != nullptr ? nano::stat::detail::cache_hit : nano::stat::detail::cache_miss);
+	}
+	return result;
+}
+
+void nano::mdb_read_txn_pool::release (MDB_txn * txn_a)
+{
+	auto now (std::chrono::steady_clock::now ());
+	nano::lock_guard<std::mutex> guard (mutex);
+	erase_idle (now);
+	if (txns.size () < max_size)
+	{
+		txns.push_back (entry{ txn_a, now });
+	}
+	else
+	{
+		mdb_txn_abort (txn_a);
+	}
+}
+
+void nano::mdb_read_txn_pool::clear ()
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	for (auto & entry_l : txns)
+	{
+		mdb_txn_abort (entry_l.txn);
+	}
+	txns.clear ();
+}
+
+size_t nano::mdb_read_txn_pool::size () const
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return txns.size ();
+}
+
+void nano::mdb_read_txn_pool::erase_idle (std::chrono::steady_clock::time_point now_a)
+{
+	while (!txns.empty () && txns.front ().released + max_idle < now_a)
+	{
+		mdb_txn_abort (txns.front ().txn);
+		txns.pop_front ();
+	}
+}
+
 nano::write_mdb_txn::write_mdb_txn (nano::mdb_env const & environment_a, nano::mdb_txn_callbacks txn_callbacks_a) :
 env (environment_a),
 txn_callbacks (txn_callbacks_a)
@@ -7,6 +7,8 @@
 #include <boost/property_tree/ptree_fwd.hpp>
 #include <boost/stacktrace/stacktrace_fwd.hpp>
 
+#include <chrono>
+#include <deque>
 #include <mutex>
 
 #include <lmdb/libraries/liblmdb/lmdb.h>
@@ -16,6 +18,8 @@ namespace nano
 class transaction_impl;
 class logger_mt;
 class mdb_env;
+class mdb_read_txn_pool;
+class stat;
 
 class mdb_txn_callbacks
 {
@@ -27,13 +31,51 @@ public:
 class read_mdb_txn final : public read_transaction_impl
 {
 public:
-	read_mdb_txn (nano::mdb_env const &, mdb_txn_callbacks mdb_txn_callbacks);
+	read_mdb_txn (nano::mdb_env const &, mdb_txn_callbacks mdb_txn_callbacks, nano::mdb_read_txn_pool * pool = nullptr);
 	~read_mdb_txn ();
 	void reset () override;
 	void renew () override;
 	void * get_handle () const override;
 	MDB_txn * handle;
 	mdb_txn_callbacks txn_callbacks;
+	/** Transactions taken from a pool are reset and returned to it rather than committed */
+	nano::mdb_read_txn_pool * pool;
+};
+
+/**
+ * Keeps reset read transactions for reuse, renewing one is cheaper than beginning a new transaction as it already holds a reader slot.
+ * A reset transaction pins no snapshot, and each use renews it to the latest one, so pooling does not hold back page reclamation.
+ * Transactions idle for longer than the maximum idle time are aborted to give their reader slots back to the environment.
+ * Reuses and new transactions are counted as cache hits and misses in the read_txn_pool stat type if a stat object is supplied.
+ * @note This class is thread-safe, transactions can move between threads as the environment is opened with MDB_NOTLS.
+ */
+class mdb_read_txn_pool final
+{
+public:
+	mdb_read_txn_pool (nano::stat * stats_a = nullptr, size_t max_size_a = 64, std::chrono::milliseconds max_idle_a = std::chrono::seconds (30));
+	~mdb_read_txn_pool ();
+	/** Returns a renewed transaction or nullptr if the caller needs to begin a new one */
+	MDB_txn * acquire ();
+	/** Takes ownership of a transaction which has been reset */
+	void release (MDB_txn *);
+	/** Aborts all pooled transactions, must be called before the environment is closed */
+	void clear ();
+	size_t size () const;
+
+private:
+	void erase_idle (std::chrono::steady_clock::time_point);
+	class entry final
+	{
+	public:
+		MDB_txn * txn;
+		std::chrono::steady_clock::time_point released;
+	};
+	mutable std::mutex mutex;
+	/** Most recently released at the back */
+	std::deque<entry> txns;
+	nano::stat * stats;
+	size_t const max_size;
+	std::chrono::milliseconds const max_idle;
 };
 
 class write_mdb_txn final : public write_transaction_impl
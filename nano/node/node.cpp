@@ -109,6 +109,7 @@ node (io_ctx_a, application_path_a, alarm_a, nano::node_config (peering_port_a,
 }
 
 nano::node::node (boost::asio::io_context & io_ctx_a, boost::filesystem::path const & application_path_a, nano::alarm & alarm_a, nano::node_config const & config_a, nano::work_pool & work_a, nano::node_flags flags_a) :
+write_database_queue ([this]() { store.sync (); }, config_a.group_commit_max_delay, &stats),
 io_ctx (io_ctx_a),
 node_initialized_latch (1),
 config (config_a),
@@ -118,20 +119,22 @@ alarm (alarm_a),
 work (work_a),
 distributed_work (*this),
 logger (config_a.logging.min_time_between_log_output),
-store_impl (nano::make_store (logger, application_path_a, flags.read_only, true, config_a.rocksdb_config, config_a.diagnostics_config.txn_tracking, config_a.block_processor_batch_max_time, config_a.lmdb_max_dbs, flags.sideband_batch_size, config_a.backup_before_upgrade, config_a.rocksdb_config.enable)),
+store_impl (nano::make_store (logger, application_path_a, flags.read_only, true, config_a.rocksdb_config, config_a.diagnostics_config.txn_tracking, config_a.block_processor_batch_max_time, config_a.lmdb_max_dbs, flags.sideband_batch_size, config_a.backup_before_upgrade, config_a.rocksdb_config.enable, &stats)),
 store (*store_impl),
 wallets_store_impl (std::make_unique<nano::mdb_wallets_store> (application_path_a / "wallets.ldb", config_a.lmdb_max_dbs)),
 wallets_store (*wallets_store_impl),
 gap_cache (*this),
-ledger (store, stats, flags_a.generate_cache),
+ledger (store, stats, flags_a.generate_cache, &logger),
+unchecked (store, config_a.unchecked_memory_size * 1024 * 1024),
 checker (config.signature_checker_threads),
+signature_cache (flags.signature_cache_size),
 network (*this, config.peering_port),
 telemetry (network, alarm, worker, flags.disable_ongoing_telemetry_requests),
 bootstrap_initiator (*this),
 bootstrap (config.peering_port, *this),
 application_path (application_path_a),
 port_mapping (*this),
-vote_processor (checker, active, observers, stats, config, logger, online_reps, ledger, network_params),
+vote_processor (checker, signature_cache, active, observers, stats, config, logger, online_reps, ledger, network_params),
 rep_crawler (*this),
 warmed_up (0),
 block_processor (*this, write_database_queue),
@@ -153,6 +156,11 @@ startup_time (std::chrono::steady_clock::now ())
 {
 	if (!init_error ())
 	{
+		if (config.group_commit_max_delay.count () > 0 && !flags.read_only)
+		{
+			// Commits are flushed by the write queue, shared between queued writers
+			store.deferred_sync_set (true);
+		}
 		if (config.websocket_config.enabled)
 		{
 			auto endpoint_l (nano::tcp_endpoint (boost::asio::ip::make_address_v6 (config.websocket_config.address), config.websocket_config.port));
@@ -367,7 +375,7 @@ startup_time (std::chrono::steady_clock::now ())
 		if (!is_initialized)
 		{
 			release_assert (!flags.read_only);
-			auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::confirmation_height, tables::frontiers, tables::open_blocks }));
+			auto transaction (store.tx_begin_write ({ tables::accounts, tables::blocks, tables::cached_counts, tables::confirmation_height, tables::frontiers }));
 			// Store was empty meaning we just created it, add the genesis block
 			store.initialize (transaction, genesis, ledger.cache);
 		}
@@ -387,6 +395,57 @@ startup_time (std::chrono::steady_clock::now ())
 			std::exit (1);
 		}
 
+		if (!flags.read_only)
+		{
+			// The ledger has loaded or discarded the checkpoint. Compacting copies of the ledger reset the transaction id it is checked against, so it must not outlive this start
+			auto transaction (store.tx_begin_write ({ tables::meta }));
+			store.cache_checkpoint_del (transaction);
+		}
+
+		// Build or drop the secondary indexes if their settings changed since the last run. Inactive nodes use the default config and keep maintaining existing indexes
+		auto delegators_indexed (false);
+		auto account_heights_indexed (false);
+		{
+			auto transaction (store.tx_begin_read ());
+			delegators_indexed = (store.delegators_begin (transaction) != store.delegators_end ());
+			account_heights_indexed = (store.account_heights_begin (transaction) != store.account_heights_end ());
+		}
+		auto const update_indexes (!flags.read_only && !flags.inactive_node);
+		if (config.enable_delegators_index != delegators_indexed && update_indexes)
+		{
+			auto transaction (store.tx_begin_write ({ tables::delegators }));
+			if (config.enable_delegators_index)
+			{
+				logger.always_log ("Building delegators index...");
+				ledger.delegators_index_build (transaction);
+			}
+			else
+			{
+				logger.always_log ("Dropping delegators index");
+				store.delegators_clear (transaction);
+			}
+			delegators_indexed = config.enable_delegators_index;
+		}
+		ledger.delegators_index = delegators_indexed;
+		if (config.enable_account_heights_index != account_heights_indexed && update_indexes)
+		{
+			auto transaction (store.tx_begin_write ({ tables::account_heights }));
+			if (config.enable_account_heights_index)
+			{
+				logger.always_log ("Building account heights index...");
+				ledger.account_heights_index_build (transaction);
+			}
+			else
+			{
+				logger.always_log ("Dropping account heights index");
+				store.account_heights_clear (transaction);
+			}
+			account_heights_indexed = config.enable_account_heights_index;
+		}
+		ledger.account_heights_index = account_heights_indexed;
+		// Pruned blocks are treated as existing even once pruning is disabled
+		ledger.pruning = config.enable_pruning || ledger.cache.pruned_count > 0;
+
 		if (config.enable_voting)
 		{
 			std::ostringstream stream;
@@ -441,8 +500,8 @@ startup_time (std::chrono::steady_clock::now ())
 			// Drop unchecked blocks if initial bootstrap is completed
 			if (!flags.disable_unchecked_drop && !use_bootstrap_weight && !flags.read_only)
 			{
-				auto transaction (store.tx_begin_write ({ tables::unchecked }));
-				store.unchecked_clear (transaction);
+				auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_bodies }));
+				unchecked.clear (transaction);
 				ledger.cache.unchecked_count = 0;
 				logger.always_log ("Dropping unchecked blocks");
 			}
@@ -582,6 +641,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (no
 	composite->add_component (collect_container_info (node.work, "work"));
 	composite->add_component (collect_container_info (node.gap_cache, "gap_cache"));
 	composite->add_component (collect_container_info (node.ledger, "ledger"));
+	composite->add_component (collect_container_info (node.unchecked, "unchecked"));
 	composite->add_component (collect_container_info (node.active, "active"));
 	composite->add_component (collect_container_info (node.bootstrap_initiator, "bootstrap_initiator"));
 	composite->add_component (collect_container_info (node.bootstrap, "bootstrap"));
@@ -590,6 +650,7 @@ std::unique_ptr<nano::container_info_component> nano::collect_container_info (no
 	composite->add_component (collect_container_info (node.observers, "observers"));
 	composite->add_component (collect_container_info (node.wallets, "wallets"));
 	composite->add_component (collect_container_info (node.vote_processor, "vote_processor"));
+	composite->add_component (collect_container_info (node.signature_cache, "signature_cache"));
 	composite->add_component (collect_container_info (node.rep_crawler, "rep_crawler"));
 	composite->add_component (collect_container_info (node.block_processor, "block_processor"));
 	composite->add_component (collect_container_info (node.block_arrival, "block_arrival"));
@@ -612,7 +673,7 @@ void nano::node::process_active (std::shared_ptr<nano::block> incoming)
 
 nano::process_return nano::node::process (nano::block const & block_a)
 {
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+	auto transaction (store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, tables::cached_counts, tables::delegators, tables::frontiers, tables::pending, tables::representation }, { tables::confirmation_height }));
 	auto result (ledger.process (transaction, block_a));
 	return result;
 }
@@ -626,7 +687,7 @@ nano::process_return nano::node::process_local (std::shared_ptr<nano::block> blo
 	// Notify block processor to release write lock
 	block_processor.wait_write ();
 	// Process block
-	auto transaction (store.tx_begin_write ({ tables::accounts, tables::cached_counts, tables::change_blocks, tables::frontiers, tables::open_blocks, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks }, { tables::confirmation_height }));
+	auto transaction (store.tx_begin_write ({ tables::account_heights, tables::accounts, tables::blocks, tables::cached_counts, tables::delegators, tables::frontiers, tables::pending, tables::representation }, { tables::confirmation_height }));
 	return block_processor.process_one (transaction, info, work_watcher_a);
 }
 
@@ -647,6 +708,13 @@ void nano::node::start ()
 		});
 	}
 	ongoing_store_flush ();
+	if (config.enable_pruning && !flags.read_only)
+	{
+		auto this_l (shared ());
+		worker.push_task ([this_l]() {
+			this_l->ongoing_ledger_pruning ();
+		});
+	}
 	if (!flags.disable_rep_crawler)
 	{
 		rep_crawler.start ();
@@ -711,6 +779,21 @@ void nano::node::stop ()
 		wallets.stop ();
 		stats.stop ();
 		worker.stop ();
+		if (unchecked.memory_size () > 0)
+		{
+			auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_bodies }));
+			unchecked.flush (transaction);
+		}
+		if (!flags.read_only && !store.init_error ())
+		{
+			// Last write before stopping, any later write invalidates the checkpoint
+			auto transaction (store.tx_begin_write ({ tables::meta }));
+			ledger.cache_checkpoint (transaction);
+		}
+		if (config.group_commit_max_delay.count () > 0)
+		{
+			store.sync ();
+		}
 		// work pool is not stopped on purpose due to testing setup
 	}
 }
@@ -843,6 +926,11 @@ void nano::node::ongoing_store_flush ()
 		auto transaction (store.tx_begin_write ({ tables::vote }));
 		store.flush (transaction);
 	}
+	if (config.group_commit_max_delay.count () > 0)
+	{
+		// Writers outside the write queue rely on this to become durable
+		store.sync ();
+	}
 	std::weak_ptr<nano::node> node_w (shared_from_this ());
 	alarm.add (std::chrono::steady_clock::now () + std::chrono::seconds (5), [node_w]() {
 		if (auto node_l = node_w.lock ())
@@ -932,15 +1020,13 @@ void nano::node::unchecked_cleanup ()
 		auto now (nano::seconds_since_epoch ());
 		auto transaction (store.tx_begin_read ());
 		// Max 1M records to clean, max 2 minutes reading to prevent slow i/o systems issues
-		for (auto i (store.unchecked_begin (transaction)), n (store.unchecked_end ()); i != n && cleaning_list.size () < 1024 * 1024 && nano::seconds_since_epoch () - now < 120; ++i)
-		{
-			nano::unchecked_key const & key (i->first);
-			nano::unchecked_info const & info (i->second);
-			if ((now - info.modified) > static_cast<uint64_t> (config.unchecked_cutoff_time.count ()))
+		unchecked.for_each (transaction, nano::unchecked_key (0, 0), [this, &cleaning_list, now](nano::unchecked_key const & key_a, nano::unchecked_info const & info_a) {
+			if ((now - info_a.modified) > static_cast<uint64_t> (config.unchecked_cutoff_time.count ()))
 			{
-				cleaning_list.push_back (key);
+				cleaning_list.push_back (key_a);
 			}
-		}
+			return cleaning_list.size () < 1024 * 1024 && nano::seconds_since_epoch () - now < 120;
+		});
 	}
 	if (!cleaning_list.empty ())
 	{
@@ -950,12 +1036,12 @@ void nano::node::unchecked_cleanup ()
 	while (!cleaning_list.empty ())
 	{
 		size_t deleted_count (0);
-		auto transaction (store.tx_begin_write ({ tables::unchecked }));
+		auto transaction (store.tx_begin_write ({ tables::unchecked, tables::unchecked_bodies }));
 		while (deleted_count++ < 2 * 1024 && !cleaning_list.empty ())
 		{
 			auto key (cleaning_list.front ());
 			cleaning_list.pop_front ();
-			if (!store.unchecked_del (transaction, key))
+			if (!unchecked.del (transaction, key))
 			{
 				debug_assert (ledger.cache.unchecked_count > 0);
 				--ledger.cache.unchecked_count;
@@ -975,6 +1061,97 @@ void nano::node::ongoing_unchecked_cleanup ()
 	});
 }
 
+uint64_t nano::node::ledger_pruning (uint64_t const batch_size_a)
+{
+	// Collect the highest block to prune in each account of this pass, the read transaction is bounded by the number of accounts visited
+	std::deque<nano::block_hash> pruning_targets;
+	{
+		auto transaction (store.tx_begin_read ());
+		auto i (store.confirmation_height_begin (transaction, pruning_cursor));
+		auto n (store.confirmation_height_end ());
+		for (size_t visited (0); i != n && visited < 64 * 1024 && !stopped; ++i, ++visited)
+		{
+			auto target (pruning_target (transaction, i->first, i->second));
+			if (!target.is_zero ())
+			{
+				pruning_targets.push_back (target);
+			}
+		}
+		pruning_cursor = (i != n) ? nano::account (i->first) : nano::account (0);
+	}
+	// Delete in batches, waiting in the write database queue like other ledger writers
+	uint64_t pruned_count (0);
+	while (!pruning_targets.empty () && !stopped)
+	{
+		auto scoped_write_guard = write_database_queue.wait (nano::writer::pruning);
+		auto transaction (store.tx_begin_write ({ tables::blocks, tables::cached_counts, tables::pruned }));
+		uint64_t batch_count (0);
+		while (!pruning_targets.empty () && batch_count < batch_size_a)
+		{
+			batch_count += ledger.pruning_action (transaction, pruning_targets.front (), batch_size_a);
+			pruning_targets.pop_front ();
+		}
+		pruned_count += batch_count;
+	}
+	if (pruned_count > 0)
+	{
+		logger.always_log (boost::str (boost::format ("Pruned %1% blocks") % pruned_count));
+	}
+	return pruned_count;
+}
+
+nano::block_hash nano::node::pruning_target (nano::transaction const & transaction_a, nano::account const & account_a, nano::confirmation_height_info const & info_a)
+{
+	nano::block_hash result (0);
+	if (info_a.height > config.pruning_depth)
+	{
+		// Blocks above the target must include one with a representative, rolling back a block above the cemented frontier walks down to it
+		auto frontier (store.block_get (transaction_a, info_a.frontier));
+		debug_assert (frontier != nullptr);
+		if (ledger.account_heights_index && !frontier->representative ().is_zero ())
+		{
+			result = store.account_height_get (transaction_a, account_a, info_a.height - config.pruning_depth);
+		}
+		else
+		{
+			auto hash (info_a.frontier);
+			auto representative_found (false);
+			for (uint64_t kept (0); !hash.is_zero () && (kept < config.pruning_depth || !representative_found); ++kept)
+			{
+				auto block (kept == 0 ? frontier : store.block_get (transaction_a, hash));
+				if (block == nullptr)
+				{
+					// Reached the blocks pruned by an earlier pass
+					hash.clear ();
+				}
+				else
+				{
+					representative_found = representative_found || !block->representative ().is_zero ();
+					hash = block->previous ();
+				}
+			}
+			result = hash;
+		}
+		if (!result.is_zero () && !store.block_exists (transaction_a, result))
+		{
+			// Already pruned by an earlier pass
+			result.clear ();
+		}
+	}
+	return result;
+}
+
+void nano::node::ongoing_ledger_pruning ()
+{
+	ledger_pruning (2 * 1024);
+	auto this_l (shared ());
+	alarm.add (std::chrono::steady_clock::now () + network_params.node.pruning_interval, [this_l]() {
+		this_l->worker.push_task ([this_l]() {
+			this_l->ongoing_ledger_pruning ();
+		});
+	});
+}
+
 int nano::node::price (nano::uint128_t const & balance_a, int amount_a)
 {
 	debug_assert (balance_a >= amount_a * nano::Gxrb_ratio);
@@ -1369,7 +1546,7 @@ nano::node_flags const & nano::inactive_node_flag_defaults ()
 	return node_flags;
 }
 
-std::unique_ptr<nano::block_store> nano::make_store (nano::logger_mt & logger, boost::filesystem::path const & path, bool read_only, bool add_db_postfix, nano::rocksdb_config const & rocksdb_config, nano::txn_tracking_config const & txn_tracking_config_a, std::chrono::milliseconds block_processor_batch_max_time_a, int lmdb_max_dbs, size_t batch_size, bool backup_before_upgrade, bool use_rocksdb_backend)
+std::unique_ptr<nano::block_store> nano::make_store (nano::logger_mt & logger, boost::filesystem::path const & path, bool read_only, bool add_db_postfix, nano::rocksdb_config const & rocksdb_config, nano::txn_tracking_config const & txn_tracking_config_a, std::chrono::milliseconds block_processor_batch_max_time_a, int lmdb_max_dbs, size_t batch_size, bool backup_before_upgrade, bool use_rocksdb_backend, nano::stat * stats)
 {
 #if NANO_ROCKSDB
 	auto make_rocksdb = [&logger, add_db_postfix, &path, &rocksdb_config, read_only]() {
@@ -1400,5 +1577,5 @@ std::unique_ptr<nano::block_store> nano::make_store (nano::logger_mt & logger, b
 #endif
 	}
 
-	return std::make_unique<nano::mdb_store> (logger, add_db_postfix ? path / "data.ldb" : path, txn_tracking_config_a, block_processor_batch_max_time_a, lmdb_max_dbs, batch_size, backup_before_upgrade);
+	return std::make_unique<nano::mdb_store> (logger, add_db_postfix ? path / "data.ldb" : path, txn_tracking_config_a, block_processor_batch_max_time_a, lmdb_max_dbs, batch_size, backup_before_upgrade, stats);
 }
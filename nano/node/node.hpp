@@ -22,6 +22,7 @@
 #include <nano/node/request_aggregator.hpp>
 #include <nano/node/signatures.hpp>
 #include <nano/node/telemetry.hpp>
+#include <nano/node/unchecked_map.hpp>
 #include <nano/node/vote_processor.hpp>
 #include <nano/node/wallet.hpp>
 #include <nano/node/write_database_queue.hpp>
@@ -121,10 +122,13 @@ public:
 	void ongoing_store_flush ();
 	void ongoing_peer_store ();
 	void ongoing_unchecked_cleanup ();
+	void ongoing_ledger_pruning ();
 	void backup_wallet ();
 	void search_pending ();
 	void bootstrap_wallet ();
 	void unchecked_cleanup ();
+	/** Prunes the accounts visited by one pass over the confirmation heights, deleting blocks in write transactions of \p batch_size_a blocks. Returns the number of blocks pruned */
+	uint64_t ledger_pruning (uint64_t const batch_size_a);
 	int price (nano::uint128_t const &, int);
 	bool local_work_generation_enabled () const;
 	bool work_generation_enabled () const;
@@ -164,7 +168,9 @@ public:
 	nano::wallets_store & wallets_store;
 	nano::gap_cache gap_cache;
 	nano::ledger ledger;
+	nano::unchecked_map unchecked;
 	nano::signature_checker checker;
+	nano::signature_cache signature_cache;
 	nano::network network;
 	nano::telemetry telemetry;
 	nano::bootstrap_initiator bootstrap_initiator;
@@ -206,6 +212,10 @@ public:
 
 private:
 	void long_inactivity_cleanup ();
+	/** Returns the highest block of the account which can be pruned, zero if there is none */
+	nano::block_hash pruning_target (nano::transaction const &, nano::account const &, nano::confirmation_height_info const &);
+	/** Account the next pruning pass starts from */
+	nano::account pruning_cursor{ 0 };
 };
 
 std::unique_ptr<container_info_component> collect_container_info (node & node, const std::string & name);
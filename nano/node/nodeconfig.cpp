@@ -102,6 +102,13 @@ nano::error nano::node_config::serialize_toml (nano::tomlconfig & toml) const
 	toml.put ("max_work_generate_multiplier", max_work_generate_multiplier, "Maximum allowed difficulty multiplier for work generation.\ntype:double,[1..]");
 	toml.put ("frontiers_confirmation", serialize_frontiers_confirmation (frontiers_confirmation), "Mode controlling frontier confirmation rate.\ntype:string,{auto,always,disabled}");
 	toml.put ("max_queued_requests", max_queued_requests, "Limit for number of queued confirmation requests for one channel, after which new requests are dropped until the queue drops below this value.\ntype:uint32");
+	toml.put ("vote_processor_threads", vote_processor_threads, "Number of threads processing incoming votes. Votes are distributed between them by representative.\ntype:uint64,[1..]");
+	toml.put ("unchecked_memory_size", unchecked_memory_size, "Maximum memory used to hold unchecked blocks, in megabytes. Beyond it the oldest are written to the ledger, the rest are written at shutdown. 0 writes every unchecked block to the ledger.\ntype:uint64");
+	toml.put ("group_commit_max_delay", group_commit_max_delay.count (), "Maximum time a ledger commit from a queued writer (block processor, confirmation height processor, pruning) can wait to be flushed to disk together with those of other queued writers. Other ledger commits, such as vote storage, online weight samples, peers and unchecked cleanup, are only flushed by the periodic store flush every 5 seconds, so a crash can lose up to 5 seconds of ledger writes when enabled. 0 flushes every commit, only applies to LMDB.\ntype:milliseconds");
+	toml.put ("enable_delegators_index", enable_delegators_index, "Maintain an index of the accounts delegating to each representative so the delegators and delegators_count RPCs don't scan every account. The index is built on startup once enabled and dropped once disabled.\ntype:bool");
+	toml.put ("enable_account_heights_index", enable_account_heights_index, "Maintain an index of block hashes by account and height so the account_history and chain RPCs seek to an offset instead of walking the account chain. The index is built on startup once enabled and dropped once disabled.\ntype:bool");
+	toml.put ("enable_pruning", enable_pruning, "Delete the bodies of old cemented blocks, keeping only their hash, account and height. Pruned blocks can't be served to bootstrapping peers or returned by RPCs. Pruning can't be undone, disabling it stops further pruning.\ntype:bool");
+	toml.put ("pruning_depth", pruning_depth, "Number of cemented blocks below the cemented frontier of each account which are kept when pruning.\ntype:uint64,[1..]");
 
 	auto work_peers_l (toml.create_array ("work_peers", "A list of \"address:port\" entries to identify work peers."));
 	for (auto i (work_peers.begin ()), n (work_peers.end ()); i != n; ++i)
@@ -335,6 +342,17 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		max_work_generate_difficulty = nano::difficulty::from_multiplier (max_work_generate_multiplier, network.publish_threshold);
 
 		toml.get<uint32_t> ("max_queued_requests", max_queued_requests);
+		toml.get<unsigned> ("vote_processor_threads", vote_processor_threads);
+		toml.get<size_t> ("unchecked_memory_size", unchecked_memory_size);
+
+		auto group_commit_max_delay_l = group_commit_max_delay.count ();
+		toml.get ("group_commit_max_delay", group_commit_max_delay_l);
+		group_commit_max_delay = std::chrono::milliseconds (group_commit_max_delay_l);
+
+		toml.get<bool> ("enable_delegators_index", enable_delegators_index);
+		toml.get<bool> ("enable_account_heights_index", enable_account_heights_index);
+		toml.get<bool> ("enable_pruning", enable_pruning);
+		toml.get<uint64_t> ("pruning_depth", pruning_depth);
 
 		if (toml.has_key ("frontiers_confirmation"))
 		{
@@ -367,6 +385,14 @@ nano::error nano::node_config::deserialize_toml (nano::tomlconfig & toml)
 		{
 			toml.get_error ().set ("io_threads must be non-zero");
 		}
+		if (vote_processor_threads == 0)
+		{
+			toml.get_error ().set ("vote_processor_threads must be non-zero");
+		}
+		if (pruning_depth == 0)
+		{
+			toml.get_error ().set ("pruning_depth must be non-zero");
+		}
 		if (active_elections_size <= 250 && !network.is_test_network ())
 		{
 			toml.get_error ().set ("active_elections_size must be greater than 250");
@@ -94,6 +94,18 @@ public:
 	double max_work_generate_multiplier{ 64. };
 	uint64_t max_work_generate_difficulty{ nano::network_constants::publish_full_threshold };
 	uint32_t max_queued_requests{ 512 };
+	unsigned vote_processor_threads{ std::max<unsigned> (1, std::thread::hardware_concurrency () / 4) };
+	/** Maximum memory used to hold unchecked blocks before writing them to the ledger, in megabytes */
+	size_t unchecked_memory_size{ 64 };
+	/** Longest a commit waits for a flush to disk shared with other queued ledger writers, 0 flushes every commit */
+	std::chrono::milliseconds group_commit_max_delay{ 0 };
+	/** Maintain an index of the accounts delegating to each representative, used by the delegators RPCs */
+	bool enable_delegators_index{ false };
+	/** Maintain an index of block hashes by account and height, used to seek account chains in the account_history and chain RPCs */
+	bool enable_account_heights_index{ false };
+	/** Delete the bodies of cemented blocks more than pruning_depth blocks below the cemented frontier of their account */
+	bool enable_pruning{ false };
+	uint64_t pruning_depth{ 1024 };
 	nano::rocksdb_config rocksdb_config;
 	nano::frontiers_confirmation_mode frontiers_confirmation{ nano::frontiers_confirmation_mode::automatic };
 	std::string serialize_frontiers_confirmation (nano::frontiers_confirmation_mode) const;
@@ -136,5 +148,7 @@ public:
 	size_t block_processor_batch_size{ 0 };
 	size_t block_processor_full_size{ 65536 };
 	size_t block_processor_verification_size{ 0 };
+	/** Number of recently verified signatures remembered, to skip verifying duplicate blocks and votes */
+	size_t signature_cache_size{ 64 * 1024 };
 };
 }
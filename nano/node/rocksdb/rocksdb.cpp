@@ -10,10 +10,13 @@
 
 #include <rocksdb/merge_operator.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/backupable_db.h>
 #include <rocksdb/utilities/transaction.h>
 #include <rocksdb/utilities/transaction_db.h>
 
+#include <unordered_set>
+
 namespace nano
 {
 template <>
@@ -52,8 +55,15 @@ rocksdb_config (rocksdb_config_a)
 
 	if (!error)
 	{
-		auto table_options = get_table_options ();
-		table_factory.reset (rocksdb::NewBlockBasedTableFactory (table_options));
+		// Block cache for reads, shared by all column families
+		block_cache = rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL);
+		table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_table_options (rocksdb_config.bloom_filter_bits)));
+		prefix_table_factory.reset (rocksdb::NewBlockBasedTableFactory (get_table_options (rocksdb_config.prefix_bloom_filter_bits)));
+		auto point_lookup_table_options = get_table_options (rocksdb_config.point_lookup_bloom_filter_bits);
+		// A hash index in each data block finds a key without a binary search through the block
+		point_lookup_table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+		point_lookup_table_options.data_block_hash_table_util_ratio = 0.75;
+		point_lookup_table_factory.reset (rocksdb::NewBlockBasedTableFactory (point_lookup_table_options));
 		if (!open_read_only_a)
 		{
 			construct_column_family_mutexes ();
@@ -74,11 +84,11 @@ nano::rocksdb_store::~rocksdb_store ()
 
 void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a)
 {
-	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height" };
+	std::initializer_list<const char *> names{ rocksdb::kDefaultColumnFamilyName.c_str (), "frontiers", "accounts", "blocks", "send", "receive", "open", "change", "state_blocks", "pending", "representation", "unchecked", "vote", "online_weight", "meta", "peers", "cached_counts", "confirmation_height", "delegators", "account_heights", "unchecked_bodies", "pruned" };
 	std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
 	for (const auto & cf_name : names)
 	{
-		column_families.emplace_back (cf_name, get_cf_options ());
+		column_families.emplace_back (cf_name, get_cf_options (cf_name));
 	}
 
 	auto options = get_db_options ();
@@ -102,14 +112,87 @@ void nano::rocksdb_store::open (bool & error_a, boost::filesystem::path const &
 
 	if (!error_a)
 	{
-		auto transaction = tx_begin_read ();
-		auto version_l = version_get (transaction);
+		auto version_l = version_get (tx_begin_read ());
+		cached_version = version_l;
 		if (version_l > version)
 		{
 			error_a = true;
 			logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) is too high for this node") % version_l));
 		}
+		else if (version_l < version)
+		{
+			if (open_read_only_a)
+			{
+				error_a = true;
+				logger.always_log (boost::str (boost::format ("The version of the ledger (%1%) needs upgrading, which requires write access") % version_l));
+			}
+			else
+			{
+				auto transaction (tx_begin_write ({ tables::blocks, tables::cached_counts, tables::change_blocks, tables::meta, tables::open_blocks, tables::receive_blocks, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::unchecked_bodies }));
+				if (version_l < 19)
+				{
+					// Ledgers written before the version was tracked report version 1, they have the same layout as version 18
+					upgrade_v18_to_v19 (transaction);
+				}
+				if (version_l < 22)
+				{
+					// Unchecked entries no longer hold the block, the old entries are dropped and requested again while bootstrapping
+					unchecked_clear (transaction);
+				}
+				// Other versions only add column families which start empty, these are created on open and populated by ledgers enabling the index or pruning
+				version_put (transaction, version);
+			}
+		}
+	}
+}
+
+void nano::rocksdb_store::upgrade_v18_to_v19 (nano::write_transaction & transaction_a)
+{
+	logger.always_log ("Preparing v18 to v19 database upgrade...");
+
+	std::pair<nano::tables, nano::block_type> legacy_tables[]{ { tables::send_blocks, nano::block_type::send }, { tables::receive_blocks, nano::block_type::receive }, { tables::open_blocks, nano::block_type::open }, { tables::change_blocks, nano::block_type::change }, { tables::state_blocks, nano::block_type::state } };
+	auto num = 0u;
+	for (auto const & legacy : legacy_tables)
+	{
+		auto type (legacy.second);
+		uint64_t moved (0);
+		std::unique_ptr<rocksdb::Iterator> i (db->NewIterator (rocksdb::ReadOptions (), table_to_column_family (legacy.first)));
+		for (i->SeekToFirst (); i->Valid (); i->Next (), ++num)
+		{
+			nano::rocksdb_val key (i->key ());
+			// Entries already in the merged table were written after the legacy ones and take precedence
+			if (!exists (transaction_a, tables::blocks, key))
+			{
+				std::vector<uint8_t> data;
+				data.reserve (1 + i->value ().size ());
+				data.push_back (static_cast<uint8_t> (type));
+				data.insert (data.end (), i->value ().data (), i->value ().data () + i->value ().size ());
+				auto status (put (transaction_a, tables::blocks, key, nano::rocksdb_val (data.size (), data.data ())));
+				release_assert (success (status));
+				++moved;
+			}
+
+			// Commit in batches to bound the size of the transaction, counts are written alongside so a restarted upgrade stays consistent
+			constexpr auto batch_size = 100000;
+			if (num > 0 && num % batch_size == 0)
+			{
+				block_count_add (transaction_a, type, moved);
+				moved = 0;
+				transaction_a.commit ();
+				transaction_a.renew ();
+				logger.always_log (boost::str (boost::format ("Database block table merge %1% blocks upgraded") % num));
+			}
+		}
+		block_count_add (transaction_a, type, moved);
+		// The merged entries must be durable before the legacy column family is cleared
+		transaction_a.commit ();
+		transaction_a.renew ();
+		auto status (drop (transaction_a, legacy.first));
+		release_assert (success (status));
 	}
+
+	version_put (transaction_a, 19);
+	logger.always_log ("Finished merging block tables");
 }
 
 nano::write_transaction nano::rocksdb_store::tx_begin_write (std::vector<nano::tables> const & tables_requiring_locks_a, std::vector<nano::tables> const & tables_no_locks_a)
@@ -159,6 +242,8 @@ rocksdb::ColumnFamilyHandle * nano::rocksdb_store::table_to_column_family (table
 			return get_handle ("frontiers");
 		case tables::accounts:
 			return get_handle ("accounts");
+		case tables::blocks:
+			return get_handle ("blocks");
 		case tables::send_blocks:
 			return get_handle ("send");
 		case tables::receive_blocks:
@@ -189,6 +274,14 @@ rocksdb::ColumnFamilyHandle * nano::rocksdb_store::table_to_column_family (table
 			return get_handle ("cached_counts");
 		case tables::confirmation_height:
 			return get_handle ("confirmation_height");
+		case tables::delegators:
+			return get_handle ("delegators");
+		case tables::account_heights:
+			return get_handle ("account_heights");
+		case tables::unchecked_bodies:
+			return get_handle ("unchecked_bodies");
+		case tables::pruned:
+			return get_handle ("pruned");
 		default:
 			release_assert (false);
 			return get_handle ("peers");
@@ -241,6 +334,7 @@ void nano::rocksdb_store::version_put (nano::write_transaction const & transacti
 	nano::uint256_union version_value (version_a);
 	auto status (put (transaction_a, tables::meta, version_key, nano::rocksdb_val (version_value)));
 	release_assert (success (status));
+	cached_version = version_a;
 }
 
 rocksdb::Transaction * nano::rocksdb_store::tx (nano::transaction const & transaction_a) const
@@ -273,7 +367,33 @@ int nano::rocksdb_store::get (nano::transaction const & transaction_a, tables ta
 	return status.code ();
 }
 
-/** The column families which need to have their counts cached for later querying */
+void nano::rocksdb_store::get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::rocksdb_val> const & keys_a, std::vector<nano::rocksdb_val> & values_a) const
+{
+	debug_assert (keys_a.size () == values_a.size ());
+	std::vector<rocksdb::ColumnFamilyHandle *> handles_l (keys_a.size (), table_to_column_family (table_a));
+	std::vector<rocksdb::Slice> keys_l (keys_a.begin (), keys_a.end ());
+	std::vector<std::string> values_l;
+	std::vector<rocksdb::Status> statuses;
+	if (is_read (transaction_a))
+	{
+		statuses = db->MultiGet (snapshot_options (transaction_a), handles_l, keys_l, &values_l);
+	}
+	else
+	{
+		statuses = tx (transaction_a)->MultiGet (rocksdb::ReadOptions (), handles_l, keys_l, &values_l);
+	}
+	for (size_t i (0); i < statuses.size (); ++i)
+	{
+		release_assert (statuses[i].ok () || statuses[i].IsNotFound ());
+		if (statuses[i].ok ())
+		{
+			values_a[i].buffer = std::make_shared<std::vector<uint8_t>> (values_l[i].begin (), values_l[i].end ());
+			values_a[i].convert_buffer_to_value ();
+		}
+	}
+}
+
+/** The column families which need to have their counts cached for later querying. The blocks column family is counted per block type in block_count_add () instead */
 bool nano::rocksdb_store::is_caching_counts (nano::tables table_a) const
 {
 	switch (table_a)
@@ -283,6 +403,7 @@ bool nano::rocksdb_store::is_caching_counts (nano::tables table_a) const
 		case tables::open_blocks:
 		case tables::change_blocks:
 		case tables::state_blocks:
+		case tables::pruned:
 			return true;
 		default:
 			return false;
@@ -333,6 +454,21 @@ int nano::rocksdb_store::put (nano::write_transaction const & transaction_a, tab
 	return txn->Put (table_to_column_family (table_a), key_a, value_a).code ();
 }
 
+uint64_t nano::rocksdb_store::transaction_sequence (nano::transaction const & transaction_a) const
+{
+	uint64_t result;
+	if (is_read (transaction_a))
+	{
+		result = snapshot_options (transaction_a).snapshot->GetSequenceNumber ();
+	}
+	else
+	{
+		// Each write in a commit takes the next sequence number, this is the number of the first write this transaction commits
+		result = db->GetLatestSequenceNumber () + 1;
+	}
+	return result;
+}
+
 bool nano::rocksdb_store::not_found (int status) const
 {
 	return (status_code_not_found () == status);
@@ -348,6 +484,11 @@ int nano::rocksdb_store::status_code_not_found () const
 	return static_cast<int> (rocksdb::Status::Code::kNotFound);
 }
 
+nano::tables nano::rocksdb_store::block_counts_table () const
+{
+	return tables::cached_counts;
+}
+
 uint64_t nano::rocksdb_store::count (nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle) const
 {
 	uint64_t count = 0;
@@ -383,11 +524,17 @@ size_t nano::rocksdb_store::count (nano::transaction const & transaction_a, tabl
 	}
 	else if (table_a == tables::unchecked)
 	{
-		for (auto i (unchecked_begin (transaction_a)), n (unchecked_end ()); i != n; ++i)
+		// Iterate the entries directly, unchecked_begin () would also read the body each one references
+		for (auto i (make_iterator<nano::unchecked_key, nano::rocksdb_val> (transaction_a, tables::unchecked)), n (nano::store_iterator<nano::unchecked_key, nano::rocksdb_val> (nullptr)); i != n; ++i)
 		{
 			++sum;
 		}
 	}
+	else if (table_a == tables::blocks)
+	{
+		// Counted per block type by block_count_add () rather than per column family
+		sum = block_count (transaction_a).sum ();
+	}
 	else
 	{
 		return count (transaction_a, table_to_column_family (table_a));
@@ -440,7 +587,7 @@ int nano::rocksdb_store::clear (rocksdb::ColumnFamilyHandle * column_family)
 	// Need to add it back as we just want to clear the contents
 	auto handle_it = std::find (handles.begin (), handles.end (), column_family);
 	debug_assert (handle_it != handles.cend ());
-	status = db->CreateColumnFamily (get_cf_options (), name, &column_family);
+	status = db->CreateColumnFamily (get_cf_options (name), name, &column_family);
 	release_assert (status.ok ());
 	*handle_it = column_family;
 	return status.code ();
@@ -479,18 +626,17 @@ rocksdb::Options nano::rocksdb_store::get_db_options () const
 	return db_options;
 }
 
-rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
+rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options (unsigned bloom_filter_bits_a) const
 {
 	rocksdb::BlockBasedTableOptions table_options;
 
 	// Block cache for reads
-	table_options.block_cache = rocksdb::NewLRUCache (rocksdb_config.block_cache * 1024 * 1024ULL);
+	table_options.block_cache = block_cache;
 
 	// Bloom filter to help with point reads
-	auto bloom_filter_bits = rocksdb_config.bloom_filter_bits;
-	if (bloom_filter_bits > 0)
+	if (bloom_filter_bits_a > 0)
 	{
-		table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (bloom_filter_bits, false));
+		table_options.filter_policy.reset (rocksdb::NewBloomFilterPolicy (bloom_filter_bits_a, false));
 	}
 
 	// Increasing block_size decreases memory usage and space amplification, but increases read amplification.
@@ -503,7 +649,7 @@ rocksdb::BlockBasedTableOptions nano::rocksdb_store::get_table_options () const
 	return table_options;
 }
 
-rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
+rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options (std::string const & cf_name_a) const
 {
 	rocksdb::ColumnFamilyOptions cf_options;
 	cf_options.table_factory = table_factory;
@@ -532,12 +678,38 @@ rocksdb::ColumnFamilyOptions nano::rocksdb_store::get_cf_options () const
 	// Number of memtables to keep in memory (1 active, rest inactive/immutable)
 	cf_options.max_write_buffer_number = rocksdb_config.num_memtables;
 
+	if (rocksdb_config.table_profiles)
+	{
+		static std::unordered_set<std::string> const point_lookup_tables{ "blocks", "send", "receive", "open", "change", "state_blocks" };
+		if (point_lookup_tables.count (cf_name_a) > 0)
+		{
+			// Blocks are only read by hash, the memtable is also checked against a bloom filter of whole keys before searching it
+			cf_options.table_factory = point_lookup_table_factory;
+			cf_options.memtable_whole_key_filtering = true;
+			cf_options.memtable_prefix_bloom_size_ratio = 0.02;
+		}
+		else if (cf_name_a == "pending" || cf_name_a == "unchecked")
+		{
+			// Keys start with an account or the hash of a dependency, and are read by seeking to the first key with that prefix
+			cf_options.prefix_extractor.reset (rocksdb::NewFixedPrefixTransform (sizeof (nano::block_hash)));
+			cf_options.table_factory = prefix_table_factory;
+			cf_options.memtable_prefix_bloom_size_ratio = 0.02;
+		}
+		else if (cf_name_a == "peers" || cf_name_a == "online_weight")
+		{
+			// Rarely written and hold few entries, a full size memtable would mostly sit empty
+			cf_options.write_buffer_size = 1024ULL * 1024 * rocksdb_config.small_memtable_size;
+			cf_options.target_file_size_base = 1024ULL * 1024 * rocksdb_config.small_memtable_size;
+			cf_options.max_bytes_for_level_base = 1024ULL * 1024 * 4 * rocksdb_config.small_memtable_size;
+		}
+	}
+
 	return cf_options;
 }
 
 std::vector<nano::tables> nano::rocksdb_store::all_tables () const
 {
-	return std::vector<nano::tables>{ tables::accounts, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::vote };
+	return std::vector<nano::tables>{ tables::account_heights, tables::accounts, tables::blocks, tables::cached_counts, tables::change_blocks, tables::confirmation_height, tables::delegators, tables::frontiers, tables::meta, tables::online_weight, tables::open_blocks, tables::peers, tables::pending, tables::pruned, tables::receive_blocks, tables::representation, tables::send_blocks, tables::state_blocks, tables::unchecked, tables::unchecked_bodies, tables::vote };
 }
 
 bool nano::rocksdb_store::copy_db (boost::filesystem::path const & destination_path)
@@ -608,6 +780,17 @@ bool nano::rocksdb_store::copy_db (boost::filesystem::path const & destination_p
 	return false;
 }
 
+void nano::rocksdb_store::compact ()
+{
+	for (auto handle : handles)
+	{
+		auto status (db->Flush (rocksdb::FlushOptions{}, handle));
+		release_assert (status.ok ());
+		status = db->CompactRange (rocksdb::CompactRangeOptions{}, handle, nullptr, nullptr);
+		release_assert (status.ok ());
+	}
+}
+
 void nano::rocksdb_store::rebuild_db (nano::write_transaction const & transaction_a)
 {
 	release_assert (false && "Not available for RocksDB");
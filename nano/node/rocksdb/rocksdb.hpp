@@ -35,10 +35,12 @@ public:
 
 	bool block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) const override;
 	size_t count (nano::transaction const & transaction_a, tables table_a) const override;
+	tables block_counts_table () const override;
 	void version_put (nano::write_transaction const &, int) override;
 
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a) const;
 	int get (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, nano::rocksdb_val & value_a) const;
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::rocksdb_val> const & keys_a, std::vector<nano::rocksdb_val> & values_a) const;
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, nano::rocksdb_val const & value_a);
 	int del (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a);
 
@@ -56,6 +58,8 @@ public:
 
 	bool copy_db (boost::filesystem::path const & destination) override;
 	void rebuild_db (nano::write_transaction const & transaction_a) override;
+	/** Flushes the memtables of every column family and compacts their files, so reads afterwards are served from compacted table files */
+	void compact ();
 
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
@@ -69,8 +73,24 @@ public:
 		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), key));
 	}
 
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key, size_t prefix_size_a) const
+	{
+		return nano::store_iterator<Key, Value> (std::make_unique<nano::rocksdb_iterator<Key, Value>> (db, transaction_a, table_to_column_family (table_a), key, prefix_size_a));
+	}
+
 	bool init_error () const override;
 
+	void deferred_sync_set (bool) override
+	{
+		// Do nothing, commits are appended to the write-ahead log without syncing it
+	}
+
+	void sync () override
+	{
+		// Do nothing
+	}
+
 private:
 	bool error{ false };
 	nano::logger_mt & logger;
@@ -78,7 +98,10 @@ private:
 	// Optimistic transactions are used in write mode
 	rocksdb::OptimisticTransactionDB * optimistic_db = nullptr;
 	rocksdb::DB * db = nullptr;
+	std::shared_ptr<rocksdb::Cache> block_cache;
 	std::shared_ptr<rocksdb::TableFactory> table_factory;
+	std::shared_ptr<rocksdb::TableFactory> prefix_table_factory;
+	std::shared_ptr<rocksdb::TableFactory> point_lookup_table_factory;
 	std::unordered_map<nano::tables, std::mutex> write_lock_mutexes;
 
 	rocksdb::Transaction * tx (nano::transaction const & transaction_a) const;
@@ -87,21 +110,23 @@ private:
 	bool not_found (int status) const override;
 	bool success (int status) const override;
 	int status_code_not_found () const override;
+	uint64_t transaction_sequence (nano::transaction const & transaction_a) const override;
 	int drop (nano::write_transaction const &, tables) override;
 
 	rocksdb::ColumnFamilyHandle * table_to_column_family (tables table_a) const;
 	int clear (rocksdb::ColumnFamilyHandle * column_family);
 
 	void open (bool & error_a, boost::filesystem::path const & path_a, bool open_read_only_a);
+	void upgrade_v18_to_v19 (nano::write_transaction &);
 	uint64_t count (nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle) const;
 	bool is_caching_counts (nano::tables table_a) const;
 
 	int increment (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
 	int decrement (nano::write_transaction const & transaction_a, tables table_a, nano::rocksdb_val const & key_a, uint64_t amount_a);
-	rocksdb::ColumnFamilyOptions get_cf_options () const;
+	rocksdb::ColumnFamilyOptions get_cf_options (std::string const & cf_name_a) const;
 	void construct_column_family_mutexes ();
 	rocksdb::Options get_db_options () const;
-	rocksdb::BlockBasedTableOptions get_table_options () const;
+	rocksdb::BlockBasedTableOptions get_table_options (unsigned bloom_filter_bits_a) const;
 	nano::rocksdb_config rocksdb_config;
 };
 
@@ -21,6 +21,21 @@ inline rocksdb::ReadOptions const & snapshot_options (nano::transaction const &
 	debug_assert (is_read (transaction_a));
 	return *static_cast<const rocksdb::ReadOptions *> (transaction_a.get_handle ());
 }
+
+/** Iterators walking past the end of a key prefix ignore the prefix extractor of column families which have one */
+inline rocksdb::ReadOptions total_order (rocksdb::ReadOptions options_a)
+{
+	options_a.total_order_seek = true;
+	return options_a;
+}
+
+/** Iterators staying within the prefix of their seek key can use the prefix extractor and its bloom filter, \p upper_bound_a also ends them in column families without one */
+inline rocksdb::ReadOptions same_prefix (rocksdb::ReadOptions options_a, rocksdb::Slice const * upper_bound_a)
+{
+	options_a.prefix_same_as_start = true;
+	options_a.iterate_upper_bound = upper_bound_a;
+	return options_a;
+}
 }
 
 namespace nano
@@ -36,13 +51,13 @@ public:
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
 		{
-			iter = db->NewIterator (snapshot_options (transaction_a), handle_a);
+			iter = db->NewIterator (total_order (snapshot_options (transaction_a)), handle_a);
 		}
 		else
 		{
 			rocksdb::ReadOptions ropts;
 			ropts.fill_cache = false;
-			iter = tx (transaction_a)->GetIterator (ropts, handle_a);
+			iter = tx (transaction_a)->GetIterator (total_order (ropts), handle_a);
 		}
 
 		cursor.reset (iter);
@@ -61,16 +76,27 @@ public:
 
 	rocksdb_iterator () = default;
 
-	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const & val_a)
+	/** Seeks to \p val_a. A non-zero \p prefix_size_a ends the iterator after the last key sharing the first \p prefix_size_a bytes of \p val_a */
+	rocksdb_iterator (rocksdb::DB * db, nano::transaction const & transaction_a, rocksdb::ColumnFamilyHandle * handle_a, rocksdb_val const & val_a, size_t prefix_size_a = 0)
 	{
+		auto options (is_read (transaction_a) ? snapshot_options (transaction_a) : rocksdb::ReadOptions ());
+		if (prefix_size_a > 0)
+		{
+			upper_bound = std::make_unique<prefix_bound> (val_a, prefix_size_a);
+			options = same_prefix (options, upper_bound->slice ());
+		}
+		else
+		{
+			options = total_order (options);
+		}
 		rocksdb::Iterator * iter;
 		if (is_read (transaction_a))
 		{
-			iter = db->NewIterator (snapshot_options (transaction_a), handle_a);
+			iter = db->NewIterator (options, handle_a);
 		}
 		else
 		{
-			iter = tx (transaction_a)->GetIterator (rocksdb::ReadOptions (), handle_a);
+			iter = tx (transaction_a)->GetIterator (options, handle_a);
 		}
 
 		cursor.reset (iter);
@@ -89,6 +115,7 @@ public:
 
 	rocksdb_iterator (nano::rocksdb_iterator<T, U> && other_a)
 	{
+		upper_bound = std::move (other_a.upper_bound);
 		cursor = other_a.cursor;
 		other_a.cursor = nullptr;
 		current = other_a.current;
@@ -177,11 +204,50 @@ public:
 	nano::rocksdb_iterator<T, U> & operator= (nano::rocksdb_iterator<T, U> && other_a)
 	{
 		cursor = std::move (other_a.cursor);
+		upper_bound = std::move (other_a.upper_bound);
 		current = other_a.current;
 		return *this;
 	}
 	nano::store_iterator_impl<T, U> & operator= (nano::store_iterator_impl<T, U> const &) = delete;
 
+private:
+	/** First key past a prefix, held at a fixed address as the read options of the cursor point to it */
+	class prefix_bound final
+	{
+	public:
+		prefix_bound (rocksdb::Slice const & key_a, size_t prefix_size_a) :
+		bytes (key_a.data (), key_a.data () + prefix_size_a)
+		{
+			debug_assert (prefix_size_a <= key_a.size ());
+			// Increment the prefix as a big endian number, a prefix of only 0xff bytes has no key past it
+			auto i (bytes.rbegin ());
+			for (; i != bytes.rend () && static_cast<uint8_t> (*i) == 0xff; ++i)
+			{
+				*i = 0;
+			}
+			if (i != bytes.rend ())
+			{
+				*i = static_cast<char> (static_cast<uint8_t> (*i) + 1);
+			}
+			else
+			{
+				bytes.clear ();
+			}
+			bound = rocksdb::Slice (bytes.data (), bytes.size ());
+		}
+		rocksdb::Slice const * slice () const
+		{
+			return bytes.empty () ? nullptr : &bound;
+		}
+
+	private:
+		std::vector<char> bytes;
+		rocksdb::Slice bound;
+	};
+
+public:
+	/** Declared before the cursor so it outlives it */
+	std::unique_ptr<prefix_bound> upper_bound;
 	std::unique_ptr<rocksdb::Iterator> cursor;
 	std::pair<nano::rocksdb_val, nano::rocksdb_val> current;
 
@@ -1,13 +1,17 @@
 #include <nano/boost/asio/post.hpp>
+#include <nano/crypto_lib/random_pool.hpp>
 #include <nano/lib/locks.hpp>
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/threading.hpp>
 #include <nano/node/signatures.hpp>
 
-nano::signature_checker::signature_checker (unsigned num_threads) :
+#include <crypto/cryptopp/siphash.h>
+
+nano::signature_checker::signature_checker (unsigned num_threads, std::chrono::microseconds max_delay_a) :
 thread_pool (num_threads),
 single_threaded (num_threads == 0),
-num_threads (num_threads)
+num_threads (num_threads),
+max_delay (max_delay_a)
 {
 	if (!single_threaded)
 	{
@@ -31,14 +35,21 @@ void nano::signature_checker::verify (nano::signature_check_set & check_a)
 		}
 	}
 
-	if (check_a.size < multithreaded_cutoff || single_threaded)
+	if (single_threaded || check_a.size <= batch_size)
 	{
-		// Not dealing with many so just use the calling thread for checking signatures
+		// No thread pool or no more than one batch, so just use the calling thread for checking signatures rather than waiting on a hop to the pool
 		auto result = verify_batch (check_a, 0, check_a.size);
 		release_assert (result);
 		return;
 	}
 
+	if (check_a.size < multithreaded_cutoff)
+	{
+		// Not dealing with many, so let the shared queue coalesce them with submissions from other callers
+		verify_coalesced (check_a);
+		return;
+	}
+
 	// Split up the tasks equally over the calling thread and the thread pool.
 	// Any overflow on the modulus of the batch_size is given to the calling thread, so the thread pool
 	// only ever operates on batch_size sizes.
@@ -64,7 +75,7 @@ void nano::signature_checker::verify (nano::signature_check_set & check_a)
 	std::future<void> future = promise.get_future ();
 
 	// Verify a number of signature batches over the thread pool (does not block)
-	verify_async (check_a, num_full_batches_thread, promise);
+	verify_batches_async (check_a, num_full_batches_thread, promise);
 
 	// Verify the rest on the calling thread, this operates on the signatures at the end of the check set
 	auto result = verify_batch (check_a, check_a.size - size_calling_thread, size_calling_thread);
@@ -74,6 +85,154 @@ void nano::signature_checker::verify (nano::signature_check_set & check_a)
 	future.wait ();
 }
 
+void nano::signature_checker::verify_coalesced (nano::signature_check_set & check_a)
+{
+	if (single_threaded || check_a.size >= multithreaded_cutoff)
+	{
+		verify (check_a);
+	}
+	else
+	{
+		std::promise<void> promise;
+		std::future<void> future = promise.get_future ();
+		verify_async (check_a, [&promise]() { promise.set_value (); });
+		future.wait ();
+	}
+}
+
+void nano::signature_checker::verify_async (nano::signature_check_set & check_a, std::function<void()> const & callback_a)
+{
+	nano::unique_lock<std::mutex> lock (mutex);
+	if (stopped || check_a.size == 0)
+	{
+		lock.unlock ();
+		callback_a ();
+		return;
+	}
+	if (single_threaded)
+	{
+		lock.unlock ();
+		auto result = verify_batch (check_a, 0, check_a.size);
+		release_assert (result);
+		callback_a ();
+		return;
+	}
+	++tasks_remaining;
+	auto post_runner (false);
+	{
+		nano::lock_guard<std::mutex> guard (queue_mutex);
+		queue.push_back (std::make_shared<queued_set> (check_a, callback_a));
+		queued_signatures += check_a.size;
+		// Another runner is only needed once there is a full batch, a waiting runner picks up anything less
+		if (queue_runners < num_threads && (queue_runners == 0 || queued_signatures >= batch_size))
+		{
+			++queue_runners;
+			post_runner = true;
+		}
+	}
+	queue_condition.notify_all ();
+	// While all runners are busy, new submissions accumulate in the queue and are picked up together
+	if (post_runner)
+	{
+		boost::asio::post (thread_pool, [this]() {
+			this->process_queue ();
+		});
+	}
+}
+
+void nano::signature_checker::process_queue ()
+{
+	class chunk final
+	{
+	public:
+		std::shared_ptr<queued_set> set;
+		size_t start;
+		size_t size;
+	};
+	std::vector<chunk> chunks;
+	std::vector<unsigned char const *> messages;
+	std::vector<size_t> lengths;
+	std::vector<unsigned char const *> pub_keys;
+	std::vector<unsigned char const *> signatures;
+	std::vector<nano::prepared_public_key const *> prepared_keys;
+	std::vector<int> verifications;
+	nano::unique_lock<std::mutex> lock (queue_mutex);
+	while (!queue.empty ())
+	{
+		// Give other callers until the oldest submission has used up the latency budget to fill the batch
+		auto deadline (queue.front ()->queued_at + max_delay);
+		while (queued_signatures < batch_size && !queue.empty () && queue_condition.wait_until (lock, deadline) == std::cv_status::no_timeout)
+		{
+		}
+		if (queue.empty ())
+		{
+			// Taken by another runner while waiting
+			continue;
+		}
+		// Fill a batch from the front of the shared queue, possibly spanning several submitted sets
+		chunks.clear ();
+		size_t count (0);
+		while (count < batch_size && !queue.empty ())
+		{
+			auto set (queue.front ());
+			auto size (std::min (batch_size - count, set->check.size - set->next));
+			chunks.push_back ({ set, set->next, size });
+			set->next += size;
+			count += size;
+			queued_signatures -= size;
+			if (set->next == set->check.size)
+			{
+				queue.pop_front ();
+			}
+		}
+		lock.unlock ();
+
+		messages.clear ();
+		lengths.clear ();
+		pub_keys.clear ();
+		signatures.clear ();
+		prepared_keys.clear ();
+		auto any_prepared (false);
+		verifications.assign (count, 0);
+		for (auto const & chunk : chunks)
+		{
+			auto const & check (chunk.set->check);
+			messages.insert (messages.end (), check.messages + chunk.start, check.messages + chunk.start + chunk.size);
+			lengths.insert (lengths.end (), check.message_lengths + chunk.start, check.message_lengths + chunk.start + chunk.size);
+			pub_keys.insert (pub_keys.end (), check.pub_keys + chunk.start, check.pub_keys + chunk.start + chunk.size);
+			signatures.insert (signatures.end (), check.signatures + chunk.start, check.signatures + chunk.start + chunk.size);
+			if (check.prepared_keys != nullptr)
+			{
+				prepared_keys.insert (prepared_keys.end (), check.prepared_keys + chunk.start, check.prepared_keys + chunk.start + chunk.size);
+				any_prepared = true;
+			}
+			else
+			{
+				prepared_keys.insert (prepared_keys.end (), chunk.size, nullptr);
+			}
+		}
+		nano::signature_check_set batch (count, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data (), any_prepared ? prepared_keys.data () : nullptr);
+		auto result = verify_batch (batch, 0, count);
+		release_assert (result);
+		++batches;
+
+		// Scatter the results back to the submitted sets and notify the completed ones
+		size_t offset (0);
+		for (auto const & chunk : chunks)
+		{
+			std::copy (verifications.begin () + offset, verifications.begin () + offset + chunk.size, chunk.set->check.verifications + chunk.start);
+			offset += chunk.size;
+			if ((chunk.set->remaining -= chunk.size) == 0)
+			{
+				chunk.set->callback ();
+				--tasks_remaining;
+			}
+		}
+		lock.lock ();
+	}
+	--queue_runners;
+}
+
 void nano::signature_checker::stop ()
 {
 	nano::lock_guard<std::mutex> guard (mutex);
@@ -84,6 +243,11 @@ void nano::signature_checker::stop ()
 	}
 }
 
+uint64_t nano::signature_checker::queue_batches () const
+{
+	return batches;
+}
+
 void nano::signature_checker::flush ()
 {
 	nano::lock_guard<std::mutex> guard (mutex);
@@ -94,7 +258,15 @@ void nano::signature_checker::flush ()
 bool nano::signature_checker::verify_batch (const nano::signature_check_set & check_a, size_t start_index, size_t size)
 {
 	/* Returns false if there are at least 1 invalid signature */
-	auto code (nano::validate_message_batch (check_a.messages + start_index, check_a.message_lengths + start_index, check_a.pub_keys + start_index, check_a.signatures + start_index, size, check_a.verifications + start_index));
+	bool code;
+	if (check_a.prepared_keys != nullptr)
+	{
+		code = nano::validate_message_batch (check_a.messages + start_index, check_a.message_lengths + start_index, check_a.pub_keys + start_index, check_a.prepared_keys + start_index, check_a.signatures + start_index, size, check_a.verifications + start_index);
+	}
+	else
+	{
+		code = nano::validate_message_batch (check_a.messages + start_index, check_a.message_lengths + start_index, check_a.pub_keys + start_index, check_a.signatures + start_index, size, check_a.verifications + start_index);
+	}
 	(void)code;
 
 	return std::all_of (check_a.verifications + start_index, check_a.verifications + start_index + size, [](int verification) { return verification == 0 || verification == 1; });
@@ -103,7 +275,7 @@ bool nano::signature_checker::verify_batch (const nano::signature_check_set & ch
 /* This operates on a number of signatures of size (num_batches * batch_size) from the beginning of the check_a pointers.
  * Caller should check the value of the promise which indicateswhen the work has been completed.
  */
-void nano::signature_checker::verify_async (nano::signature_check_set & check_a, size_t num_batches, std::promise<void> & promise)
+void nano::signature_checker::verify_batches_async (nano::signature_check_set & check_a, size_t num_batches, std::promise<void> & promise)
 {
 	auto task = std::make_shared<Task> (check_a, num_batches);
 	++tasks_remaining;
@@ -168,3 +340,117 @@ void nano::signature_checker::set_thread_names (unsigned num_threads)
 	}
 	debug_assert (pending == 0);
 }
+
+nano::signature_cache::signature_cache (size_t size_a, size_t stripes_a)
+{
+	debug_assert (stripes_a > 0);
+	auto stripe_size (std::max<size_t> (1, size_a / stripes_a));
+	stripes.reserve (stripes_a);
+	for (auto i (0); i < stripes_a; ++i)
+	{
+		stripes.push_back (std::make_unique<stripe> ());
+		stripes.back ()->items.assign (stripe_size, nano::uint128_t{ 0 });
+	}
+	nano::random_pool::generate_block (key.bytes.data (), key.bytes.size ());
+}
+
+bool nano::signature_cache::contains (nano::block_hash const & message_a, nano::public_key const & pub_key_a, nano::signature const & signature_a)
+{
+	auto digest_l (digest (message_a, pub_key_a, signature_a));
+	auto location (locate (digest_l));
+	nano::lock_guard<std::mutex> guard (location.first.mutex);
+	return location.first.items[location.second] == digest_l;
+}
+
+void nano::signature_cache::insert (nano::block_hash const & message_a, nano::public_key const & pub_key_a, nano::signature const & signature_a)
+{
+	auto digest_l (digest (message_a, pub_key_a, signature_a));
+	auto location (locate (digest_l));
+	nano::lock_guard<std::mutex> guard (location.first.mutex);
+	// Replace likely old element with a new one
+	location.first.items[location.second] = digest_l;
+}
+
+void nano::signature_cache::clear ()
+{
+	for (auto & stripe_l : stripes)
+	{
+		nano::lock_guard<std::mutex> guard (stripe_l->mutex);
+		stripe_l->items.assign (stripe_l->items.size (), nano::uint128_t{ 0 });
+	}
+}
+
+size_t nano::signature_cache::size () const
+{
+	return stripes.size () * stripes.front ()->items.size ();
+}
+
+std::pair<nano::signature_cache::stripe &, size_t> nano::signature_cache::locate (nano::uint128_t const & digest_a)
+{
+	auto & stripe_l (*stripes[static_cast<size_t> (digest_a % stripes.size ())]);
+	auto index (static_cast<size_t> ((digest_a / stripes.size ()) % stripe_l.items.size ()));
+	return { stripe_l, index };
+}
+
+nano::uint128_t nano::signature_cache::digest (nano::block_hash const & message_a, nano::public_key const & pub_key_a, nano::signature const & signature_a) const
+{
+	nano::uint128_union digest_l{ 0 };
+	CryptoPP::SipHash<2, 4, true> siphash (key.bytes.data (), static_cast<unsigned int> (key.bytes.size ()));
+	siphash.Update (message_a.bytes.data (), message_a.bytes.size ());
+	siphash.Update (pub_key_a.bytes.data (), pub_key_a.bytes.size ());
+	siphash.Update (signature_a.bytes.data (), signature_a.bytes.size ());
+	siphash.Final (digest_l.bytes.data ());
+	return digest_l.number ();
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (signature_cache & signature_cache, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "items", signature_cache.size (), sizeof (nano::uint128_t) }));
+	return composite;
+}
+
+void nano::prepared_key_cache::update (std::vector<nano::public_key> const & keys_a)
+{
+	auto current (snapshot ());
+	auto updated (std::make_shared<map> ());
+	for (auto const & key : keys_a)
+	{
+		auto existing (current->find (key));
+		if (existing != current->end ())
+		{
+			updated->emplace (key, existing->second);
+		}
+		else
+		{
+			bool error (false);
+			auto prepared (std::make_shared<nano::prepared_public_key> (error, key));
+			if (!error)
+			{
+				updated->emplace (key, prepared);
+			}
+		}
+	}
+	nano::lock_guard<std::mutex> guard (mutex);
+	keys = updated;
+}
+
+std::shared_ptr<nano::prepared_key_cache::map const> nano::prepared_key_cache::snapshot () const
+{
+	nano::lock_guard<std::mutex> guard (mutex);
+	return keys;
+}
+
+size_t nano::prepared_key_cache::size () const
+{
+	return snapshot ()->size ();
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (prepared_key_cache & prepared_key_cache, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	auto keys (prepared_key_cache.snapshot ());
+	auto sizeof_element (sizeof (nano::prepared_key_cache::map::value_type) + sizeof (nano::prepared_public_key));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "keys", keys->size (), sizeof_element }));
+	return composite;
+}
@@ -1,19 +1,25 @@
 #pragma once
 
 #include <nano/boost/asio/thread_pool.hpp>
+#include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <future>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace nano
 {
 class signature_check_set final
 {
 public:
-	signature_check_set (size_t size, unsigned char const ** messages, size_t * message_lengths, unsigned char const ** pub_keys, unsigned char const ** signatures, int * verifications) :
-	size (size), messages (messages), message_lengths (message_lengths), pub_keys (pub_keys), signatures (signatures), verifications (verifications)
+	signature_check_set (size_t size, unsigned char const ** messages, size_t * message_lengths, unsigned char const ** pub_keys, unsigned char const ** signatures, int * verifications, nano::prepared_public_key const ** prepared_keys = nullptr) :
+	size (size), messages (messages), message_lengths (message_lengths), pub_keys (pub_keys), signatures (signatures), verifications (verifications), prepared_keys (prepared_keys)
 	{
 	}
 
@@ -23,17 +29,30 @@ public:
 	unsigned char const ** pub_keys;
 	unsigned char const ** signatures;
 	int * verifications;
+	/** Optional, entries may be null for keys which are not prepared */
+	nano::prepared_public_key const ** prepared_keys;
 };
 
 /** Multi-threaded signature checker */
 class signature_checker final
 {
 public:
-	signature_checker (unsigned num_threads);
+	/** A partially filled batch waits up to \p max_delay_a after its oldest submission for other submissions before being verified */
+	signature_checker (unsigned num_threads, std::chrono::microseconds max_delay_a = std::chrono::microseconds (1000));
 	~signature_checker ();
 	void verify (signature_check_set &);
+	/**
+	 * Queues the set for verification and returns immediately. The callback is called from a checker thread once all signatures in the set are verified.
+	 * Submissions from all callers share one queue and are coalesced into batches of up to batch_size signatures.
+	 * The set and the buffers it points to must stay valid until the callback is called.
+	 */
+	void verify_async (signature_check_set &, std::function<void()> const &);
+	/** Blocks until the set is verified. Sets below the multithreaded cutoff go through the shared queue, so small sets from concurrent callers are verified together */
+	void verify_coalesced (signature_check_set &);
 	void stop ();
 	void flush ();
+	/** Number of batches verified from the shared queue */
+	uint64_t queue_batches () const;
 
 private:
 	struct Task final
@@ -50,8 +69,25 @@ private:
 		std::atomic<size_t> pending;
 	};
 
+	/** A set submitted through verify_async which is waiting in the shared queue */
+	class queued_set final
+	{
+	public:
+		queued_set (nano::signature_check_set & check, std::function<void()> const & callback) :
+		check (check), remaining (check.size), callback (callback), queued_at (std::chrono::steady_clock::now ())
+		{
+		}
+		nano::signature_check_set & check;
+		/** Index of the next signature to be assigned to a batch, protected by queue_mutex */
+		size_t next{ 0 };
+		std::atomic<size_t> remaining;
+		std::function<void()> callback;
+		std::chrono::steady_clock::time_point queued_at;
+	};
+
 	bool verify_batch (const nano::signature_check_set & check_a, size_t index, size_t size);
-	void verify_async (nano::signature_check_set & check_a, size_t num_batches, std::promise<void> & promise);
+	void verify_batches_async (nano::signature_check_set & check_a, size_t num_batches, std::promise<void> & promise);
+	void process_queue ();
 	void set_thread_names (unsigned num_threads);
 	boost::asio::thread_pool thread_pool;
 	std::atomic<int> tasks_remaining{ 0 };
@@ -62,5 +98,67 @@ private:
 	unsigned num_threads;
 	std::mutex mutex;
 	bool stopped{ false };
+	std::chrono::microseconds const max_delay;
+	std::deque<std::shared_ptr<queued_set>> queue;
+	/** Number of signatures in the queue not yet assigned to a batch */
+	size_t queued_signatures{ 0 };
+	/** Number of process_queue tasks posted to the thread pool */
+	unsigned queue_runners{ 0 };
+	std::atomic<uint64_t> batches{ 0 };
+	std::mutex queue_mutex;
+	nano::condition_variable queue_condition;
+};
+
+/**
+ * Bounded cache of recently verified valid signatures, used to skip verifying the same block or vote again when it arrives from several peers.
+ * Entries are keyed SipHash 2/4/128 digests of (message, public key, signature) stored in directly mapped slots, older entries are overwritten.
+ * The slots are split into independently locked stripes to reduce contention between producers.
+ * @note This class is thread-safe.
+ */
+class signature_cache final
+{
+public:
+	signature_cache (size_t size_a, size_t stripes_a = 16);
+	/** Returns true if this signature of \p message_a by \p pub_key_a was recently inserted as valid */
+	bool contains (nano::block_hash const & message_a, nano::public_key const & pub_key_a, nano::signature const & signature_a);
+	/** Remembers a signature which has been verified as valid */
+	void insert (nano::block_hash const & message_a, nano::public_key const & pub_key_a, nano::signature const & signature_a);
+	void clear ();
+	size_t size () const;
+
+private:
+	class stripe final
+	{
+	public:
+		std::vector<nano::uint128_t> items;
+		std::mutex mutex;
+	};
+	nano::uint128_t digest (nano::block_hash const &, nano::public_key const &, nano::signature const &) const;
+	std::pair<stripe &, size_t> locate (nano::uint128_t const &);
+	std::vector<std::unique_ptr<stripe>> stripes;
+	nano::uint128_union key;
 };
+
+std::unique_ptr<container_info_component> collect_container_info (signature_cache & signature_cache, const std::string & name);
+
+/**
+ * Prepared public keys of frequently seen signers, such as the principal representatives.
+ * The keys are published as an immutable snapshot so verifiers can use them without holding a lock.
+ * @note This class is thread-safe.
+ */
+class prepared_key_cache final
+{
+public:
+	using map = std::unordered_map<nano::public_key, std::shared_ptr<nano::prepared_public_key const>>;
+	/** Replaces the cached keys with \p keys_a, reusing those which are already prepared */
+	void update (std::vector<nano::public_key> const & keys_a);
+	std::shared_ptr<map const> snapshot () const;
+	size_t size () const;
+
+private:
+	std::shared_ptr<map const> keys{ std::make_shared<map> () };
+	mutable std::mutex mutex;
+};
+
+std::unique_ptr<container_info_component> collect_container_info (prepared_key_cache & prepared_key_cache, const std::string & name);
 }
@@ -0,0 +1,171 @@
+#include <nano/lib/locks.hpp>
+#include <nano/node/unchecked_map.hpp>
+#include <nano/secure/blockstore.hpp>
+
+nano::unchecked_map::unchecked_map (nano::block_store & store_a, size_t max_size_a) :
+store (store_a),
+capacity (max_size_a / entry_size)
+{
+}
+
+bool nano::unchecked_map::put (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a)
+{
+	auto result (false);
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto & by_key (entries.get<tag_key> ());
+	auto existing (by_key.find (key_a));
+	if (existing != by_key.end ())
+	{
+		by_key.modify (existing, [&info_a](entry & entry_a) {
+			entry_a.info = info_a;
+		});
+	}
+	else
+	{
+		auto stored (store.unchecked_exists (transaction_a, key_a));
+		result = !stored;
+		if (stored || capacity == 0)
+		{
+			store.unchecked_put (transaction_a, key_a, info_a, stored);
+		}
+		else
+		{
+			entries.get<tag_sequence> ().push_back (entry{ key_a, info_a });
+			if (entries.size () > capacity)
+			{
+				spill (transaction_a);
+			}
+		}
+	}
+	return result;
+}
+
+std::vector<nano::unchecked_info> nano::unchecked_map::get (nano::transaction const & transaction_a, nano::block_hash const & hash_a)
+{
+	std::vector<nano::unchecked_info> result;
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		auto & by_key (entries.get<tag_key> ());
+		for (auto i (by_key.lower_bound (nano::unchecked_key (hash_a, 0))), n (by_key.end ()); i != n && i->key.previous == hash_a; ++i)
+		{
+			result.push_back (i->info);
+		}
+	}
+	auto stored (store.unchecked_get (transaction_a, hash_a));
+	result.insert (result.end (), stored.begin (), stored.end ());
+	return result;
+}
+
+bool nano::unchecked_map::exists (nano::transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	auto result (false);
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		result = entries.get<tag_key> ().count (key_a) > 0;
+	}
+	return result || store.unchecked_exists (transaction_a, key_a);
+}
+
+bool nano::unchecked_map::del (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a)
+{
+	auto erased (false);
+	{
+		nano::lock_guard<std::mutex> lock (mutex);
+		erased = entries.get<tag_key> ().erase (key_a) > 0;
+	}
+	return erased ? false : store.unchecked_del (transaction_a, key_a);
+}
+
+void nano::unchecked_map::clear (nano::write_transaction const & transaction_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	entries.clear ();
+	store.unchecked_clear (transaction_a);
+}
+
+void nano::unchecked_map::flush (nano::write_transaction const & transaction_a)
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	for (auto const & entry_l : entries.get<tag_sequence> ())
+	{
+		// Keys held in memory are never in the unchecked table
+		store.unchecked_put (transaction_a, entry_l.key, entry_l.info, false);
+	}
+	entries.clear ();
+}
+
+void nano::unchecked_map::for_each (nano::transaction const & transaction_a, nano::unchecked_key const & start_a, std::function<bool(nano::unchecked_key const &, nano::unchecked_info const &)> const & action_a)
+{
+	// Merge the entries in memory with those in the table, both ordered by key. The lock is only held while looking up the next entry in memory
+	auto stored (store.unchecked_begin (transaction_a, start_a));
+	auto stored_end (store.unchecked_end ());
+	auto memory (next (start_a, true));
+	auto proceed (true);
+	while (proceed && (memory || stored != stored_end))
+	{
+		key_less less;
+		if (memory && (stored == stored_end || !less (stored->first, memory->key)))
+		{
+			if (stored != stored_end && stored->first == memory->key)
+			{
+				++stored;
+			}
+			proceed = action_a (memory->key, memory->info);
+			memory = next (memory->key, false);
+		}
+		else
+		{
+			proceed = action_a (stored->first, stored->second);
+			++stored;
+		}
+	}
+}
+
+size_t nano::unchecked_map::count (nano::transaction const & transaction_a)
+{
+	return memory_size () + store.unchecked_count (transaction_a);
+}
+
+size_t nano::unchecked_map::memory_size () const
+{
+	nano::lock_guard<std::mutex> lock (mutex);
+	return entries.size ();
+}
+
+void nano::unchecked_map::spill (nano::write_transaction const & transaction_a)
+{
+	auto & by_sequence (entries.get<tag_sequence> ());
+	auto target (capacity - capacity / 4);
+	while (entries.size () > target)
+	{
+		auto const & oldest (by_sequence.front ());
+		store.unchecked_put (transaction_a, oldest.key, oldest.info, false);
+		by_sequence.pop_front ();
+	}
+}
+
+boost::optional<nano::unchecked_map::entry> nano::unchecked_map::next (nano::unchecked_key const & key_a, bool inclusive_a) const
+{
+	boost::optional<entry> result;
+	nano::lock_guard<std::mutex> lock (mutex);
+	auto & by_key (entries.get<tag_key> ());
+	auto existing (inclusive_a ? by_key.lower_bound (key_a) : by_key.upper_bound (key_a));
+	if (existing != by_key.end ())
+	{
+		result = *existing;
+	}
+	return result;
+}
+
+bool nano::unchecked_map::key_less::operator() (nano::unchecked_key const & lhs, nano::unchecked_key const & rhs) const
+{
+	// Same order as the unchecked table, which compares the serialized keys bytewise
+	return lhs.previous < rhs.previous || (lhs.previous == rhs.previous && lhs.hash < rhs.hash);
+}
+
+std::unique_ptr<nano::container_info_component> nano::collect_container_info (unchecked_map & unchecked_map, const std::string & name)
+{
+	auto composite = std::make_unique<container_info_composite> (name);
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "entries", unchecked_map.memory_size (), nano::unchecked_map::entry_size }));
+	return composite;
+}
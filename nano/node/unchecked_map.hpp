@@ -0,0 +1,93 @@
+#pragma once
+
+#include <nano/lib/numbers.hpp>
+#include <nano/lib/utility.hpp>
+#include <nano/secure/common.hpp>
+
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/optional.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mi = boost::multi_index;
+
+namespace nano
+{
+class block_store;
+class transaction;
+class write_transaction;
+
+/**
+ * Blocks waiting on a missing dependency, keyed by the dependency hash.
+ * Entries are held in memory up to a budget, beyond it the oldest are spilled to the unchecked table, all remaining entries are written there by flush () at shutdown.
+ * Entries only held in memory are lost if the node stops without flushing, these are requested again while bootstrapping.
+ * Each key is held either in memory or in the unchecked table, never both.
+ * @note This class is thread-safe.
+ */
+class unchecked_map final
+{
+public:
+	/** Holds up to approximately \p max_size_a bytes in memory, a size of zero writes every entry straight to the unchecked table */
+	unchecked_map (nano::block_store &, size_t max_size_a);
+	/** Returns true if \p key_a was not already present */
+	bool put (nano::write_transaction const &, nano::unchecked_key const & key_a, nano::unchecked_info const &);
+	std::vector<nano::unchecked_info> get (nano::transaction const &, nano::block_hash const &);
+	bool exists (nano::transaction const &, nano::unchecked_key const &);
+	/** Returns true if nothing was deleted because it was not found, false otherwise */
+	bool del (nano::write_transaction const &, nano::unchecked_key const &);
+	void clear (nano::write_transaction const &);
+	/** Writes all entries held in memory to the unchecked table */
+	void flush (nano::write_transaction const &);
+	/**
+	 * Visits entries in key order starting from \p start_a until \p action_a returns false.
+	 * Entries spilled to the unchecked table while visiting may be skipped.
+	 */
+	void for_each (nano::transaction const &, nano::unchecked_key const & start_a, std::function<bool(nano::unchecked_key const &, nano::unchecked_info const &)> const & action_a);
+	size_t count (nano::transaction const &);
+	size_t memory_size () const;
+	/** Approximate memory used by an entry holding a state block */
+	static size_t constexpr entry_size{ 512 };
+
+private:
+	class entry final
+	{
+	public:
+		nano::unchecked_key key;
+		nano::unchecked_info info;
+	};
+	class key_less final
+	{
+	public:
+		bool operator() (nano::unchecked_key const &, nano::unchecked_key const &) const;
+	};
+	class tag_sequence
+	{
+	};
+	class tag_key
+	{
+	};
+	// clang-format off
+	using ordered_unchecked = boost::multi_index_container<entry,
+	mi::indexed_by<
+		mi::sequenced<mi::tag<tag_sequence>>,
+		mi::ordered_unique<mi::tag<tag_key>,
+			mi::member<entry, nano::unchecked_key, &entry::key>, key_less>>>;
+	// clang-format on
+	/** Writes the oldest entries to the unchecked table, a quarter of the capacity at a time so spills are batched */
+	void spill (nano::write_transaction const &);
+	/** Returns the first entry in memory with a key greater than \p key_a, or equal to it if \p inclusive_a */
+	boost::optional<entry> next (nano::unchecked_key const & key_a, bool inclusive_a) const;
+	nano::block_store & store;
+	ordered_unchecked entries;
+	size_t capacity;
+	mutable std::mutex mutex;
+};
+
+std::unique_ptr<container_info_component> collect_container_info (unchecked_map & unchecked_map, const std::string & name);
+}
@@ -15,8 +15,14 @@
 
 #include <boost/format.hpp>
 
-nano::vote_processor::vote_processor (nano::signature_checker & checker_a, nano::active_transactions & active_a, nano::node_observers & observers_a, nano::stat & stats_a, nano::node_config & config_a, nano::logger_mt & logger_a, nano::online_reps & online_reps_a, nano::ledger & ledger_a, nano::network_params & network_params_a) :
+size_t constexpr nano::vote_processor::quantum;
+size_t constexpr nano::vote_processor::channel_votes_max;
+size_t constexpr nano::vote_processor::channel_hashes_max;
+size_t constexpr nano::vote_processor::batch_size_max;
+
+nano::vote_processor::vote_processor (nano::signature_checker & checker_a, nano::signature_cache & signature_cache_a, nano::active_transactions & active_a, nano::node_observers & observers_a, nano::stat & stats_a, nano::node_config & config_a, nano::logger_mt & logger_a, nano::online_reps & online_reps_a, nano::ledger & ledger_a, nano::network_params & network_params_a) :
 checker (checker_a),
+signature_cache (signature_cache_a),
 active (active_a),
 observers (observers_a),
 stats (stats_a),
@@ -24,37 +30,34 @@ config (config_a),
 logger (logger_a),
 online_reps (online_reps_a),
 ledger (ledger_a),
-network_params (network_params_a),
-started (false),
-stopped (false),
-is_active (false),
-thread ([this]() {
-	nano::thread_role::set (nano::thread_role::name::vote_processing);
-	process_loop ();
-})
+network_params (network_params_a)
 {
-	nano::unique_lock<std::mutex> lock (mutex);
-	condition.wait (lock, [& started = started] { return started; });
+	auto count (std::max<unsigned> (1, config.vote_processor_threads));
+	for (auto i (0u); i < count; ++i)
+	{
+		shards.push_back (std::make_unique<shard> ());
+	}
+	// Threads are started once all shards exist as any of them may be selected by vote ()
+	for (auto & shard_l : shards)
+	{
+		shard_l->thread = std::thread ([this, &shard_a = *shard_l]() {
+			nano::thread_role::set (nano::thread_role::name::vote_processing);
+			process_loop (shard_a);
+		});
+	}
 }
 
-void nano::vote_processor::process_loop ()
+void nano::vote_processor::process_loop (nano::vote_processor::shard & shard_a)
 {
 	nano::timer<std::chrono::milliseconds> elapsed;
 	bool log_this_iteration;
 
-	nano::unique_lock<std::mutex> lock (mutex);
-	started = true;
-
-	lock.unlock ();
-	condition.notify_all ();
-	lock.lock ();
-
+	nano::unique_lock<std::mutex> lock (shard_a.mutex);
 	while (!stopped)
 	{
-		if (!votes.empty ())
+		if (shard_a.size != 0)
 		{
-			decltype (votes) votes_l;
-			votes_l.swap (votes);
+			auto votes_l (drain (shard_a, batch_size_max));
 
 			log_this_iteration = false;
 			if (config.logging.network_logging () && votes_l.size () > 50)
@@ -66,14 +69,14 @@ void nano::vote_processor::process_loop ()
 				log_this_iteration = true;
 				elapsed.restart ();
 			}
-			is_active = true;
+			shard_a.is_active = true;
 			lock.unlock ();
 			verify_votes (votes_l);
 			lock.lock ();
-			is_active = false;
+			shard_a.is_active = false;
 
 			lock.unlock ();
-			condition.notify_all ();
+			shard_a.condition.notify_all ();
 			lock.lock ();
 
 			if (log_this_iteration && elapsed.stop () > std::chrono::milliseconds (100))
@@ -83,64 +86,144 @@ void nano::vote_processor::process_loop ()
 		}
 		else
 		{
-			condition.wait (lock);
+			shard_a.condition.wait (lock);
+		}
+	}
+}
+
+bool nano::vote_processor::enqueue (nano::vote_processor::shard & shard_a, std::shared_ptr<nano::vote> const & vote_a, std::shared_ptr<nano::transport::channel> const & channel_a)
+{
+	auto endpoint (channel_a->get_endpoint ());
+	auto & queue (shard_a.queues[endpoint]);
+	auto hashes (vote_a->blocks.size ());
+	// Each shard gets an equal part of the channel budget
+	auto result ((queue.votes.size () + 1) * shards.size () <= channel_votes_max && (queue.hashes + hashes) * shards.size () <= channel_hashes_max);
+	if (result)
+	{
+		if (queue.votes.empty ())
+		{
+			shard_a.schedule.push_back (endpoint);
 		}
+		queue.votes.emplace_back (vote_a, channel_a);
+		queue.hashes += hashes;
+		++shard_a.size;
+	}
+	else if (queue.votes.empty ())
+	{
+		shard_a.queues.erase (endpoint);
 	}
+	return result;
+}
+
+std::deque<nano::vote_processor::vote_entry> nano::vote_processor::drain (nano::vote_processor::shard & shard_a, size_t max_a)
+{
+	std::deque<vote_entry> result;
+	while (result.size () < max_a && !shard_a.schedule.empty ())
+	{
+		auto endpoint (shard_a.schedule.front ());
+		shard_a.schedule.pop_front ();
+		auto existing (shard_a.queues.find (endpoint));
+		debug_assert (existing != shard_a.queues.end ());
+		auto & queue (existing->second);
+		queue.deficit += quantum;
+		while (!queue.votes.empty () && result.size () < max_a && queue.votes.front ().first->blocks.size () <= queue.deficit)
+		{
+			auto hashes (queue.votes.front ().first->blocks.size ());
+			queue.deficit -= hashes;
+			queue.hashes -= hashes;
+			result.push_back (std::move (queue.votes.front ()));
+			queue.votes.pop_front ();
+			--shard_a.size;
+		}
+		if (queue.votes.empty ())
+		{
+			// Idle channels do not keep their credit
+			shard_a.queues.erase (existing);
+		}
+		else
+		{
+			shard_a.schedule.push_back (endpoint);
+		}
+	}
+	return result;
+}
+
+nano::vote_processor::shard & nano::vote_processor::shard_for (nano::account const & representative_a)
+{
+	// Keeping each representative on one shard preserves the order of its votes
+	return *shards[representative_a.qwords[0] % shards.size ()];
 }
 
 void nano::vote_processor::vote (std::shared_ptr<nano::vote> vote_a, std::shared_ptr<nano::transport::channel> channel_a)
 {
-	nano::unique_lock<std::mutex> lock (mutex);
+	auto & shard_l (shard_for (vote_a->account));
+	nano::unique_lock<std::mutex> lock (shard_l.mutex);
 	if (!stopped)
 	{
-		bool process (false);
-		/* Random early delection levels
-		 Always process votes for test network (process = true)
-		 Stop processing with max 144 * 1024 votes */
-		if (!network_params.network.is_test_network ())
+		if (should_process (vote_a->account, shard_l.size))
 		{
-			// Level 0 (< 0.1%)
-			if (votes.size () < 96 * 1024)
+			if (enqueue (shard_l, vote_a, channel_a))
 			{
-				process = true;
+				lock.unlock ();
+				shard_l.condition.notify_all ();
+				lock.lock ();
 			}
-			// Level 1 (0.1-1%)
-			else if (votes.size () < 112 * 1024)
-			{
-				process = (representatives_1.find (vote_a->account) != representatives_1.end ());
-			}
-			// Level 2 (1-5%)
-			else if (votes.size () < 128 * 1024)
+			else
 			{
-				process = (representatives_2.find (vote_a->account) != representatives_2.end ());
-			}
-			// Level 3 (> 5%)
-			else if (votes.size () < 144 * 1024)
-			{
-				process = (representatives_3.find (vote_a->account) != representatives_3.end ());
+				stats.inc (nano::stat::type::vote, nano::stat::detail::vote_channel_overflow);
 			}
 		}
 		else
 		{
-			// Process for test network
-			process = true;
+			stats.inc (nano::stat::type::vote, nano::stat::detail::vote_overflow);
 		}
-		if (process)
-		{
-			votes.emplace_back (vote_a, channel_a);
+	}
+}
 
-			lock.unlock ();
-			condition.notify_all ();
-			lock.lock ();
+bool nano::vote_processor::should_process (nano::account const & representative_a, size_t queue_size_a)
+{
+	bool process (false);
+	/* Random early delection levels
+	 Always process votes for test network (process = true)
+	 Stop processing with max 144 * 1024 votes over all shards */
+	if (!network_params.network.is_test_network ())
+	{
+		// Each shard gets an equal part of the limits
+		auto votes_size (queue_size_a * shards.size ());
+		// Level 0 (< 0.1%)
+		if (votes_size < 96 * 1024)
+		{
+			process = true;
 		}
 		else
 		{
-			stats.inc (nano::stat::type::vote, nano::stat::detail::vote_overflow);
+			nano::lock_guard<std::mutex> guard (mutex);
+			// Level 1 (0.1-1%)
+			if (votes_size < 112 * 1024)
+			{
+				process = (representatives_1.find (representative_a) != representatives_1.end ());
+			}
+			// Level 2 (1-5%)
+			else if (votes_size < 128 * 1024)
+			{
+				process = (representatives_2.find (representative_a) != representatives_2.end ());
+			}
+			// Level 3 (> 5%)
+			else if (votes_size < 144 * 1024)
+			{
+				process = (representatives_3.find (representative_a) != representatives_3.end ());
+			}
 		}
 	}
+	else
+	{
+		// Process for test network
+		process = true;
+	}
+	return process;
 }
 
-void nano::vote_processor::verify_votes (decltype (votes) const & votes_a)
+void nano::vote_processor::verify_votes (std::deque<vote_entry> const & votes_a)
 {
 	auto size (votes_a.size ());
 	std::vector<unsigned char const *> messages;
@@ -152,18 +235,51 @@ void nano::vote_processor::verify_votes (decltype (votes) const & votes_a)
 	pub_keys.reserve (size);
 	std::vector<unsigned char const *> signatures;
 	signatures.reserve (size);
-	std::vector<int> verifications;
-	verifications.resize (size);
+	std::vector<nano::prepared_public_key const *> prepared;
+	prepared.reserve (size);
+	std::vector<int> verifications (size, 0);
+	auto prepared_keys_l (prepared_keys.snapshot ());
+	// Indices into votes_a of the votes not found in the signature cache
+	std::vector<size_t> unverified;
+	unverified.reserve (size);
+	auto i (0);
 	for (auto const & vote : votes_a)
 	{
 		hashes.push_back (vote.first->hash ());
-		messages.push_back (hashes.back ().bytes.data ());
-		pub_keys.push_back (vote.first->account.bytes.data ());
-		signatures.push_back (vote.first->signature.bytes.data ());
+		if (signature_cache.contains (hashes.back (), vote.first->account, vote.first->signature))
+		{
+			verifications[i] = 1;
+		}
+		else
+		{
+			messages.push_back (hashes.back ().bytes.data ());
+			pub_keys.push_back (vote.first->account.bytes.data ());
+			signatures.push_back (vote.first->signature.bytes.data ());
+			auto existing (prepared_keys_l->find (vote.first->account));
+			prepared.push_back (existing != prepared_keys_l->end () ? existing->second.get () : nullptr);
+			unverified.push_back (i);
+		}
+		++i;
 	}
-	nano::signature_check_set check = { size, messages.data (), lengths.data (), pub_keys.data (), signatures.data (), verifications.data () };
-	checker.verify (check);
-	auto i (0);
+	stats.add (nano::stat::type::signature_cache, nano::stat::detail::cache_hit, nano::stat::dir::in, size - unverified.size ());
+	stats.add (nano::stat::type::signature_cache, nano::stat::detail::cache_miss, nano::stat::dir::in, unverified.size ());
+	if (!unverified.empty ())
+	{
+		std::vector<int> unverified_verifications (unverified.size (), 0);
+		nano::signature_check_set check = { unverified.size (), messages.data (), lengths.data (), pub_keys.data (), signatures.data (), unverified_verifications.data (), prepared.data () };
+		checker.verify_coalesced (check);
+		for (auto j (0); j < unverified.size (); ++j)
+		{
+			auto index (unverified[j]);
+			verifications[index] = unverified_verifications[j];
+			if (verifications[index] == 1)
+			{
+				auto const & vote (votes_a[index].first);
+				signature_cache.insert (hashes[index], vote->account, vote->signature);
+			}
+		}
+	}
+	i = 0;
 	for (auto const & vote : votes_a)
 	{
 		debug_assert (verifications[i] == 1 || verifications[i] == 0);
@@ -213,36 +329,47 @@ nano::vote_code nano::vote_processor::vote_blocking (std::shared_ptr<nano::vote>
 
 void nano::vote_processor::stop ()
 {
+	stopped = true;
+	for (auto & shard_l : shards)
 	{
-		nano::lock_guard<std::mutex> lock (mutex);
-		stopped = true;
-	}
-	condition.notify_all ();
-	if (thread.joinable ())
-	{
-		thread.join ();
+		{
+			// Synchronize with a shard about to wait on its condition
+			nano::lock_guard<std::mutex> lock (shard_l->mutex);
+		}
+		shard_l->condition.notify_all ();
+		if (shard_l->thread.joinable ())
+		{
+			shard_l->thread.join ();
+		}
 	}
 }
 
 void nano::vote_processor::flush ()
 {
-	nano::unique_lock<std::mutex> lock (mutex);
-	while (is_active || !votes.empty ())
+	for (auto & shard_l : shards)
 	{
-		condition.wait (lock);
+		nano::unique_lock<std::mutex> lock (shard_l->mutex);
+		while (shard_l->is_active || shard_l->size != 0)
+		{
+			shard_l->condition.wait (lock);
+		}
 	}
 }
 
 size_t nano::vote_processor::size ()
 {
-	nano::lock_guard<std::mutex> guard (mutex);
-	return votes.size ();
+	size_t result (0);
+	for (auto & shard_l : shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard_l->mutex);
+		result += shard_l->size;
+	}
+	return result;
 }
 
 bool nano::vote_processor::empty ()
 {
-	nano::lock_guard<std::mutex> guard (mutex);
-	return votes.empty ();
+	return size () == 0;
 }
 
 void nano::vote_processor::calculate_weights ()
@@ -272,28 +399,38 @@ void nano::vote_processor::calculate_weights ()
 				}
 			}
 		}
+		std::vector<nano::account> principal_representatives (representatives_1.begin (), representatives_1.end ());
+		lock.unlock ();
+		// Votes from these representatives are the most frequent, preparing their keys saves decompressing them on every verification
+		prepared_keys.update (principal_representatives);
 	}
 }
 
 std::unique_ptr<nano::container_info_component> nano::collect_container_info (vote_processor & vote_processor, const std::string & name)
 {
-	size_t votes_count;
 	size_t representatives_1_count;
 	size_t representatives_2_count;
 	size_t representatives_3_count;
 
 	{
 		nano::lock_guard<std::mutex> guard (vote_processor.mutex);
-		votes_count = vote_processor.votes.size ();
 		representatives_1_count = vote_processor.representatives_1.size ();
 		representatives_2_count = vote_processor.representatives_2.size ();
 		representatives_3_count = vote_processor.representatives_3.size ();
 	}
 
 	auto composite = std::make_unique<container_info_composite> (name);
-	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "votes", votes_count, sizeof (decltype (vote_processor.votes)::value_type) }));
+	size_t channels_count (0);
+	for (auto & shard_l : vote_processor.shards)
+	{
+		nano::lock_guard<std::mutex> guard (shard_l->mutex);
+		channels_count += shard_l->queues.size ();
+	}
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "votes", vote_processor.size (), sizeof (nano::vote_processor::vote_entry) }));
+	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "channel_queues", channels_count, sizeof (decltype (nano::vote_processor::shard::queues)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_1", representatives_1_count, sizeof (decltype (vote_processor.representatives_1)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_2", representatives_2_count, sizeof (decltype (vote_processor.representatives_2)::value_type) }));
 	composite->add_component (std::make_unique<container_info_leaf> (container_info{ "representatives_3", representatives_3_count, sizeof (decltype (vote_processor.representatives_3)::value_type) }));
+	composite->add_component (collect_container_info (vote_processor.prepared_keys, "prepared_keys"));
 	return composite;
 }
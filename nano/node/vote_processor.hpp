@@ -2,17 +2,21 @@
 
 #include <nano/lib/numbers.hpp>
 #include <nano/lib/utility.hpp>
+#include <nano/node/common.hpp>
+#include <nano/node/signatures.hpp>
 #include <nano/secure/common.hpp>
 
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace nano
 {
-class signature_checker;
 class active_transactions;
 class block_store;
 class node_observers;
@@ -29,10 +33,16 @@ namespace transport
 	class channel;
 }
 
+/**
+ * Verifies incoming votes and applies them to active elections.
+ * Votes are distributed by representative between several threads, each with its own queue, so votes from one representative are always processed in order.
+ * Within a shard votes are queued per channel and drained with deficit round robin, each channel is also limited in how many votes and hashes it can have queued
+ * so a single peer cannot crowd out the others.
+ */
 class vote_processor final
 {
 public:
-	explicit vote_processor (nano::signature_checker & checker_a, nano::active_transactions & active_a, nano::node_observers & observers_a, nano::stat & stats_a, nano::node_config & config_a, nano::logger_mt & logger_a, nano::online_reps & online_reps_a, nano::ledger & ledger_a, nano::network_params & network_params_a);
+	explicit vote_processor (nano::signature_checker & checker_a, nano::signature_cache & signature_cache_a, nano::active_transactions & active_a, nano::node_observers & observers_a, nano::stat & stats_a, nano::node_config & config_a, nano::logger_mt & logger_a, nano::online_reps & online_reps_a, nano::ledger & ledger_a, nano::network_params & network_params_a);
 	void vote (std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>);
 	/** Note: node.active.mutex lock is required */
 	nano::vote_code vote_blocking (std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>, bool = false);
@@ -44,9 +54,39 @@ public:
 	void stop ();
 
 private:
-	void process_loop ();
+	using vote_entry = std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>;
+	class channel_queue final
+	{
+	public:
+		std::deque<vote_entry> votes;
+		/** Number of hashes in the queued votes, standing in for their size */
+		size_t hashes{ 0 };
+		size_t deficit{ 0 };
+	};
+	class shard final
+	{
+	public:
+		std::unordered_map<nano::endpoint, channel_queue> queues;
+		/** Endpoints with queued votes, in round robin order */
+		std::deque<nano::endpoint> schedule;
+		/** Total number of queued votes */
+		size_t size{ 0 };
+		nano::condition_variable condition;
+		std::mutex mutex;
+		bool is_active{ false };
+		std::thread thread;
+	};
+	void process_loop (nano::vote_processor::shard &);
+	/** Queues the vote unless its channel is over budget, shard mutex must be held */
+	bool enqueue (nano::vote_processor::shard &, std::shared_ptr<nano::vote> const &, std::shared_ptr<nano::transport::channel> const &);
+	/** Takes up to \p max_a votes from the channel queues of the shard in deficit round robin order, shard mutex must be held */
+	std::deque<vote_entry> drain (nano::vote_processor::shard &, size_t max_a);
+	nano::vote_processor::shard & shard_for (nano::account const &);
+	/** Random early detection, decides whether to queue a vote given the length of its shard queue */
+	bool should_process (nano::account const &, size_t);
 
 	nano::signature_checker & checker;
+	nano::signature_cache & signature_cache;
 	nano::active_transactions & active;
 	nano::node_observers & observers;
 	nano::stat & stats;
@@ -55,21 +95,29 @@ private:
 	nano::online_reps & online_reps;
 	nano::ledger & ledger;
 	nano::network_params & network_params;
+	/** Prepared keys of the level 1 representatives, refreshed with the weights */
+	nano::prepared_key_cache prepared_keys;
 
-	std::deque<std::pair<std::shared_ptr<nano::vote>, std::shared_ptr<nano::transport::channel>>> votes;
+	std::vector<std::unique_ptr<shard>> shards;
+	/** Credit added to a channel on each round, at least the hashes of the largest vote so every visit dequeues a vote */
+	static size_t constexpr quantum = 16;
+	/** Limits for the votes and hashes queued from a single channel over all shards */
+	static size_t constexpr channel_votes_max = 16 * 1024;
+	static size_t constexpr channel_hashes_max = 64 * 1024;
+	static size_t constexpr batch_size_max = 4 * 1024;
 	/** Representatives levels for random early detection */
 	std::unordered_set<nano::account> representatives_1;
 	std::unordered_set<nano::account> representatives_2;
 	std::unordered_set<nano::account> representatives_3;
-	nano::condition_variable condition;
+	/** Protects the representative levels */
 	std::mutex mutex;
-	bool started;
-	bool stopped;
-	bool is_active;
-	std::thread thread;
+	std::atomic<bool> stopped{ false };
 
 	friend std::unique_ptr<container_info_component> collect_container_info (vote_processor & vote_processor, const std::string & name);
 	friend class vote_processor_weights_Test;
+	friend class vote_processor_prepared_keys_Test;
+	friend class vote_processor_shards_Test;
+	friend class vote_processor_channel_fairness_Test;
 };
 
 std::unique_ptr<container_info_component> collect_container_info (vote_processor & vote_processor, const std::string & name);
@@ -1,3 +1,4 @@
+#include <nano/lib/stats.hpp>
 #include <nano/lib/utility.hpp>
 #include <nano/node/write_database_queue.hpp>
 
@@ -15,12 +16,13 @@ nano::write_guard::~write_guard ()
 	cv.notify_all ();
 }
 
-nano::write_database_queue::write_database_queue () :
-guard_finish_callback ([& queue = queue, &mutex = mutex]() {
-	nano::lock_guard<std::mutex> guard (mutex);
-	queue.pop_front ();
-})
+nano::write_database_queue::write_database_queue (std::function<void()> const & sync_a, std::chrono::milliseconds group_commit_max_delay_a, nano::stat * stats_a) :
+guard_finish_callback ([this]() { release (); }),
+sync (sync_a),
+group_commit_max_delay (group_commit_max_delay_a),
+stats (stats_a)
 {
+	debug_assert (group_commit_max_delay.count () == 0 || sync != nullptr);
 }
 
 nano::write_guard nano::write_database_queue::wait (nano::writer writer)
@@ -75,6 +77,37 @@ nano::write_guard nano::write_database_queue::pop ()
 	return write_guard (cv, guard_finish_callback);
 }
 
+void nano::write_database_queue::release ()
+{
+	nano::unique_lock<std::mutex> lk (mutex);
+	if (stats != nullptr)
+	{
+		stats->inc (nano::stat::type::write_queue, nano::stat::detail::batch_commit);
+	}
+	if (group_commit_max_delay.count () > 0)
+	{
+		auto now (std::chrono::steady_clock::now ());
+		if (unsynced_writers++ == 0)
+		{
+			unsynced_since = now;
+		}
+		// Leave the flush to the next writer unless nobody is waiting or the oldest commit has used up its latency budget
+		if (queue.size () <= 1 || now - unsynced_since >= group_commit_max_delay)
+		{
+			unsynced_writers = 0;
+			// This writer is still at the front of the queue, so no other writer commits while flushing
+			lk.unlock ();
+			sync ();
+			if (stats != nullptr)
+			{
+				stats->inc (nano::stat::type::write_queue, nano::stat::detail::sync);
+			}
+			lk.lock ();
+		}
+	}
+	queue.pop_front ();
+}
+
 void nano::write_database_queue::stop ()
 {
 	stopped = true;
@@ -3,6 +3,7 @@
 #include <nano/lib/locks.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -10,11 +11,14 @@
 
 namespace nano
 {
+class stat;
+
 /** Distinct areas write locking is done, order is irrelevant */
 enum class writer
 {
 	confirmation_height,
 	process_batch,
+	pruning,
 	testing // Used in tests to emulate a write lock
 };
 
@@ -29,10 +33,17 @@ private:
 	std::function<void()> guard_finish_callback;
 };
 
+/**
+ * Orders the writers of the ledger so only one holds the database write lock at a time.
+ * In group commit mode, enabled by a non-zero \p group_commit_max_delay_a, commits are not flushed to disk individually. A writer releasing the
+ * queue flushes with \p sync_a only when no other writer is waiting or the oldest unflushed commit is older than the delay, so writers
+ * queued behind each other share a single flush. Writers which commit without going through the queue are not flushed by it and only become
+ * durable at the node's periodic store flush.
+ */
 class write_database_queue final
 {
 public:
-	write_database_queue ();
+	write_database_queue (std::function<void()> const & sync_a = nullptr, std::chrono::milliseconds group_commit_max_delay_a = std::chrono::milliseconds (0), nano::stat * stats_a = nullptr);
 	/** Blocks until we are at the head of the queue */
 	write_guard wait (nano::writer writer);
 
@@ -49,10 +60,17 @@ public:
 	void stop ();
 
 private:
+	void release ();
 	std::deque<nano::writer> queue;
 	std::mutex mutex;
 	nano::condition_variable cv;
 	std::function<void()> guard_finish_callback;
 	std::atomic<bool> stopped{ false };
+	std::function<void()> sync;
+	std::chrono::milliseconds group_commit_max_delay;
+	nano::stat * stats;
+	/** Number of writers released since the last flush and when the first of them was released */
+	uint64_t unsynced_writers{ 0 };
+	std::chrono::steady_clock::time_point unsynced_since;
 };
 }
@@ -6607,7 +6607,7 @@ TEST (rpc, unchecked_clear)
 	ASSERT_EQ (node.ledger.cache.unchecked_count, 1);
 	{
 		auto transaction = node.store.tx_begin_read ();
-		ASSERT_EQ (node.store.unchecked_count (transaction), 1);
+		ASSERT_EQ (node.unchecked.count (transaction), 1);
 	}
 	request.put ("action", "unchecked_clear");
 	test_response response (request, rpc.config.port, system.io_ctx);
@@ -6622,7 +6622,7 @@ TEST (rpc, unchecked_clear)
 	while (true)
 	{
 		auto transaction = node.store.tx_begin_read ();
-		if (node.store.unchecked_count (transaction) == 0)
+		if (node.unchecked.count (transaction) == 0)
 		{
 			break;
 		}
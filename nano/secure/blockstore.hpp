@@ -5,17 +5,22 @@
 #include <nano/lib/logger_mt.hpp>
 #include <nano/lib/memory.hpp>
 #include <nano/lib/rocksdbconfig.hpp>
+#include <nano/lib/threading.hpp>
 #include <nano/secure/buffer.hpp>
 #include <nano/secure/common.hpp>
 #include <nano/secure/versioning.hpp>
 
 #include <boost/endian/conversion.hpp>
+#include <boost/optional.hpp>
 #include <boost/polymorphic_cast.hpp>
 
 #include <stack>
+#include <thread>
 
 namespace nano
 {
+class stat;
+
 class block_details
 {
 	static_assert (std::is_same<std::underlying_type<nano::epoch>::type, uint8_t> (), "Epoch enum is not the proper type");
@@ -139,6 +144,22 @@ public:
 		static_assert (std::is_standard_layout<nano::unchecked_key>::value, "Standard layout is required");
 	}
 
+	db_val (nano::delegator_key const & val_a) :
+	db_val (sizeof (val_a), const_cast<nano::delegator_key *> (&val_a))
+	{
+		static_assert (std::is_standard_layout<nano::delegator_key>::value, "Standard layout is required");
+	}
+
+	db_val (nano::account_height_key const & val_a) :
+	buffer (std::make_shared<std::vector<uint8_t>> ())
+	{
+		{
+			nano::vectorstream stream (*buffer);
+			val_a.serialize (stream);
+		}
+		convert_buffer_to_value ();
+	}
+
 	db_val (nano::confirmation_height_info const & val_a) :
 	buffer (std::make_shared<std::vector<uint8_t>> ())
 	{
@@ -149,6 +170,16 @@ public:
 		convert_buffer_to_value ();
 	}
 
+	db_val (nano::pruned_info const & val_a) :
+	buffer (std::make_shared<std::vector<uint8_t>> ())
+	{
+		{
+			nano::vectorstream stream (*buffer);
+			val_a.serialize (stream);
+		}
+		convert_buffer_to_value ();
+	}
+
 	db_val (nano::block_info const & val_a) :
 	db_val (sizeof (val_a), const_cast<nano::block_info *> (&val_a))
 	{
@@ -240,6 +271,16 @@ public:
 		return result;
 	}
 
+	explicit operator nano::account_height_key () const
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
+		nano::account_height_key result;
+		bool error (result.deserialize (stream));
+		(void)error;
+		debug_assert (!error);
+		return result;
+	}
+
 	explicit operator nano::confirmation_height_info () const
 	{
 		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (data ()), size ());
@@ -269,6 +310,15 @@ public:
 		return result;
 	}
 
+	explicit operator nano::delegator_key () const
+	{
+		nano::delegator_key result;
+		debug_assert (size () == sizeof (result));
+		static_assert (sizeof (nano::delegator_key::representative) + sizeof (nano::delegator_key::account) == sizeof (result), "Packed class");
+		std::copy (reinterpret_cast<uint8_t const *> (data ()), reinterpret_cast<uint8_t const *> (data ()) + sizeof (result), reinterpret_cast<uint8_t *> (&result));
+		return result;
+	}
+
 	explicit operator nano::uint128_union () const
 	{
 		return convert<nano::uint128_union> ();
@@ -622,22 +672,27 @@ private:
 // Keep this in alphabetical order
 enum class tables
 {
+	account_heights,
 	accounts,
+	blocks,
 	blocks_info, // LMDB only
 	cached_counts, // RocksDB only
-	change_blocks,
+	change_blocks, // Merged into blocks, upgrades only
 	confirmation_height,
+	delegators,
 	frontiers,
 	meta,
 	online_weight,
-	open_blocks,
+	open_blocks, // Merged into blocks, upgrades only
 	peers,
 	pending,
-	receive_blocks,
+	pruned,
+	receive_blocks, // Merged into blocks, upgrades only
 	representation,
-	send_blocks,
-	state_blocks,
+	send_blocks, // Merged into blocks, upgrades only
+	state_blocks, // Merged into blocks, upgrades only
 	unchecked,
+	unchecked_bodies,
 	vote
 };
 
@@ -706,6 +761,33 @@ private:
 
 class ledger_cache;
 
+/**
+ * Splits the key space of \p T into ranges and calls \p action_a for each range on its own thread, the last range also covers the keys above its end
+ * Ranges are evenly sized, this suits tables keyed by account or hash as their keys are uniformly distributed
+ */
+template <typename T>
+void parallel_traversal (std::function<void(T const & start_a, T const & end_a, bool const is_last_a)> const & action_a)
+{
+	// Scanning is mostly waiting on reads, so more threads than cores still helps
+	unsigned const thread_count (std::max (10u, std::min (40u, 10 * std::thread::hardware_concurrency ())));
+	T const split (std::numeric_limits<T>::max () / thread_count);
+	std::vector<std::thread> threads;
+	threads.reserve (thread_count);
+	for (unsigned thread (0); thread < thread_count; ++thread)
+	{
+		threads.emplace_back ([&action_a, &split, thread, thread_count]() {
+			nano::thread_role::set (nano::thread_role::name::db_parallel_traversal);
+			T const start (thread * split);
+			T const end ((thread + 1) * split);
+			action_a (start, end, thread == thread_count - 1);
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+}
+
 /**
  * Manages block storage and iteration
  */
@@ -719,6 +801,8 @@ public:
 	virtual void block_successor_clear (nano::write_transaction const &, nano::block_hash const &) = 0;
 	virtual std::shared_ptr<nano::block> block_get (nano::transaction const &, nano::block_hash const &, nano::block_sideband * = nullptr) const = 0;
 	virtual std::shared_ptr<nano::block> block_get_v14 (nano::transaction const &, nano::block_hash const &, nano::block_sideband_v14 * = nullptr, bool * = nullptr) const = 0;
+	/** Looks up many blocks in a single pass over the store, results are in the order of \p hashes_a with nullptr for missing blocks. If \p sidebands_a is supplied it is resized to match */
+	virtual std::vector<std::shared_ptr<nano::block>> block_get_many (nano::transaction const &, std::vector<nano::block_hash> const & hashes_a, std::vector<nano::block_sideband> * sidebands_a = nullptr) const = 0;
 	virtual std::shared_ptr<nano::block> block_random (nano::transaction const &) = 0;
 	virtual void block_del (nano::write_transaction const &, nano::block_hash const &, nano::block_type) = 0;
 	virtual bool block_exists (nano::transaction const &, nano::block_hash const &) = 0;
@@ -734,6 +818,7 @@ public:
 
 	virtual void account_put (nano::write_transaction const &, nano::account const &, nano::account_info const &) = 0;
 	virtual bool account_get (nano::transaction const &, nano::account const &, nano::account_info &) = 0;
+	virtual std::vector<boost::optional<nano::account_info>> account_get_many (nano::transaction const &, std::vector<nano::account> const &) = 0;
 	virtual void account_del (nano::write_transaction const &, nano::account const &) = 0;
 	virtual bool account_exists (nano::transaction const &, nano::account const &) = 0;
 	virtual size_t account_count (nano::transaction const &) = 0;
@@ -742,6 +827,8 @@ public:
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_begin (nano::transaction const &, nano::account const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_begin (nano::transaction const &) = 0;
 	virtual nano::store_iterator<nano::account, nano::account_info> latest_end () = 0;
+	/** Calls \p action_a concurrently for ranges of accounts covering the whole table, each with its own read transaction */
+	virtual void latest_for_each_par (std::function<void(nano::read_transaction const &, nano::store_iterator<nano::account, nano::account_info>, nano::store_iterator<nano::account, nano::account_info>)> const & action_a) = 0;
 
 	virtual void pending_put (nano::write_transaction const &, nano::pending_key const &, nano::pending_info const &) = 0;
 	virtual void pending_del (nano::write_transaction const &, nano::pending_key const &) = 0;
@@ -749,6 +836,8 @@ public:
 	virtual bool pending_exists (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &, nano::pending_key const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_begin (nano::transaction const &) = 0;
+	/** Seeks to the first pending entry of \p account_a. The iterator may end after its last entry or continue to later accounts, so callers stop at the first entry of another account */
+	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_account_begin (nano::transaction const &, nano::account const &) = 0;
 	virtual nano::store_iterator<nano::pending_key, nano::pending_info> pending_end () = 0;
 
 	virtual bool block_info_get (nano::transaction const &, nano::block_hash const &, nano::block_info &) const = 0;
@@ -758,6 +847,8 @@ public:
 
 	virtual void unchecked_clear (nano::write_transaction const &) = 0;
 	virtual void unchecked_put (nano::write_transaction const &, nano::unchecked_key const &, nano::unchecked_info const &) = 0;
+	/** Same as above for callers which already know whether the key is stored, \p exists_a must match unchecked_exists () */
+	virtual void unchecked_put (nano::write_transaction const &, nano::unchecked_key const &, nano::unchecked_info const &, bool exists_a) = 0;
 	virtual void unchecked_put (nano::write_transaction const &, nano::block_hash const &, std::shared_ptr<nano::block> const &) = 0;
 	virtual std::vector<nano::unchecked_info> unchecked_get (nano::transaction const &, nano::block_hash const &) = 0;
 	virtual bool unchecked_exists (nano::transaction const & transaction_a, nano::unchecked_key const & unchecked_key_a) = 0;
@@ -790,6 +881,12 @@ public:
 
 	virtual void version_put (nano::write_transaction const &, int) = 0;
 	virtual int version_get (nano::transaction const &) const = 0;
+	/** Stores \p cache_a as the ledger cache checkpoint, it is only loaded again if no other write transaction is committed after this one */
+	virtual void cache_checkpoint_put (nano::write_transaction const &, nano::ledger_cache &) = 0;
+	/** Loads the ledger cache checkpoint into \p cache_a, returns true if there is none, it is damaged or the ledger was written to since it was stored */
+	virtual bool cache_checkpoint_get (nano::transaction const &, nano::ledger_cache &) const = 0;
+	/** Deletes the ledger cache checkpoint, done on every start so a checkpoint is loaded at most once */
+	virtual void cache_checkpoint_del (nano::write_transaction const &) = 0;
 
 	virtual void peer_put (nano::write_transaction const & transaction_a, nano::endpoint_key const & endpoint_a) = 0;
 	virtual void peer_del (nano::write_transaction const & transaction_a, nano::endpoint_key const & endpoint_a) = 0;
@@ -799,6 +896,32 @@ public:
 	virtual nano::store_iterator<nano::endpoint_key, nano::no_value> peers_begin (nano::transaction const & transaction_a) const = 0;
 	virtual nano::store_iterator<nano::endpoint_key, nano::no_value> peers_end () const = 0;
 
+	/** Secondary index of the accounts delegating to each representative, only maintained by ledgers with the index enabled */
+	virtual void delegator_put (nano::write_transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) = 0;
+	virtual void delegator_del (nano::write_transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) = 0;
+	virtual bool delegator_exists (nano::transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) const = 0;
+	virtual void delegators_clear (nano::write_transaction const & transaction_a) = 0;
+	/** Iterates from the first account delegating to \p representative_a, iteration continues past the last one into the accounts of the next representative */
+	virtual nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const & transaction_a, nano::account const & representative_a) const = 0;
+	virtual nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const & transaction_a) const = 0;
+	virtual nano::store_iterator<nano::delegator_key, nano::no_value> delegators_end () const = 0;
+
+	/** Secondary index of the hash of each block by its account and height, only maintained by ledgers with the index enabled */
+	virtual void account_height_put (nano::write_transaction const & transaction_a, nano::account const & account_a, uint64_t height_a, nano::block_hash const & hash_a) = 0;
+	virtual void account_height_del (nano::write_transaction const & transaction_a, nano::account const & account_a, uint64_t height_a) = 0;
+	/** Returns the hash of the block at \p height_a in the chain of \p account_a, zero if it isn't indexed */
+	virtual nano::block_hash account_height_get (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a) const = 0;
+	virtual void account_heights_clear (nano::write_transaction const & transaction_a) = 0;
+	virtual nano::store_iterator<nano::account_height_key, nano::block_hash> account_heights_begin (nano::transaction const & transaction_a) const = 0;
+	virtual nano::store_iterator<nano::account_height_key, nano::block_hash> account_heights_end () const = 0;
+
+	/** Blocks whose body was deleted by ledger pruning, only populated by ledgers with pruning enabled */
+	virtual void pruned_put (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::pruned_info const & pruned_info_a) = 0;
+	/** Returns true if \p hash_a was not pruned */
+	virtual bool pruned_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::pruned_info & pruned_info_a) const = 0;
+	virtual bool pruned_exists (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const = 0;
+	virtual size_t pruned_count (nano::transaction const & transaction_a) const = 0;
+
 	virtual void confirmation_height_put (nano::write_transaction const & transaction_a, nano::account const & account_a, nano::confirmation_height_info const & confirmation_height_info_a) = 0;
 	virtual bool confirmation_height_get (nano::transaction const & transaction_a, nano::account const & account_a, nano::confirmation_height_info & confirmation_height_info_a) = 0;
 	virtual bool confirmation_height_exists (nano::transaction const & transaction_a, nano::account const & account_a) const = 0;
@@ -807,6 +930,8 @@ public:
 	virtual nano::store_iterator<nano::account, nano::confirmation_height_info> confirmation_height_begin (nano::transaction const & transaction_a, nano::account const & account_a) = 0;
 	virtual nano::store_iterator<nano::account, nano::confirmation_height_info> confirmation_height_begin (nano::transaction const & transaction_a) = 0;
 	virtual nano::store_iterator<nano::account, nano::confirmation_height_info> confirmation_height_end () = 0;
+	/** Calls \p action_a concurrently for ranges of accounts covering the whole table, each with its own read transaction */
+	virtual void confirmation_height_for_each_par (std::function<void(nano::read_transaction const &, nano::store_iterator<nano::account, nano::confirmation_height_info>, nano::store_iterator<nano::account, nano::confirmation_height_info>)> const & action_a) = 0;
 
 	virtual uint64_t block_account_height (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const = 0;
 	virtual std::mutex & get_cache_mutex () = 0;
@@ -826,9 +951,15 @@ public:
 	virtual nano::read_transaction tx_begin_read () = 0;
 
 	virtual std::string vendor_get () const = 0;
+
+	/** While enabled commits are not flushed to disk individually and only become durable once sync () is called. Not applicable to all sub-classes */
+	virtual void deferred_sync_set (bool) = 0;
+	/** Flushes all commits made since the last sync to disk */
+	virtual void sync () = 0;
+
 };
 
-std::unique_ptr<nano::block_store> make_store (nano::logger_mt & logger, boost::filesystem::path const & path, bool open_read_only = false, bool add_db_postfix = false, nano::rocksdb_config const & rocksdb_config = nano::rocksdb_config{}, nano::txn_tracking_config const & txn_tracking_config_a = nano::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), int lmdb_max_dbs = 128, size_t batch_size = 512, bool backup_before_upgrade = false, bool rocksdb_backend = false);
+std::unique_ptr<nano::block_store> make_store (nano::logger_mt & logger, boost::filesystem::path const & path, bool open_read_only = false, bool add_db_postfix = false, nano::rocksdb_config const & rocksdb_config = nano::rocksdb_config{}, nano::txn_tracking_config const & txn_tracking_config_a = nano::txn_tracking_config{}, std::chrono::milliseconds block_processor_batch_max_time_a = std::chrono::milliseconds (5000), int lmdb_max_dbs = 128, size_t batch_size = 512, bool backup_before_upgrade = false, bool rocksdb_backend = false, nano::stat * stats = nullptr);
 }
 
 namespace std
@@ -6,10 +6,16 @@
 
 #include <crypto/cryptopp/words.h>
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
 namespace nano
 {
 template <typename Val, typename Derived_Store>
 class block_predecessor_set;
+template <typename Val, typename Derived_Store>
+class unchecked_iterator;
 
 /** This base class implements the block_store interface functions which have DB agnostic functionality */
 template <typename Val, typename Derived_Store>
@@ -20,6 +26,7 @@ public:
 	using block_store::unchecked_put;
 
 	friend class nano::block_predecessor_set<Val, Derived_Store>;
+	friend class nano::unchecked_iterator<Val, Derived_Store>;
 
 	std::mutex cache_mutex;
 
@@ -74,7 +81,7 @@ public:
 
 	bool pending_exists (nano::transaction const & transaction_a, nano::pending_key const & key_a) override
 	{
-		auto iterator (pending_begin (transaction_a, key_a));
+		auto iterator (make_prefix_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending, nano::db_val<Val> (key_a), sizeof (nano::account)));
 		return iterator != pending_end () && nano::pending_key (iterator->first) == key_a;
 	}
 
@@ -89,7 +96,8 @@ public:
 	std::vector<nano::unchecked_info> unchecked_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
 		std::vector<nano::unchecked_info> result;
-		for (auto i (unchecked_begin (transaction_a, nano::unchecked_key (hash_a, 0))), n (unchecked_end ()); i != n && i->first.key () == hash_a; ++i)
+		auto entries (make_prefix_iterator<nano::unchecked_key, nano::db_val<Val>> (transaction_a, tables::unchecked, nano::db_val<Val> (nano::unchecked_key (hash_a, 0)), sizeof (nano::block_hash)));
+		for (nano::store_iterator<nano::unchecked_key, nano::unchecked_info> i (std::make_unique<nano::unchecked_iterator<Val, Derived_Store>> (*this, std::move (entries), transaction_a)), n (unchecked_end ()); i != n && i->first.key () == hash_a; ++i)
 		{
 			nano::unchecked_info const & unchecked_info (i->second);
 			result.push_back (unchecked_info);
@@ -129,26 +137,36 @@ public:
 		std::shared_ptr<nano::block> result;
 		if (value.size () != 0)
 		{
-			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
-			result = nano::deserialize_block (stream, type);
-			debug_assert (result != nullptr);
-			if (sideband_a)
+			result = block_from_raw (transaction_a, hash_a, type, value, sideband_a);
+		}
+		return result;
+	}
+
+	std::vector<std::shared_ptr<nano::block>> block_get_many (nano::transaction const & transaction_a, std::vector<nano::block_hash> const & hashes_a, std::vector<nano::block_sideband> * sidebands_a = nullptr) const override
+	{
+		std::vector<std::shared_ptr<nano::block>> result (hashes_a.size ());
+		if (sidebands_a)
+		{
+			sidebands_a->assign (hashes_a.size (), nano::block_sideband ());
+		}
+		if (legacy_block_tables ())
+		{
+			// Blocks may still be spread over the per type tables
+			for (size_t i (0); i < hashes_a.size (); ++i)
 			{
-				sideband_a->type = type;
-				if (full_sideband (transaction_a) || entry_has_sideband (value.size (), type))
-				{
-					auto error (sideband_a->deserialize (stream));
-					(void)error;
-					debug_assert (!error);
-				}
-				else
+				result[i] = block_get (transaction_a, hashes_a[i], sidebands_a ? &(*sidebands_a)[i] : nullptr);
+			}
+		}
+		else
+		{
+			auto values (get_many_sorted (transaction_a, tables::blocks, hashes_a));
+			for (size_t i (0); i < values.size (); ++i)
+			{
+				if (values[i].size () != 0)
 				{
-					// Reconstruct sideband data for block.
-					sideband_a->account = block_account_computed (transaction_a, hash_a);
-					sideband_a->balance = block_balance_computed (transaction_a, hash_a);
-					sideband_a->successor = block_successor (transaction_a, hash_a);
-					sideband_a->height = 0;
-					sideband_a->timestamp = 0;
+					nano::block_type type;
+					auto value (block_raw_from_entry (values[i], type));
+					result[i] = block_from_raw (transaction_a, hashes_a[i], type, value, sidebands_a ? &(*sidebands_a)[i] : nullptr);
 				}
 			}
 		}
@@ -157,21 +175,20 @@ public:
 
 	bool block_exists (nano::transaction const & transaction_a, nano::block_type type, nano::block_hash const & hash_a) override
 	{
-		auto junk = block_raw_get_by_type (transaction_a, hash_a, type);
-		return junk.is_initialized ();
+		auto type_l (nano::block_type::invalid);
+		auto value (block_raw_get (transaction_a, hash_a, type_l));
+		return value.size () != 0 && type_l == type;
 	}
 
 	bool block_exists (nano::transaction const & tx_a, nano::block_hash const & hash_a) override
 	{
-		// Table lookups are ordered by match probability
-		// clang-format off
-		return
-			block_exists (tx_a, nano::block_type::state, hash_a) ||
-			block_exists (tx_a, nano::block_type::send, hash_a) ||
-			block_exists (tx_a, nano::block_type::receive, hash_a) ||
-			block_exists (tx_a, nano::block_type::open, hash_a) ||
-			block_exists (tx_a, nano::block_type::change, hash_a);
-		// clang-format on
+		auto result (exists (tx_a, tables::blocks, nano::db_val<Val> (hash_a)));
+		if (!result && legacy_block_tables ())
+		{
+			nano::block_type type;
+			result = block_raw_get_legacy (tx_a, hash_a, type).size () != 0;
+		}
+		return result;
 	}
 
 	bool root_exists (nano::transaction const & transaction_a, nano::root const & root_a) override
@@ -181,7 +198,9 @@ public:
 
 	bool source_exists (nano::transaction const & transaction_a, nano::block_hash const & source_a) override
 	{
-		return block_exists (transaction_a, nano::block_type::state, source_a) || block_exists (transaction_a, nano::block_type::send, source_a);
+		auto type (nano::block_type::invalid);
+		auto value (block_raw_get (transaction_a, source_a, type));
+		return value.size () != 0 && (type == nano::block_type::state || type == nano::block_type::send);
 	}
 
 	nano::account block_account (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
@@ -241,9 +260,9 @@ public:
 		return result;
 	}
 
-	bool full_sideband (nano::transaction const & transaction_a) const
+	bool full_sideband () const
 	{
-		return version_get (transaction_a) > 12;
+		return cached_version > 12;
 	}
 
 	void block_successor_clear (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a) override
@@ -336,6 +355,16 @@ public:
 		return nano::store_iterator<nano::endpoint_key, nano::no_value> (nullptr);
 	}
 
+	nano::store_iterator<nano::delegator_key, nano::no_value> delegators_end () const override
+	{
+		return nano::store_iterator<nano::delegator_key, nano::no_value> (nullptr);
+	}
+
+	nano::store_iterator<nano::account_height_key, nano::block_hash> account_heights_end () const override
+	{
+		return nano::store_iterator<nano::account_height_key, nano::block_hash> (nullptr);
+	}
+
 	nano::store_iterator<nano::pending_key, nano::pending_info> pending_end () override
 	{
 		return nano::store_iterator<nano::pending_key, nano::pending_info> (nullptr);
@@ -356,6 +385,22 @@ public:
 		return nano::store_iterator<nano::account, nano::confirmation_height_info> (nullptr);
 	}
 
+	void latest_for_each_par (std::function<void(nano::read_transaction const &, nano::store_iterator<nano::account, nano::account_info>, nano::store_iterator<nano::account, nano::account_info>)> const & action_a) override
+	{
+		parallel_traversal<nano::uint256_t> ([&action_a, this](nano::uint256_t const & start_a, nano::uint256_t const & end_a, bool const is_last_a) {
+			auto transaction (this->tx_begin_read ());
+			action_a (transaction, this->latest_begin (transaction, nano::account (start_a)), !is_last_a ? this->latest_begin (transaction, nano::account (end_a)) : this->latest_end ());
+		});
+	}
+
+	void confirmation_height_for_each_par (std::function<void(nano::read_transaction const &, nano::store_iterator<nano::account, nano::confirmation_height_info>, nano::store_iterator<nano::account, nano::confirmation_height_info>)> const & action_a) override
+	{
+		parallel_traversal<nano::uint256_t> ([&action_a, this](nano::uint256_t const & start_a, nano::uint256_t const & end_a, bool const is_last_a) {
+			auto transaction (this->tx_begin_read ());
+			action_a (transaction, this->confirmation_height_begin (transaction, nano::account (start_a)), !is_last_a ? this->confirmation_height_begin (transaction, nano::account (end_a)) : this->confirmation_height_end ());
+		});
+	}
+
 	std::mutex & get_cache_mutex () override
 	{
 		return cache_mutex;
@@ -363,30 +408,18 @@ public:
 
 	void block_del (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type block_type_a) override
 	{
-		auto table = tables::state_blocks;
-		switch (block_type_a)
+		if (exists (transaction_a, tables::blocks, nano::db_val<Val> (hash_a)))
 		{
-			case nano::block_type::open:
-				table = tables::open_blocks;
-				break;
-			case nano::block_type::receive:
-				table = tables::receive_blocks;
-				break;
-			case nano::block_type::send:
-				table = tables::send_blocks;
-				break;
-			case nano::block_type::change:
-				table = tables::change_blocks;
-				break;
-			case nano::block_type::state:
-				table = tables::state_blocks;
-				break;
-			default:
-				debug_assert (false);
+			auto status = del (transaction_a, tables::blocks, hash_a);
+			release_assert (success (status));
+			block_count_add (transaction_a, block_type_a, -1);
+		}
+		else
+		{
+			debug_assert (legacy_block_tables ());
+			auto status = del (transaction_a, block_database (block_type_a), hash_a);
+			release_assert (success (status));
 		}
-
-		auto status = del (transaction_a, table, hash_a);
-		release_assert (success (status));
 	}
 
 	int version_get (nano::transaction const & transaction_a) const override
@@ -404,6 +437,49 @@ public:
 		return result;
 	}
 
+	void cache_checkpoint_put (nano::write_transaction const & transaction_a, nano::ledger_cache & cache_a) override
+	{
+		std::vector<uint8_t> data;
+		{
+			nano::vectorstream stream (data);
+			nano::write (stream, transaction_sequence (transaction_a));
+			cache_a.serialize (stream);
+		}
+		auto checksum (cache_checkpoint_checksum (data.data (), data.size ()));
+		data.insert (data.end (), checksum.bytes.begin (), checksum.bytes.end ());
+		auto status (put (transaction_a, tables::meta, nano::db_val<Val> (cache_checkpoint_key ()), nano::db_val<Val> (data.size (), data.data ())));
+		release_assert (success (status));
+	}
+
+	bool cache_checkpoint_get (nano::transaction const & transaction_a, nano::ledger_cache & cache_a) const override
+	{
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::meta, nano::db_val<Val> (cache_checkpoint_key ()), value));
+		release_assert (success (status) || not_found (status));
+		auto error (!success (status) || value.size () < sizeof (uint64_t) + sizeof (nano::block_hash));
+		if (!error)
+		{
+			auto data (static_cast<uint8_t const *> (value.data ()));
+			auto size (value.size () - sizeof (nano::block_hash));
+			nano::block_hash checksum;
+			std::copy (data + size, data + value.size (), checksum.bytes.begin ());
+			error = checksum != cache_checkpoint_checksum (data, size);
+			if (!error)
+			{
+				nano::bufferstream stream (data, size);
+				uint64_t sequence;
+				error = nano::try_read (stream, sequence) || sequence != transaction_sequence (transaction_a) || cache_a.deserialize (stream);
+			}
+		}
+		return error;
+	}
+
+	void cache_checkpoint_del (nano::write_transaction const & transaction_a) override
+	{
+		auto status (del (transaction_a, tables::meta, nano::db_val<Val> (cache_checkpoint_key ())));
+		release_assert (success (status) || not_found (status));
+	}
+
 	nano::epoch block_version (nano::transaction const & transaction_a, nano::block_hash const & hash_a) override
 	{
 		nano::db_val<Val> value;
@@ -417,12 +493,29 @@ public:
 		return nano::epoch::epoch_0;
 	}
 
+	/** Writes \p data, the serialized block and sideband, to the blocks table behind the block type byte. Ledgers before version 19 write new blocks to the table of their type */
 	void block_raw_put (nano::write_transaction const & transaction_a, std::vector<uint8_t> const & data, nano::block_type block_type_a, nano::block_hash const & hash_a)
 	{
-		auto database_a = block_database (block_type_a);
-		nano::db_val<Val> value{ data.size (), (void *)data.data () };
-		auto status = put (transaction_a, database_a, hash_a, value);
-		release_assert (success (status));
+		auto existing (exists (transaction_a, tables::blocks, nano::db_val<Val> (hash_a)));
+		if (!existing && legacy_block_tables ())
+		{
+			// Upgrades before version 19 keep writing the tables they read from
+			auto status = put (transaction_a, block_database (block_type_a), hash_a, nano::db_val<Val>{ data.size (), (void *)data.data () });
+			release_assert (success (status));
+		}
+		else
+		{
+			if (!existing)
+			{
+				block_count_add (transaction_a, block_type_a, 1);
+			}
+			std::vector<uint8_t> entry;
+			entry.reserve (1 + data.size ());
+			entry.push_back (static_cast<uint8_t> (block_type_a));
+			entry.insert (entry.end (), data.begin (), data.end ());
+			auto status = put (transaction_a, tables::blocks, hash_a, nano::db_val<Val>{ entry.size (), (void *)entry.data () });
+			release_assert (success (status));
+		}
 	}
 
 	void pending_put (nano::write_transaction const & transaction_a, nano::pending_key const & key_a, nano::pending_info const & pending_info_a) override
@@ -481,8 +574,24 @@ public:
 
 	void unchecked_put (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a) override
 	{
-		nano::db_val<Val> info (info_a);
-		auto status (put (transaction_a, tables::unchecked, key_a, info));
+		unchecked_put (transaction_a, key_a, info_a, unchecked_exists (transaction_a, key_a));
+	}
+
+	void unchecked_put (nano::write_transaction const & transaction_a, nano::unchecked_key const & key_a, nano::unchecked_info const & info_a, bool exists_a) override
+	{
+		debug_assert (key_a.hash == info_a.block->hash ());
+		debug_assert (exists_a == unchecked_exists (transaction_a, key_a));
+		// A block waiting on more than one dependency is stored once, each entry references the body by the block hash in its key
+		if (!exists_a)
+		{
+			unchecked_body_acquire (transaction_a, *info_a.block);
+		}
+		std::vector<uint8_t> details;
+		{
+			nano::vectorstream stream (details);
+			info_a.serialize_details (stream);
+		}
+		auto status (put (transaction_a, tables::unchecked, key_a, nano::db_val<Val> (details.size (), details.data ())));
 		release_assert (success (status));
 	}
 
@@ -490,6 +599,10 @@ public:
 	{
 		auto status (del (transaction_a, tables::unchecked, key_a));
 		release_assert (success (status) || not_found (status));
+		if (success (status))
+		{
+			unchecked_body_release (transaction_a, key_a.hash);
+		}
 		return not_found (status);
 	}
 
@@ -570,10 +683,17 @@ public:
 		return result;
 	}
 
+	std::vector<boost::optional<nano::account_info>> account_get_many (nano::transaction const & transaction_a, std::vector<nano::account> const & accounts_a) override
+	{
+		return deserialize_many<nano::account_info> (get_many_sorted (transaction_a, tables::accounts, accounts_a));
+	}
+
 	void unchecked_clear (nano::write_transaction const & transaction_a) override
 	{
 		auto status = drop (transaction_a, tables::unchecked);
 		release_assert (success (status));
+		status = drop (transaction_a, tables::unchecked_bodies);
+		release_assert (success (status));
 	}
 
 	size_t online_weight_count (nano::transaction const & transaction_a) const override
@@ -616,6 +736,92 @@ public:
 		release_assert (success (status));
 	}
 
+	void delegator_put (nano::write_transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) override
+	{
+		nano::db_val<Val> zero (static_cast<uint64_t> (0));
+		auto status = put (transaction_a, tables::delegators, nano::delegator_key (representative_a, account_a), zero);
+		release_assert (success (status));
+	}
+
+	void delegator_del (nano::write_transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) override
+	{
+		auto status (del (transaction_a, tables::delegators, nano::delegator_key (representative_a, account_a)));
+		release_assert (success (status));
+	}
+
+	bool delegator_exists (nano::transaction const & transaction_a, nano::account const & representative_a, nano::account const & account_a) const override
+	{
+		return exists (transaction_a, tables::delegators, nano::db_val<Val> (nano::delegator_key (representative_a, account_a)));
+	}
+
+	void delegators_clear (nano::write_transaction const & transaction_a) override
+	{
+		auto status = drop (transaction_a, tables::delegators);
+		release_assert (success (status));
+	}
+
+	void account_height_put (nano::write_transaction const & transaction_a, nano::account const & account_a, uint64_t height_a, nano::block_hash const & hash_a) override
+	{
+		auto status = put (transaction_a, tables::account_heights, nano::account_height_key (account_a, height_a), hash_a);
+		release_assert (success (status));
+	}
+
+	void account_height_del (nano::write_transaction const & transaction_a, nano::account const & account_a, uint64_t height_a) override
+	{
+		auto status (del (transaction_a, tables::account_heights, nano::account_height_key (account_a, height_a)));
+		release_assert (success (status));
+	}
+
+	nano::block_hash account_height_get (nano::transaction const & transaction_a, nano::account const & account_a, uint64_t height_a) const override
+	{
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::account_heights, nano::db_val<Val> (nano::account_height_key (account_a, height_a)), value));
+		release_assert (success (status) || not_found (status));
+		nano::block_hash result (0);
+		if (success (status))
+		{
+			result = static_cast<nano::block_hash> (value);
+		}
+		return result;
+	}
+
+	void account_heights_clear (nano::write_transaction const & transaction_a) override
+	{
+		auto status = drop (transaction_a, tables::account_heights);
+		release_assert (success (status));
+	}
+
+	void pruned_put (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a, nano::pruned_info const & pruned_info_a) override
+	{
+		nano::db_val<Val> pruned_info (pruned_info_a);
+		auto status = put (transaction_a, tables::pruned, hash_a, pruned_info);
+		release_assert (success (status));
+	}
+
+	bool pruned_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::pruned_info & pruned_info_a) const override
+	{
+		nano::db_val<Val> value;
+		auto status = get (transaction_a, tables::pruned, nano::db_val<Val> (hash_a), value);
+		release_assert (success (status) || not_found (status));
+		bool result (true);
+		if (success (status))
+		{
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			result = pruned_info_a.deserialize (stream);
+		}
+		return result;
+	}
+
+	bool pruned_exists (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const override
+	{
+		return exists (transaction_a, tables::pruned, nano::db_val<Val> (hash_a));
+	}
+
+	size_t pruned_count (nano::transaction const & transaction_a) const override
+	{
+		return count (transaction_a, tables::pruned);
+	}
+
 	bool exists (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a) const
 	{
 		return static_cast<const Derived_Store &> (*this).exists (transaction_a, table_a, key_a);
@@ -624,11 +830,19 @@ public:
 	nano::block_counts block_count (nano::transaction const & transaction_a) override
 	{
 		nano::block_counts result;
-		result.send = count (transaction_a, tables::send_blocks);
-		result.receive = count (transaction_a, tables::receive_blocks);
-		result.open = count (transaction_a, tables::open_blocks);
-		result.change = count (transaction_a, tables::change_blocks);
-		result.state = count (transaction_a, tables::state_blocks);
+		result.send = block_count_get (transaction_a, nano::block_type::send);
+		result.receive = block_count_get (transaction_a, nano::block_type::receive);
+		result.open = block_count_get (transaction_a, nano::block_type::open);
+		result.change = block_count_get (transaction_a, nano::block_type::change);
+		result.state = block_count_get (transaction_a, nano::block_type::state);
+		if (legacy_block_tables ())
+		{
+			result.send += count (transaction_a, tables::send_blocks);
+			result.receive += count (transaction_a, tables::receive_blocks);
+			result.open += count (transaction_a, tables::open_blocks);
+			result.change += count (transaction_a, tables::change_blocks);
+			result.state += count (transaction_a, tables::state_blocks);
+		}
 		return result;
 	}
 
@@ -639,45 +853,16 @@ public:
 
 	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a) override
 	{
-		auto count (block_count (transaction_a));
-		release_assert (std::numeric_limits<CryptoPP::word32>::max () > count.sum ());
-		auto region = static_cast<size_t> (nano::random_pool::generate_word32 (0, static_cast<CryptoPP::word32> (count.sum () - 1)));
-		std::shared_ptr<nano::block> result;
-		auto & derived_store = static_cast<Derived_Store &> (*this);
-		if (region < count.send)
+		nano::block_hash hash;
+		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
+		auto existing = make_iterator<nano::block_hash, std::shared_ptr<nano::block>> (transaction_a, tables::blocks, nano::db_val<Val> (hash));
+		auto end (nano::store_iterator<nano::block_hash, std::shared_ptr<nano::block>> (nullptr));
+		if (existing == end)
 		{
-			result = derived_store.template block_random<nano::send_block> (transaction_a, tables::send_blocks);
+			existing = make_iterator<nano::block_hash, std::shared_ptr<nano::block>> (transaction_a, tables::blocks);
 		}
-		else
-		{
-			region -= count.send;
-			if (region < count.receive)
-			{
-				result = derived_store.template block_random<nano::receive_block> (transaction_a, tables::receive_blocks);
-			}
-			else
-			{
-				region -= count.receive;
-				if (region < count.open)
-				{
-					result = derived_store.template block_random<nano::open_block> (transaction_a, tables::open_blocks);
-				}
-				else
-				{
-					region -= count.open;
-					if (region < count.change)
-					{
-						result = derived_store.template block_random<nano::change_block> (transaction_a, tables::change_blocks);
-					}
-					else
-					{
-						result = derived_store.template block_random<nano::state_block> (transaction_a, tables::state_blocks);
-					}
-				}
-			}
-		}
-		debug_assert (result != nullptr);
-		return result;
+		debug_assert (existing != end);
+		return existing->second;
 	}
 
 	uint64_t confirmation_height_count (nano::transaction const & transaction_a) override
@@ -737,14 +922,19 @@ public:
 		return make_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending);
 	}
 
+	nano::store_iterator<nano::pending_key, nano::pending_info> pending_account_begin (nano::transaction const & transaction_a, nano::account const & account_a) override
+	{
+		return make_prefix_iterator<nano::pending_key, nano::pending_info> (transaction_a, tables::pending, nano::db_val<Val> (nano::pending_key (account_a, 0)), sizeof (nano::account));
+	}
+
 	nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_begin (nano::transaction const & transaction_a) const override
 	{
-		return make_iterator<nano::unchecked_key, nano::unchecked_info> (transaction_a, tables::unchecked);
+		return nano::store_iterator<nano::unchecked_key, nano::unchecked_info> (std::make_unique<nano::unchecked_iterator<Val, Derived_Store>> (*this, make_iterator<nano::unchecked_key, nano::db_val<Val>> (transaction_a, tables::unchecked), transaction_a));
 	}
 
 	nano::store_iterator<nano::unchecked_key, nano::unchecked_info> unchecked_begin (nano::transaction const & transaction_a, nano::unchecked_key const & key_a) const override
 	{
-		return make_iterator<nano::unchecked_key, nano::unchecked_info> (transaction_a, tables::unchecked, nano::db_val<Val> (key_a));
+		return nano::store_iterator<nano::unchecked_key, nano::unchecked_info> (std::make_unique<nano::unchecked_iterator<Val, Derived_Store>> (*this, make_iterator<nano::unchecked_key, nano::db_val<Val>> (transaction_a, tables::unchecked, nano::db_val<Val> (key_a)), transaction_a));
 	}
 
 	nano::store_iterator<nano::account, std::shared_ptr<nano::vote>> vote_begin (nano::transaction const & transaction_a) override
@@ -762,6 +952,21 @@ public:
 		return make_iterator<nano::endpoint_key, nano::no_value> (transaction_a, tables::peers);
 	}
 
+	nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const & transaction_a, nano::account const & representative_a) const override
+	{
+		return make_iterator<nano::delegator_key, nano::no_value> (transaction_a, tables::delegators, nano::db_val<Val> (nano::delegator_key (representative_a, 0)));
+	}
+
+	nano::store_iterator<nano::delegator_key, nano::no_value> delegators_begin (nano::transaction const & transaction_a) const override
+	{
+		return make_iterator<nano::delegator_key, nano::no_value> (transaction_a, tables::delegators);
+	}
+
+	nano::store_iterator<nano::account_height_key, nano::block_hash> account_heights_begin (nano::transaction const & transaction_a) const override
+	{
+		return make_iterator<nano::account_height_key, nano::block_hash> (transaction_a, tables::account_heights);
+	}
+
 	nano::store_iterator<nano::account, nano::confirmation_height_info> confirmation_height_begin (nano::transaction const & transaction_a, nano::account const & account_a) override
 	{
 		return make_iterator<nano::account, nano::confirmation_height_info> (transaction_a, tables::confirmation_height, nano::db_val<Val> (account_a));
@@ -781,22 +986,9 @@ protected:
 	nano::network_params network_params;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l1;
 	std::unordered_map<nano::account, std::shared_ptr<nano::vote>> vote_cache_l2;
-	static int constexpr version{ 18 };
-
-	template <typename T>
-	std::shared_ptr<nano::block> block_random (nano::transaction const & transaction_a, tables table_a)
-	{
-		nano::block_hash hash;
-		nano::random_pool::generate_block (hash.bytes.data (), hash.bytes.size ());
-		auto existing = make_iterator<nano::block_hash, std::shared_ptr<T>> (transaction_a, table_a, nano::db_val<Val> (hash));
-		if (existing == nano::store_iterator<nano::block_hash, std::shared_ptr<T>> (nullptr))
-		{
-			existing = make_iterator<nano::block_hash, std::shared_ptr<T>> (transaction_a, table_a);
-		}
-		auto end (nano::store_iterator<nano::block_hash, std::shared_ptr<T>> (nullptr));
-		debug_assert (existing != end);
-		return block_get (transaction_a, nano::block_hash (existing->first));
-	}
+	static int constexpr version{ 23 };
+	/** Version of the ledger, read on open and kept by version_put () so reading blocks does not look it up in the meta table */
+	std::atomic<int> cached_version{ 0 };
 
 	template <typename Key, typename Value>
 	nano::store_iterator<Key, Value> make_iterator (nano::transaction const & transaction_a, tables table_a) const
@@ -810,12 +1002,129 @@ protected:
 		return static_cast<Derived_Store const &> (*this).template make_iterator<Key, Value> (transaction_a, table_a, key);
 	}
 
+	/** Seeks to \p key, the iterator may end after the last key sharing its first \p prefix_size_a bytes so callers must not walk past them */
+	template <typename Key, typename Value>
+	nano::store_iterator<Key, Value> make_prefix_iterator (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key, size_t prefix_size_a) const
+	{
+		return static_cast<Derived_Store const &> (*this).template make_prefix_iterator<Key, Value> (transaction_a, table_a, key, prefix_size_a);
+	}
+
 	bool entry_has_sideband (size_t entry_size_a, nano::block_type type_a) const
 	{
 		return entry_size_a == nano::block::size (type_a) + nano::block_sideband::size (type_a);
 	}
 
+	/** Returns the serialized block and sideband stored under \p hash_a, without the block type byte which is returned in \p type_a */
 	nano::db_val<Val> block_raw_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
+	{
+		nano::db_val<Val> result;
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::blocks, nano::db_val<Val> (hash_a), value));
+		release_assert (success (status) || not_found (status));
+		if (success (status))
+		{
+			result = block_raw_from_entry (value, type_a);
+		}
+		else if (legacy_block_tables ())
+		{
+			result = block_raw_get_legacy (transaction_a, hash_a, type_a);
+		}
+		return result;
+	}
+
+	/** Builds a block, and optionally its sideband, from the entry \p value_a stored under \p hash_a as seen by this transaction */
+	std::shared_ptr<nano::block> block_from_raw (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type type_a, nano::db_val<Val> const & value_a, nano::block_sideband * sideband_a) const
+	{
+		nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value_a.data ()), value_a.size ());
+		auto result (nano::deserialize_block (stream, type_a));
+		debug_assert (result != nullptr);
+		if (sideband_a)
+		{
+			sideband_a->type = type_a;
+			if (full_sideband () || entry_has_sideband (value_a.size (), type_a))
+			{
+				auto error (sideband_a->deserialize (stream));
+				(void)error;
+				debug_assert (!error);
+			}
+			else
+			{
+				// Reconstruct sideband data for block.
+				sideband_a->account = block_account_computed (transaction_a, hash_a);
+				sideband_a->balance = block_balance_computed (transaction_a, hash_a);
+				sideband_a->successor = block_successor (transaction_a, hash_a);
+				sideband_a->height = 0;
+				sideband_a->timestamp = 0;
+			}
+		}
+		return result;
+	}
+
+	/** Splits a blocks table entry into the block type byte and the serialized block and sideband that follow it */
+	nano::db_val<Val> block_raw_from_entry (nano::db_val<Val> const & value_a, nano::block_type & type_a) const
+	{
+		debug_assert (value_a.size () > 1);
+		type_a = static_cast<nano::block_type> (reinterpret_cast<uint8_t const *> (value_a.data ())[0]);
+		nano::db_val<Val> result (value_a.size () - 1, static_cast<uint8_t *> (value_a.data ()) + 1);
+		result.buffer = value_a.buffer;
+		return result;
+	}
+
+	/**
+	 * Looks up \p keys_a in ascending key order so the backend can sweep the table rather than seek from the root for each key.
+	 * Values are returned in the order of \p keys_a, missing keys have an empty value.
+	 */
+	template <typename Key>
+	std::vector<nano::db_val<Val>> get_many_sorted (nano::transaction const & transaction_a, tables table_a, std::vector<Key> const & keys_a) const
+	{
+		// Keys are fixed size and both backends compare them bytewise
+		std::vector<size_t> order (keys_a.size ());
+		std::iota (order.begin (), order.end (), 0);
+		std::sort (order.begin (), order.end (), [&keys_a](size_t lhs, size_t rhs) {
+			return std::memcmp (&keys_a[lhs], &keys_a[rhs], sizeof (Key)) < 0;
+		});
+		std::vector<nano::db_val<Val>> sorted_keys;
+		sorted_keys.reserve (keys_a.size ());
+		for (auto index : order)
+		{
+			sorted_keys.emplace_back (keys_a[index]);
+		}
+		std::vector<nano::db_val<Val>> sorted_values (keys_a.size ());
+		get_many (transaction_a, table_a, sorted_keys, sorted_values);
+		std::vector<nano::db_val<Val>> result (keys_a.size ());
+		for (size_t i (0); i < order.size (); ++i)
+		{
+			result[order[i]] = sorted_values[i];
+		}
+		return result;
+	}
+
+	template <typename T>
+	std::vector<boost::optional<T>> deserialize_many (std::vector<nano::db_val<Val>> const & values_a) const
+	{
+		std::vector<boost::optional<T>> result (values_a.size ());
+		for (size_t i (0); i < values_a.size (); ++i)
+		{
+			if (values_a[i].size () != 0)
+			{
+				T item;
+				nano::bufferstream stream (reinterpret_cast<uint8_t const *> (values_a[i].data ()), values_a[i].size ());
+				auto error (item.deserialize (stream));
+				(void)error;
+				debug_assert (!error);
+				result[i] = item;
+			}
+		}
+		return result;
+	}
+
+	/** Ledgers before version 19 keep each block type in its own table, these are only read while upgrading */
+	bool legacy_block_tables () const
+	{
+		return cached_version < 19;
+	}
+
+	nano::db_val<Val> block_raw_get_legacy (nano::transaction const & transaction_a, nano::block_hash const & hash_a, nano::block_type & type_a) const
 	{
 		nano::db_val<Val> result;
 		// Table lookups are ordered by match probability
@@ -834,10 +1143,33 @@ protected:
 		return result;
 	}
 
+	/** Key in the block counts table holding the number of blocks of \p type_a */
+	static nano::uint256_union block_count_key (nano::block_type type_a)
+	{
+		// Offset so the keys can't clash with the version key in the meta table
+		return nano::uint256_union (0x100 + static_cast<uint8_t> (type_a));
+	}
+
+	uint64_t block_count_get (nano::transaction const & transaction_a, nano::block_type type_a) const
+	{
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, block_counts_table (), nano::db_val<Val> (block_count_key (type_a)), value));
+		release_assert (success (status) || not_found (status));
+		return success (status) ? static_cast<uint64_t> (value) : 0;
+	}
+
+	void block_count_add (nano::write_transaction const & transaction_a, nano::block_type type_a, int64_t amount_a)
+	{
+		auto count_l (block_count_get (transaction_a, type_a));
+		debug_assert (amount_a >= 0 || count_l >= static_cast<uint64_t> (-amount_a));
+		auto status (put (transaction_a, block_counts_table (), nano::db_val<Val> (block_count_key (type_a)), nano::db_val<Val> (static_cast<uint64_t> (count_l + amount_a))));
+		release_assert (success (status));
+	}
+
 	// Return account containing hash
 	nano::account block_account_computed (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 	{
-		debug_assert (!full_sideband (transaction_a));
+		debug_assert (!full_sideband ());
 		nano::account result (0);
 		auto hash (hash_a);
 		while (result.is_zero ())
@@ -879,7 +1211,7 @@ protected:
 
 	nano::uint128_t block_balance_computed (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 	{
-		debug_assert (!full_sideband (transaction_a));
+		debug_assert (!full_sideband ());
 		summation_visitor visitor (transaction_a, *this);
 		return visitor.compute_balance (hash_a);
 	}
@@ -887,7 +1219,7 @@ protected:
 	size_t block_successor_offset (nano::transaction const & transaction_a, size_t entry_size_a, nano::block_type type_a) const
 	{
 		size_t result;
-		if (full_sideband (transaction_a) || entry_has_sideband (entry_size_a, type_a))
+		if (full_sideband () || entry_has_sideband (entry_size_a, type_a))
 		{
 			result = entry_size_a - nano::block_sideband::size (type_a);
 		}
@@ -985,11 +1317,87 @@ protected:
 		return total_count;
 	}
 
+	/** Unchecked bodies are stored as the number of entries referencing them followed by the serialized block */
+	void unchecked_body_acquire (nano::write_transaction const & transaction_a, nano::block const & block_a)
+	{
+		auto hash (block_a.hash ());
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash), value));
+		release_assert (success (status) || not_found (status));
+		std::vector<uint8_t> data;
+		if (success (status))
+		{
+			data.assign (reinterpret_cast<uint8_t const *> (value.data ()), reinterpret_cast<uint8_t const *> (value.data ()) + value.size ());
+			unchecked_body_references_add (data, 1);
+		}
+		else
+		{
+			nano::vectorstream stream (data);
+			nano::write (stream, uint64_t{ 1 });
+			nano::serialize_block (stream, block_a);
+		}
+		status = put (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash), nano::db_val<Val> (data.size (), data.data ()));
+		release_assert (success (status));
+	}
+
+	void unchecked_body_release (nano::write_transaction const & transaction_a, nano::block_hash const & hash_a)
+	{
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash_a), value));
+		release_assert (success (status));
+		std::vector<uint8_t> data (reinterpret_cast<uint8_t const *> (value.data ()), reinterpret_cast<uint8_t const *> (value.data ()) + value.size ());
+		if (unchecked_body_references_add (data, -1) > 0)
+		{
+			status = put (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash_a), nano::db_val<Val> (data.size (), data.data ()));
+		}
+		else
+		{
+			status = del (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash_a));
+		}
+		release_assert (success (status));
+	}
+
+	/** Adjusts the reference count at the start of a serialized body in place, returns the new count */
+	static uint64_t unchecked_body_references_add (std::vector<uint8_t> & data_a, int64_t amount_a)
+	{
+		uint64_t references;
+		release_assert (data_a.size () > sizeof (references));
+		std::memcpy (&references, data_a.data (), sizeof (references));
+		debug_assert (amount_a > 0 || references > 0);
+		references += amount_a;
+		std::memcpy (data_a.data (), &references, sizeof (references));
+		return references;
+	}
+
+	std::shared_ptr<nano::block> unchecked_body_get (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+	{
+		std::shared_ptr<nano::block> result;
+		nano::db_val<Val> value;
+		auto status (get (transaction_a, tables::unchecked_bodies, nano::db_val<Val> (hash_a), value));
+		release_assert (success (status) || not_found (status));
+		if (success (status))
+		{
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (value.data ()), value.size ());
+			uint64_t references;
+			auto error (nano::try_read (stream, references));
+			(void)error;
+			debug_assert (!error);
+			result = nano::deserialize_block (stream);
+		}
+		return result;
+	}
+
 	int get (nano::transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a, nano::db_val<Val> & value_a) const
 	{
 		return static_cast<Derived_Store const &> (*this).get (transaction_a, table_a, key_a, value_a);
 	}
 
+	/** \p keys_a must be in ascending order, \p values_a is sized to match and missing keys are left empty */
+	void get_many (nano::transaction const & transaction_a, tables table_a, std::vector<nano::db_val<Val>> const & keys_a, std::vector<nano::db_val<Val>> & values_a) const
+	{
+		static_cast<Derived_Store const &> (*this).get_many (transaction_a, table_a, keys_a, values_a);
+	}
+
 	int put (nano::write_transaction const & transaction_a, tables table_a, nano::db_val<Val> const & key_a, nano::db_val<Val> const & value_a)
 	{
 		return static_cast<Derived_Store &> (*this).put (transaction_a, table_a, key_a, value_a);
@@ -1001,10 +1409,30 @@ protected:
 	}
 
 	virtual size_t count (nano::transaction const & transaction_a, tables table_a) const = 0;
+	/** Table holding the number of blocks of each type, maintained by block_put and block_del */
+	virtual tables block_counts_table () const = 0;
 	virtual int drop (nano::write_transaction const & transaction_a, tables table_a) = 0;
 	virtual bool not_found (int status) const = 0;
 	virtual bool success (int status) const = 0;
 	virtual int status_code_not_found () const = 0;
+	/** Sequence number of the last commit seen by \p transaction_a, a write transaction sees the number its own commit will have. It changes with every commit which modifies the ledger */
+	virtual uint64_t transaction_sequence (nano::transaction const & transaction_a) const = 0;
+
+	static nano::uint256_union cache_checkpoint_key ()
+	{
+		// Offset past the block count keys in the meta table
+		return nano::uint256_union (0x200);
+	}
+
+	static nano::block_hash cache_checkpoint_checksum (uint8_t const * data_a, size_t size_a)
+	{
+		nano::block_hash result;
+		blake2b_state state;
+		blake2b_init (&state, sizeof (result.bytes));
+		blake2b_update (&state, data_a, size_a);
+		blake2b_final (&state, result.bytes.data (), sizeof (result.bytes));
+		return result;
+	}
 };
 
 /**
@@ -1056,4 +1484,59 @@ public:
 	nano::write_transaction const & transaction;
 	nano::block_store_partial<Val, Derived_Store> & store;
 };
+
+/**
+ * Iterates the unchecked table, joining each entry with the block body it references
+ */
+template <typename Val, typename Derived_Store>
+class unchecked_iterator : public nano::store_iterator_impl<nano::unchecked_key, nano::unchecked_info>
+{
+public:
+	unchecked_iterator (nano::block_store_partial<Val, Derived_Store> const & store_a, nano::store_iterator<nano::unchecked_key, nano::db_val<Val>> entries_a, nano::transaction const & transaction_a) :
+	store (store_a),
+	entries (std::move (entries_a)),
+	transaction (transaction_a)
+	{
+	}
+	nano::store_iterator_impl<nano::unchecked_key, nano::unchecked_info> & operator++ () override
+	{
+		++entries;
+		return *this;
+	}
+	bool operator== (nano::store_iterator_impl<nano::unchecked_key, nano::unchecked_info> const & other_a) const override
+	{
+		auto const other (boost::polymorphic_downcast<nano::unchecked_iterator<Val, Derived_Store> const *> (&other_a));
+		return entries == other->entries;
+	}
+	bool is_end_sentinal () const override
+	{
+		return entries == nano::store_iterator<nano::unchecked_key, nano::db_val<Val>> (nullptr);
+	}
+	void fill (std::pair<nano::unchecked_key, nano::unchecked_info> & value_a) const override
+	{
+		if (!is_end_sentinal ())
+		{
+			value_a.first = entries->first;
+			nano::bufferstream stream (reinterpret_cast<uint8_t const *> (entries->second.data ()), entries->second.size ());
+			nano::unchecked_info info;
+			auto error (info.deserialize_details (stream));
+			(void)error;
+			debug_assert (!error);
+			info.block = store.unchecked_body_get (transaction, value_a.first.hash);
+			debug_assert (info.block != nullptr);
+			value_a.second = info;
+		}
+		else
+		{
+			value_a.first = nano::unchecked_key{};
+			value_a.second = nano::unchecked_info{};
+		}
+	}
+
+private:
+	nano::block_store_partial<Val, Derived_Store> const & store;
+	/** Mutable as store_iterator only gives non-const access to the current entry */
+	mutable nano::store_iterator<nano::unchecked_key, nano::db_val<Val>> entries;
+	nano::transaction const & transaction;
+};
 }
@@ -134,6 +134,7 @@ nano::node_constants::node_constants (nano::network_constants & network_constant
 	search_pending_interval = network_constants.is_test_network () ? std::chrono::seconds (1) : std::chrono::seconds (5 * 60);
 	peer_interval = search_pending_interval;
 	unchecked_cleaning_interval = std::chrono::minutes (30);
+	pruning_interval = network_constants.is_test_network () ? std::chrono::seconds (1) : std::chrono::seconds (5 * 60);
 	process_confirmed_interval = network_constants.is_test_network () ? std::chrono::milliseconds (50) : std::chrono::milliseconds (500);
 	max_weight_samples = network_constants.is_live_network () ? 4032 : 864;
 	weight_period = 5 * 60; // 5 minutes
@@ -347,9 +348,7 @@ void nano::unchecked_info::serialize (nano::stream & stream_a) const
 {
 	debug_assert (block != nullptr);
 	nano::serialize_block (stream_a, *block);
-	nano::write (stream_a, account.bytes);
-	nano::write (stream_a, modified);
-	nano::write (stream_a, verified);
+	serialize_details (stream_a);
 }
 
 bool nano::unchecked_info::deserialize (nano::stream & stream_a)
@@ -358,16 +357,30 @@ bool nano::unchecked_info::deserialize (nano::stream & stream_a)
 	bool error (block == nullptr);
 	if (!error)
 	{
-		try
-		{
-			nano::read (stream_a, account.bytes);
-			nano::read (stream_a, modified);
-			nano::read (stream_a, verified);
-		}
-		catch (std::runtime_error const &)
-		{
-			error = true;
-		}
+		error = deserialize_details (stream_a);
+	}
+	return error;
+}
+
+void nano::unchecked_info::serialize_details (nano::stream & stream_a) const
+{
+	nano::write (stream_a, account.bytes);
+	nano::write (stream_a, modified);
+	nano::write (stream_a, verified);
+}
+
+bool nano::unchecked_info::deserialize_details (nano::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		nano::read (stream_a, account.bytes);
+		nano::read (stream_a, modified);
+		nano::read (stream_a, verified);
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
 	}
 	return error;
 }
@@ -387,6 +400,85 @@ uint16_t nano::endpoint_key::port () const
 	return boost::endian::big_to_native (network_port);
 }
 
+nano::pruned_info::pruned_info (nano::account const & account_a, uint64_t height_a, nano::amount const & balance_a) :
+account (account_a),
+height (height_a),
+balance (balance_a)
+{
+}
+
+void nano::pruned_info::serialize (nano::stream & stream_a) const
+{
+	nano::write (stream_a, account.bytes);
+	nano::write (stream_a, height);
+	nano::write (stream_a, balance.bytes);
+}
+
+bool nano::pruned_info::deserialize (nano::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		nano::read (stream_a, account.bytes);
+		nano::read (stream_a, height);
+		nano::read (stream_a, balance.bytes);
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
+void nano::ledger_cache::serialize (nano::stream & stream_a)
+{
+	nano::write (stream_a, cemented_count.load ());
+	nano::write (stream_a, block_count.load ());
+	nano::write (stream_a, unchecked_count.load ());
+	nano::write (stream_a, account_count.load ());
+	nano::write (stream_a, pruned_count.load ());
+	auto rep_amounts (rep_weights.get_rep_amounts ());
+	nano::write (stream_a, static_cast<uint64_t> (rep_amounts.size ()));
+	for (auto const & rep_amount : rep_amounts)
+	{
+		nano::write (stream_a, rep_amount.first.bytes);
+		nano::write (stream_a, nano::amount (rep_amount.second).bytes);
+	}
+}
+
+bool nano::ledger_cache::deserialize (nano::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		uint64_t count;
+		nano::read (stream_a, count);
+		cemented_count = count;
+		nano::read (stream_a, count);
+		block_count = count;
+		nano::read (stream_a, count);
+		unchecked_count = count;
+		nano::read (stream_a, count);
+		account_count = count;
+		nano::read (stream_a, count);
+		pruned_count = count;
+		nano::read (stream_a, count);
+		for (uint64_t i (0); i < count; ++i)
+		{
+			nano::account representative;
+			nano::amount amount;
+			nano::read (stream_a, representative.bytes);
+			nano::read (stream_a, amount.bytes);
+			rep_weights.representation_put (representative, amount);
+		}
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
 nano::confirmation_height_info::confirmation_height_info (uint64_t confirmation_height_a, nano::block_hash const & confirmed_frontier_a) :
 height (confirmation_height_a),
 frontier (confirmed_frontier_a)
@@ -854,3 +946,52 @@ nano::block_hash const & nano::unchecked_key::key () const
 {
 	return previous;
 }
+
+nano::delegator_key::delegator_key (nano::account const & representative_a, nano::account const & account_a) :
+representative (representative_a),
+account (account_a)
+{
+}
+
+bool nano::delegator_key::operator== (nano::delegator_key const & other_a) const
+{
+	return representative == other_a.representative && account == other_a.account;
+}
+
+nano::account const & nano::delegator_key::key () const
+{
+	return representative;
+}
+
+nano::account_height_key::account_height_key (nano::account const & account_a, uint64_t height_a) :
+account (account_a),
+height (height_a)
+{
+}
+
+void nano::account_height_key::serialize (nano::stream & stream_a) const
+{
+	nano::write (stream_a, account);
+	nano::write (stream_a, boost::endian::native_to_big (height));
+}
+
+bool nano::account_height_key::deserialize (nano::stream & stream_a)
+{
+	auto error (false);
+	try
+	{
+		nano::read (stream_a, account);
+		nano::read (stream_a, height);
+		boost::endian::big_to_native_inplace (height);
+	}
+	catch (std::runtime_error const &)
+	{
+		error = true;
+	}
+	return error;
+}
+
+bool nano::account_height_key::operator== (nano::account_height_key const & other_a) const
+{
+	return account == other_a.account && height == other_a.height;
+}
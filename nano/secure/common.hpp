@@ -171,6 +171,35 @@ public:
 	nano::block_hash hash{ 0 };
 };
 
+/**
+ * Key of the delegators index, an account listed under the representative it delegates its weight to
+ */
+class delegator_key final
+{
+public:
+	delegator_key () = default;
+	delegator_key (nano::account const &, nano::account const &);
+	bool operator== (nano::delegator_key const &) const;
+	nano::account const & key () const;
+	nano::account representative{ 0 };
+	nano::account account{ 0 };
+};
+
+/**
+ * Key of the account heights index, the height is serialized big endian so each account's blocks are ordered by height
+ */
+class account_height_key final
+{
+public:
+	account_height_key () = default;
+	account_height_key (nano::account const &, uint64_t);
+	void serialize (nano::stream &) const;
+	bool deserialize (nano::stream &);
+	bool operator== (nano::account_height_key const &) const;
+	nano::account account{ 0 };
+	uint64_t height{ 0 };
+};
+
 /**
  * Tag for block signature verification result
  */
@@ -192,6 +221,9 @@ public:
 	unchecked_info (std::shared_ptr<nano::block>, nano::account const &, uint64_t, nano::signature_verification = nano::signature_verification::unknown, bool = false);
 	void serialize (nano::stream &) const;
 	bool deserialize (nano::stream &);
+	/** Everything except the block, which the unchecked table stores separately */
+	void serialize_details (nano::stream &) const;
+	bool deserialize_details (nano::stream &);
 	std::shared_ptr<nano::block> block;
 	nano::account account{ 0 };
 	/** Seconds since posix epoch */
@@ -230,6 +262,20 @@ public:
 	nano::block_hash frontier;
 };
 
+/** Kept in place of the body of a block deleted by ledger pruning */
+class pruned_info final
+{
+public:
+	pruned_info () = default;
+	pruned_info (nano::account const &, uint64_t, nano::amount const &);
+	void serialize (nano::stream &) const;
+	bool deserialize (nano::stream &);
+	nano::account account{ 0 };
+	uint64_t height{ 0 };
+	/** Balance after the block, so the amount of the block above it can still be calculated */
+	nano::amount balance{ 0 };
+};
+
 /** The maximum amount of blocks to iterate over while writing */
 namespace confirmation_height
 {
@@ -418,6 +464,7 @@ public:
 	std::chrono::seconds search_pending_interval;
 	std::chrono::seconds peer_interval;
 	std::chrono::minutes unchecked_cleaning_interval;
+	std::chrono::seconds pruning_interval;
 	std::chrono::milliseconds process_confirmed_interval;
 
 	/** The maximum amount of samples for a 2 week period on live or 3 days on beta */
@@ -504,6 +551,11 @@ public:
 	std::atomic<uint64_t> block_count{ 0 };
 	std::atomic<uint64_t> unchecked_count{ 0 };
 	std::atomic<uint64_t> account_count{ 0 };
+	/** Blocks deleted by ledger pruning, these are still included in block_count */
+	std::atomic<uint64_t> pruned_count{ 0 };
+	/** Written as a checkpoint on clean shutdown so the next start can skip generating the cache */
+	void serialize (nano::stream &);
+	bool deserialize (nano::stream &);
 };
 
 nano::wallet_id random_wallet_id ();
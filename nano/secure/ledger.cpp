@@ -5,6 +5,8 @@
 #include <nano/secure/blockstore.hpp>
 #include <nano/secure/ledger.hpp>
 
+#include <boost/format.hpp>
+
 namespace
 {
 /**
@@ -256,7 +258,7 @@ void ledger_processor::state_block (nano::state_block const & block_a)
 void ledger_processor::state_block_impl (nano::state_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block before? (Unambiguous)
 	if (result.code == nano::process_result::progress)
 	{
@@ -285,7 +287,7 @@ void ledger_processor::state_block_impl (nano::state_block const & block_a)
 					result.code = block_a.hashables.previous.is_zero () ? nano::process_result::fork : nano::process_result::progress; // Has this account already been opened? (Ambigious)
 					if (result.code == nano::process_result::progress)
 					{
-						result.code = ledger.store.block_exists (transaction, block_a.hashables.previous) ? nano::process_result::progress : nano::process_result::gap_previous; // Does the previous block exist in the ledger? (Unambigious)
+						result.code = ledger.block_or_pruned_exists (transaction, block_a.hashables.previous) ? nano::process_result::progress : nano::process_result::gap_previous; // Does the previous block exist in the ledger? (Unambigious)
 						if (result.code == nano::process_result::progress)
 						{
 							is_send = block_a.hashables.balance < info.balance;
@@ -311,7 +313,7 @@ void ledger_processor::state_block_impl (nano::state_block const & block_a)
 					{
 						if (!block_a.hashables.link.is_zero ())
 						{
-							result.code = ledger.store.source_exists (transaction, block_a.hashables.link) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block already? (Harmless)
+							result.code = (ledger.store.source_exists (transaction, block_a.hashables.link) || ledger.pruned_exists (transaction, block_a.hashables.link)) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block already? (Harmless)
 							if (result.code == nano::process_result::progress)
 							{
 								nano::pending_key key (block_a.hashables.account, block_a.hashables.link);
@@ -374,7 +376,7 @@ void ledger_processor::state_block_impl (nano::state_block const & block_a)
 void ledger_processor::epoch_block_impl (nano::state_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block before? (Unambiguous)
 	if (result.code == nano::process_result::progress)
 	{
@@ -442,7 +444,7 @@ void ledger_processor::epoch_block_impl (nano::state_block const & block_a)
 void ledger_processor::change_block (nano::change_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block before? (Harmless)
 	if (result.code == nano::process_result::progress)
 	{
@@ -493,7 +495,7 @@ void ledger_processor::change_block (nano::change_block const & block_a)
 void ledger_processor::send_block (nano::send_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block before? (Harmless)
 	if (result.code == nano::process_result::progress)
 	{
@@ -549,7 +551,7 @@ void ledger_processor::send_block (nano::send_block const & block_a)
 void ledger_processor::receive_block (nano::receive_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block already?  (Harmless)
 	if (result.code == nano::process_result::progress)
 	{
@@ -573,7 +575,7 @@ void ledger_processor::receive_block (nano::receive_block const & block_a)
 					{
 						debug_assert (!validate_message (account, hash, block_a.signature));
 						result.verified = nano::signature_verification::valid;
-						result.code = ledger.store.source_exists (transaction, block_a.hashables.source) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block already? (Harmless)
+						result.code = (ledger.store.source_exists (transaction, block_a.hashables.source) || ledger.pruned_exists (transaction, block_a.hashables.source)) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block already? (Harmless)
 						if (result.code == nano::process_result::progress)
 						{
 							nano::account_info info;
@@ -623,7 +625,7 @@ void ledger_processor::receive_block (nano::receive_block const & block_a)
 void ledger_processor::open_block (nano::open_block const & block_a)
 {
 	auto hash (block_a.hash ());
-	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash));
+	auto existing (ledger.store.block_exists (transaction, block_a.type (), hash) || ledger.pruned_exists (transaction, hash));
 	result.code = existing ? nano::process_result::old : nano::process_result::progress; // Have we seen this block already? (Harmless)
 	if (result.code == nano::process_result::progress)
 	{
@@ -636,7 +638,7 @@ void ledger_processor::open_block (nano::open_block const & block_a)
 		{
 			debug_assert (!validate_message (block_a.hashables.account, hash, block_a.signature));
 			result.verified = nano::signature_verification::valid;
-			result.code = ledger.store.source_exists (transaction, block_a.hashables.source) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block? (Harmless)
+			result.code = (ledger.store.source_exists (transaction, block_a.hashables.source) || ledger.pruned_exists (transaction, block_a.hashables.source)) ? nano::process_result::progress : nano::process_result::gap_source; // Have we seen the source block? (Harmless)
 			if (result.code == nano::process_result::progress)
 			{
 				nano::account_info info;
@@ -686,45 +688,103 @@ verification (verification_a)
 }
 } // namespace
 
-nano::ledger::ledger (nano::block_store & store_a, nano::stat & stat_a, nano::generate_cache const & generate_cache_a) :
+nano::ledger::ledger (nano::block_store & store_a, nano::stat & stat_a, nano::generate_cache const & generate_cache_a, nano::logger_mt * logger_a) :
 store (store_a),
 stats (stat_a),
 check_bootstrap_weights (true)
 {
 	if (!store.init_error ())
 	{
-		auto transaction = store.tx_begin_read ();
-		if (generate_cache_a.reps || generate_cache_a.account_count)
+		auto start (std::chrono::steady_clock::now ());
+		// A checkpoint is only loaded if nothing was written since the node stopped cleanly, otherwise the cache is generated by scanning. The node deletes it once started
+		auto loaded (!store.cache_checkpoint_get (store.tx_begin_read (), cache));
+		if (!loaded)
+		{
+			cache_generate (generate_cache_a, logger_a);
+		}
+		cache_complete = loaded || (generate_cache_a.reps && generate_cache_a.account_count && generate_cache_a.cemented_count && generate_cache_a.unchecked_count);
+		if (logger_a != nullptr)
 		{
-			for (auto i (store.latest_begin (transaction)), n (store.latest_end ()); i != n; ++i)
+			logger_a->always_log (boost::str (boost::format ("%1% ledger cache for %2% accounts in %3% milliseconds") % (loaded ? "Loaded checkpointed" : "Generated") % cache.account_count % std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start).count ()));
+		}
+	}
+}
+
+void nano::ledger::cache_generate (nano::generate_cache const & generate_cache_a, nano::logger_mt * logger_a)
+{
+	auto start (std::chrono::steady_clock::now ());
+	std::mutex progress_mutex;
+	auto last_progress (start);
+	auto log_progress = [logger_a, &progress_mutex, &last_progress](std::string const & progress_a) {
+		nano::lock_guard<std::mutex> guard (progress_mutex);
+		auto now (std::chrono::steady_clock::now ());
+		if (logger_a != nullptr && now - last_progress >= std::chrono::seconds (5))
+		{
+			logger_a->always_log (progress_a);
+			last_progress = now;
+		}
+	};
+	if (generate_cache_a.reps || generate_cache_a.account_count)
+	{
+		store.latest_for_each_par ([this, &log_progress](nano::read_transaction const &, nano::store_iterator<nano::account, nano::account_info> i, nano::store_iterator<nano::account, nano::account_info> n) {
+			// Weights are summed per range and merged once, so ranges do not contend on rep_weights
+			std::unordered_map<nano::account, nano::uint128_t> rep_weights_l;
+			uint64_t account_count_l (0);
+			for (; i != n; ++i)
 			{
 				nano::account_info const & info (i->second);
-				cache.rep_weights.representation_add (info.representative, info.balance.number ());
-				++cache.account_count;
+				rep_weights_l[info.representative] += info.balance.number ();
+				++account_count_l;
 			}
-		}
+			for (auto const & rep_weight : rep_weights_l)
+			{
+				cache.rep_weights.representation_add (rep_weight.first, rep_weight.second);
+			}
+			log_progress (boost::str (boost::format ("Ledger cache: %1% accounts scanned") % (cache.account_count += account_count_l)));
+		});
+	}
 
-		if (generate_cache_a.cemented_count)
-		{
-			for (auto i (store.confirmation_height_begin (transaction)), n (store.confirmation_height_end ()); i != n; ++i)
+	if (generate_cache_a.cemented_count)
+	{
+		store.confirmation_height_for_each_par ([this, &log_progress](nano::read_transaction const &, nano::store_iterator<nano::account, nano::confirmation_height_info> i, nano::store_iterator<nano::account, nano::confirmation_height_info> n) {
+			uint64_t cemented_count_l (0);
+			for (; i != n; ++i)
 			{
-				cache.cemented_count += i->second.height;
+				cemented_count_l += i->second.height;
 			}
-		}
+			log_progress (boost::str (boost::format ("Ledger cache: %1% cemented blocks counted") % (cache.cemented_count += cemented_count_l)));
+		});
+	}
 
-		if (generate_cache_a.unchecked_count)
-		{
-			cache.unchecked_count = store.unchecked_count (transaction);
-		}
+	auto transaction = store.tx_begin_read ();
+	if (generate_cache_a.unchecked_count)
+	{
+		cache.unchecked_count = store.unchecked_count (transaction);
+	}
+
+	cache.pruned_count = store.pruned_count (transaction);
+	cache.block_count = store.block_count (transaction).sum () + cache.pruned_count;
+}
 
-		cache.block_count = store.block_count (transaction).sum ();
+void nano::ledger::cache_checkpoint (nano::write_transaction const & transaction_a)
+{
+	if (cache_complete)
+	{
+		store.cache_checkpoint_put (transaction_a, cache);
 	}
 }
 
 // Balance for account containing hash
 nano::uint128_t nano::ledger::balance (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 {
-	return hash_a.is_zero () ? 0 : store.block_balance (transaction_a, hash_a);
+	nano::uint128_t result (0);
+	if (!hash_a.is_zero ())
+	{
+		// Pruned blocks keep their balance so amounts can be calculated for the blocks above them
+		nano::pruned_info pruned;
+		result = (pruning && !store.pruned_get (transaction_a, hash_a, pruned)) ? pruned.balance.number () : store.block_balance (transaction_a, hash_a);
+	}
+	return result;
 }
 
 // Balance for an account by account number
@@ -743,8 +803,7 @@ nano::uint128_t nano::ledger::account_balance (nano::transaction const & transac
 nano::uint128_t nano::ledger::account_pending (nano::transaction const & transaction_a, nano::account const & account_a)
 {
 	nano::uint128_t result (0);
-	nano::account end (account_a.number () + 1);
-	for (auto i (store.pending_begin (transaction_a, nano::pending_key (account_a, 0))), n (store.pending_begin (transaction_a, nano::pending_key (end, 0))); i != n; ++i)
+	for (auto i (store.pending_account_begin (transaction_a, account_a)), n (store.pending_end ()); i != n && nano::pending_key (i->first).account == account_a; ++i)
 	{
 		nano::pending_info const & info (i->second);
 		result += info.amount.number ();
@@ -778,6 +837,16 @@ nano::block_hash nano::ledger::representative_calculated (nano::transaction cons
 	return visitor.result;
 }
 
+bool nano::ledger::pruned_exists (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+{
+	return pruning && store.pruned_exists (transaction_a, hash_a);
+}
+
+bool nano::ledger::block_or_pruned_exists (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
+{
+	return store.block_exists (transaction_a, hash_a) || pruned_exists (transaction_a, hash_a);
+}
+
 bool nano::ledger::block_exists (nano::block_hash const & hash_a)
 {
 	auto transaction (store.tx_begin_read ());
@@ -994,11 +1063,11 @@ public:
 	void receive_block (nano::receive_block const & block_a) override
 	{
 		result = ledger.store.block_exists (transaction, block_a.previous ());
-		result &= ledger.store.block_exists (transaction, block_a.source ());
+		result &= ledger.block_or_pruned_exists (transaction, block_a.source ());
 	}
 	void open_block (nano::open_block const & block_a) override
 	{
-		result = ledger.store.block_exists (transaction, block_a.source ());
+		result = ledger.block_or_pruned_exists (transaction, block_a.source ());
 	}
 	void change_block (nano::change_block const & block_a) override
 	{
@@ -1009,7 +1078,7 @@ public:
 		result = block_a.previous ().is_zero () || ledger.store.block_exists (transaction, block_a.previous ());
 		if (result && !ledger.is_send (transaction, block_a))
 		{
-			result &= ledger.store.block_exists (transaction, block_a.hashables.link) || block_a.hashables.link.is_zero () || ledger.is_epoch_link (block_a.hashables.link);
+			result &= ledger.block_or_pruned_exists (transaction, block_a.hashables.link) || block_a.hashables.link.is_zero () || ledger.is_epoch_link (block_a.hashables.link);
 		}
 	}
 	nano::ledger & ledger;
@@ -1054,10 +1123,46 @@ void nano::ledger::change_latest (nano::write_transaction const & transaction_a,
 			// store.account_put won't erase existing entries if they're in different tables
 			store.account_del (transaction_a, account_a);
 		}
+		if (delegators_index && (old_a.head.is_zero () || old_a.representative != new_a.representative))
+		{
+			if (!old_a.head.is_zero ())
+			{
+				store.delegator_del (transaction_a, old_a.representative, account_a);
+			}
+			store.delegator_put (transaction_a, new_a.representative, account_a);
+		}
+		if (account_heights_index)
+		{
+			// Each call adds or removes a single block at the head of the chain
+			if (new_a.block_count > old_a.block_count)
+			{
+				store.account_height_put (transaction_a, account_a, new_a.block_count, new_a.head);
+			}
+			else if (new_a.block_count < old_a.block_count)
+			{
+				store.account_height_del (transaction_a, account_a, old_a.block_count);
+			}
+		}
 		store.account_put (transaction_a, account_a, new_a);
 	}
 	else
 	{
+		if (delegators_index || account_heights_index)
+		{
+			// Rolling back an open block doesn't supply the previous account info, read the entries being removed
+			nano::account_info info;
+			auto error (store.account_get (transaction_a, account_a, info));
+			(void)error;
+			debug_assert (!error);
+			if (delegators_index)
+			{
+				store.delegator_del (transaction_a, info.representative, account_a);
+			}
+			if (account_heights_index)
+			{
+				store.account_height_del (transaction_a, account_a, info.block_count);
+			}
+		}
 		store.confirmation_height_del (transaction_a, account_a);
 		store.account_del (transaction_a, account_a);
 		debug_assert (cache.account_count > 0);
@@ -1065,6 +1170,70 @@ void nano::ledger::change_latest (nano::write_transaction const & transaction_a,
 	}
 }
 
+void nano::ledger::delegators_index_build (nano::write_transaction const & transaction_a)
+{
+	store.delegators_clear (transaction_a);
+	for (auto i (store.latest_begin (transaction_a)), n (store.latest_end ()); i != n; ++i)
+	{
+		nano::account_info const & info (i->second);
+		store.delegator_put (transaction_a, info.representative, i->first);
+	}
+}
+
+void nano::ledger::account_heights_index_build (nano::write_transaction const & transaction_a)
+{
+	store.account_heights_clear (transaction_a);
+	for (auto i (store.latest_begin (transaction_a)), n (store.latest_end ()); i != n; ++i)
+	{
+		nano::account_info const & info (i->second);
+		// Walk down from the head as the bottom of the chain may have been pruned
+		uint64_t height (info.block_count);
+		for (auto hash (info.head); !hash.is_zero (); --height)
+		{
+			auto block (store.block_get (transaction_a, hash));
+			if (block == nullptr)
+			{
+				debug_assert (pruned_exists (transaction_a, hash));
+				break;
+			}
+			store.account_height_put (transaction_a, i->first, height, hash);
+			hash = block->previous ();
+		}
+	}
+}
+
+uint64_t nano::ledger::pruning_action (nano::write_transaction & transaction_a, nano::block_hash const & hash_a, uint64_t const batch_size_a)
+{
+	uint64_t pruned_count (0);
+	nano::block_hash hash (hash_a);
+	while (!hash.is_zero () && hash != network_params.ledger.genesis_hash)
+	{
+		nano::block_sideband sideband;
+		auto block (store.block_get (transaction_a, hash, &sideband));
+		if (block != nullptr)
+		{
+			debug_assert (block_confirmed (transaction_a, hash));
+			auto account (block->account ().is_zero () ? sideband.account : block->account ());
+			store.block_del (transaction_a, hash, block->type ());
+			store.pruned_put (transaction_a, hash, { account, sideband.height, store.block_balance_calculated (block, sideband) });
+			++cache.pruned_count;
+			hash = block->previous ();
+			if (++pruned_count % batch_size_a == 0)
+			{
+				transaction_a.commit ();
+				transaction_a.renew ();
+			}
+		}
+		else
+		{
+			// Reached the blocks pruned by an earlier pass
+			debug_assert (store.pruned_exists (transaction_a, hash));
+			hash.clear ();
+		}
+	}
+	return pruned_count;
+}
+
 std::shared_ptr<nano::block> nano::ledger::successor (nano::transaction const & transaction_a, nano::qualified_root const & root_a)
 {
 	nano::block_hash successor (0);
@@ -1095,7 +1264,7 @@ std::shared_ptr<nano::block> nano::ledger::successor (nano::transaction const &
 	{
 		result = store.block_get (transaction_a, successor);
 	}
-	debug_assert (successor.is_zero () || result != nullptr);
+	debug_assert (successor.is_zero () || result != nullptr || pruned_exists (transaction_a, successor));
 	return result;
 }
 
@@ -1112,20 +1281,24 @@ std::shared_ptr<nano::block> nano::ledger::forked_block (nano::transaction const
 		(void)error;
 		debug_assert (!error);
 		result = store.block_get (transaction_a, info.open_block);
-		debug_assert (result != nullptr);
+		debug_assert (result != nullptr || pruned_exists (transaction_a, info.open_block));
 	}
 	return result;
 }
 
 bool nano::ledger::block_confirmed (nano::transaction const & transaction_a, nano::block_hash const & hash_a) const
 {
-	auto confirmed (false);
-	auto block_height (store.block_account_height (transaction_a, hash_a));
-	if (block_height > 0) // 0 indicates that the block doesn't exist
+	// Only cemented blocks are pruned
+	auto confirmed (pruned_exists (transaction_a, hash_a));
+	if (!confirmed)
 	{
-		nano::confirmation_height_info confirmation_height_info;
-		release_assert (!store.confirmation_height_get (transaction_a, account (transaction_a, hash_a), confirmation_height_info));
-		confirmed = (confirmation_height_info.height >= block_height);
+		auto block_height (store.block_account_height (transaction_a, hash_a));
+		if (block_height > 0) // 0 indicates that the block doesn't exist
+		{
+			nano::confirmation_height_info confirmation_height_info;
+			release_assert (!store.confirmation_height_get (transaction_a, account (transaction_a, hash_a), confirmation_height_info));
+			confirmed = (confirmation_height_info.height >= block_height);
+		}
 	}
 	return confirmed;
 }
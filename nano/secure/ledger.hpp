@@ -8,6 +8,7 @@
 namespace nano
 {
 class block_store;
+class logger_mt;
 class stat;
 class write_transaction;
 
@@ -15,7 +16,8 @@ using tally_t = std::map<nano::uint128_t, std::shared_ptr<nano::block>, std::gre
 class ledger final
 {
 public:
-	ledger (nano::block_store &, nano::stat &, nano::generate_cache const & = nano::generate_cache ());
+	/** The ledger cache is generated by scanning ranges of accounts in parallel, progress and timing are logged to \p logger_a if set */
+	ledger (nano::block_store &, nano::stat &, nano::generate_cache const & = nano::generate_cache (), nano::logger_mt * logger_a = nullptr);
 	nano::account account (nano::transaction const &, nano::block_hash const &) const;
 	nano::uint128_t amount (nano::transaction const &, nano::account const &);
 	nano::uint128_t amount (nano::transaction const &, nano::block_hash const &);
@@ -33,6 +35,9 @@ public:
 	nano::block_hash representative_calculated (nano::transaction const &, nano::block_hash const &);
 	bool block_exists (nano::block_hash const &);
 	bool block_exists (nano::block_type, nano::block_hash const &);
+	/** Returns true if the body of \p hash_a was deleted by pruning, always false unless pruning is enabled */
+	bool pruned_exists (nano::transaction const &, nano::block_hash const &) const;
+	bool block_or_pruned_exists (nano::transaction const &, nano::block_hash const &) const;
 	std::string block_text (char const *);
 	std::string block_text (nano::block_hash const &);
 	bool is_send (nano::transaction const &, nano::state_block const &) const;
@@ -42,11 +47,22 @@ public:
 	bool rollback (nano::write_transaction const &, nano::block_hash const &, std::vector<std::shared_ptr<nano::block>> &);
 	bool rollback (nano::write_transaction const &, nano::block_hash const &);
 	void change_latest (nano::write_transaction const &, nano::account const &, nano::account_info const &, nano::account_info const &);
+	/** Repopulates the delegators table from the accounts table */
+	void delegators_index_build (nano::write_transaction const &);
+	/** Repopulates the account_heights table by walking every account chain */
+	void account_heights_index_build (nano::write_transaction const &);
+	/**
+	 * Deletes the body of the cemented block \p hash_a and every block below it in the account chain which hasn't been pruned yet, keeping a pruned_info record of each.
+	 * The transaction is committed and renewed every \p batch_size_a blocks. Returns the number of blocks pruned
+	 */
+	uint64_t pruning_action (nano::write_transaction &, nano::block_hash const &, uint64_t const batch_size_a);
 	void dump_account_chain (nano::account const &);
 	bool could_fit (nano::transaction const &, nano::block const &);
 	bool is_epoch_link (nano::link const &);
 	nano::account const & epoch_signer (nano::link const &) const;
 	nano::link const & epoch_link (nano::epoch) const;
+	/** Stores the ledger cache so the next start can load it instead of scanning, skipped if parts of the cache were not generated */
+	void cache_checkpoint (nano::write_transaction const &);
 	static nano::uint128_t const unit;
 	nano::network_params network_params;
 	nano::block_store & store;
@@ -56,6 +72,17 @@ public:
 	std::atomic<size_t> bootstrap_weights_size{ 0 };
 	uint64_t bootstrap_weight_max_blocks{ 1 };
 	std::atomic<bool> check_bootstrap_weights;
+	/** Whether change_latest maintains the delegators table, only enabled once the index has been built */
+	bool delegators_index{ false };
+	/** Whether change_latest maintains the account_heights table, only enabled once the index has been built */
+	bool account_heights_index{ false };
+	/** Whether blocks may have been pruned, pruned blocks are then treated as existing and cemented when processing blocks */
+	bool pruning{ false };
+
+private:
+	void cache_generate (nano::generate_cache const &, nano::logger_mt *);
+	/** Whether every part of the cache was generated or loaded from a checkpoint */
+	bool cache_complete{ false };
 };
 
 std::unique_ptr<container_info_component> collect_container_info (ledger & ledger, const std::string & name);
@@ -7,6 +7,10 @@
 
 #include <gtest/gtest.h>
 
+#if NANO_ROCKSDB
+#include <nano/node/rocksdb/rocksdb.hpp>
+#endif
+
 #include <numeric>
 
 using namespace std::chrono_literals;
@@ -125,6 +129,104 @@ TEST (ledger, deep_account_compute)
 	}
 }
 
+TEST (ledger, representation_concurrent_reads)
+{
+	nano::rep_weights rep_weights;
+	std::vector<nano::account> accounts (10000);
+	for (auto & account : accounts)
+	{
+		nano::random_pool::generate_block (account.bytes.data (), account.bytes.size ());
+		rep_weights.representation_add (account, 1);
+	}
+	auto read_count (2000000);
+	for (auto thread_count : { 1, 2, 4, 8, 16 })
+	{
+		std::vector<boost::thread> threads;
+		auto start (std::chrono::steady_clock::now ());
+		for (auto i (0); i < thread_count; ++i)
+		{
+			threads.emplace_back ([&rep_weights, &accounts, read_count]() {
+				nano::uint128_t total (0);
+				for (auto j (0); j < read_count; ++j)
+				{
+					total += rep_weights.representation_get (accounts[j % accounts.size ()]);
+				}
+				ASSERT_EQ (read_count, total);
+			});
+		}
+		// Writes to some representatives keep going while reading
+		for (auto j (0); j < 1000; ++j)
+		{
+			rep_weights.representation_add (accounts[j], 0);
+		}
+		for (auto & thread : threads)
+		{
+			thread.join ();
+		}
+		auto elapsed (std::chrono::duration_cast<std::chrono::milliseconds> (std::chrono::steady_clock::now () - start));
+		std::cerr << thread_count << " threads: " << (thread_count * read_count) / std::max<int64_t> (elapsed.count (), 1) << " reads/ms" << std::endl;
+	}
+}
+
+#if NANO_ROCKSDB
+TEST (rocksdb, table_profiles)
+{
+	// Lookups of present and missing blocks, and of pending entries by account, with and without the per column family options
+	std::vector<std::shared_ptr<nano::state_block>> blocks;
+	std::vector<nano::pending_key> pending;
+	for (auto i (0); i < 100000; ++i)
+	{
+		nano::keypair key;
+		nano::block_hash previous;
+		nano::random_pool::generate_block (previous.bytes.data (), previous.bytes.size ());
+		blocks.push_back (std::make_shared<nano::state_block> (key.pub, previous, key.pub, i, key.pub, key.prv, key.pub, 0));
+		pending.emplace_back (key.pub, previous);
+	}
+	for (auto table_profiles : { false, true })
+	{
+		nano::logger_mt logger;
+		nano::rocksdb_config config;
+		config.table_profiles = table_profiles;
+		nano::rocksdb_store store (logger, nano::unique_path (), config);
+		ASSERT_FALSE (store.init_error ());
+		for (size_t i (0); i < blocks.size ();)
+		{
+			auto transaction (store.tx_begin_write ());
+			for (auto n (std::min (i + 10000, blocks.size ())); i < n; ++i)
+			{
+				auto const & block (*blocks[i]);
+				nano::block_sideband sideband (nano::block_type::state, block.account (), 0, block.balance (), 1, nano::seconds_since_epoch (), nano::epoch::epoch_0, false, false, false);
+				store.block_put (transaction, block.hash (), block, sideband);
+				store.pending_put (transaction, pending[i], nano::pending_info (block.account (), block.balance (), nano::epoch::epoch_0));
+			}
+		}
+		// Time reads against the table files rather than the memtables
+		store.compact ();
+		auto transaction (store.tx_begin_read ());
+		auto start (std::chrono::steady_clock::now ());
+		for (auto const & block : blocks)
+		{
+			ASSERT_TRUE (store.block_exists (transaction, block->hash ()));
+		}
+		auto present (std::chrono::steady_clock::now ());
+		for (auto const & block : blocks)
+		{
+			ASSERT_FALSE (store.block_exists (transaction, block->hashables.previous));
+		}
+		auto missing (std::chrono::steady_clock::now ());
+		for (auto const & key : pending)
+		{
+			auto i (store.pending_account_begin (transaction, key.account));
+			ASSERT_NE (store.pending_end (), i);
+			ASSERT_EQ (key, i->first);
+		}
+		auto by_account (std::chrono::steady_clock::now ());
+		auto elapsed = [](auto const & begin, auto const & end) { return std::chrono::duration_cast<std::chrono::milliseconds> (end - begin).count (); };
+		std::cerr << (table_profiles ? "Per column family options" : "Shared options") << ": present blocks " << elapsed (start, present) << " ms, missing blocks " << elapsed (present, missing) << " ms, pending by account " << elapsed (missing, by_account) << " ms" << std::endl;
+	}
+}
+#endif
+
 TEST (wallet, multithreaded_send_async)
 {
 	std::vector<boost::thread> threads;